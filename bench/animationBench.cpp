@@ -0,0 +1,57 @@
+/**
+ * @file animationBench.cpp
+ * @author Iván Mansilla
+ * @brief Microbenchmark of AnimationSystem::update with many animated sprites.
+ * @version 0.1
+ * @date 2025-08-03
+ *
+ * Usage: animationBench [sprites] [frames]
+ */
+#include "../inc/objects.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+int main(int argc, char* argv[]){
+    int spriteCount = argc > 1 ? atoi(argv[1]) : 10000;
+    int frames = argc > 2 ? atoi(argv[2]) : 10000;
+    if(spriteCount <= 0 || frames <= 0) {
+        printf("Usage: animationBench [sprites] [frames]\n");
+        return -1;
+    }
+
+    AnimationSystem animations;
+    // an 8 frame walk cycle, a 4 frame ping-pong blink and a coin that spins once
+    animations.defineClip("walk", "sheet", 32, 32, 8, 8, 100.0f);
+    animations.defineClip("blink", "sheet", 32, 32, 8, 4, 60.0f, ANIMATION_PING_PONG, 8);
+    animations.defineClip("spin", "sheet", 32, 32, 8, 6, 50.0f, ANIMATION_ONCE, 16);
+    animations.addEvent("walk", 3, "step");
+    unsigned long long events = 0;
+    animations.setEventHandler([&events](Object*, const std::string&){
+        events++;
+    });
+
+    const char* clips[] = {"walk", "blink", "spin"};
+    std::vector<std::unique_ptr<Object>> sprites;
+    for(int i = 0; i < spriteCount; i++) {
+        sprites.emplace_back(new Object("sprite" + std::to_string(i), 0, 0, 32, 32, "sheet"));
+        // different speeds so the frames do not all change on the same tick
+        animations.play(sprites.back().get(), clips[i % 3], 0.5f + (i % 7) * 0.25f);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < frames; i++) {
+        animations.update(16.0f);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double microseconds = std::chrono::duration<double, std::micro>(end - start).count() / frames;
+    printf("%d animated sprites, %d frames of 16 ms\n", spriteCount, frames);
+    printf("%-28s %12.3f\n", "us/update", microseconds);
+    printf("%-28s %12.3f\n", "ns/sprite", microseconds * 1000.0 / spriteCount);
+    printf("(%llu events)\n", events);
+
+    animations.clear();
+    return 0;
+}
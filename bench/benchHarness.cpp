@@ -0,0 +1,247 @@
+/**
+ * @file benchHarness.cpp
+ * @author Iván Mansilla
+ * @brief Repetitions, statistics and JSON baselines for the microbenchmarks.
+ * @version 0.1
+ * @date 2025-08-03
+ *
+ *
+ */
+#include "benchHarness.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+/**
+ * Two-sided 95% Student's t values for 1 to 30 degrees of freedom, the normal value is used above
+ */
+static const double T_95[] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+/**
+ * @brief Handles an option of the suite
+ *
+ * @param argc
+ * @param argv
+ * @param index Index of the option, moved past its value when it has one
+ * @return int 1 if it was an option of the suite, 0 if not, -1 if it is missing its value
+ */
+int BenchSuite::parseOption(int argc, char* argv[], int* index){
+    std::string arg = argv[*index];
+    bool hasValue = *index + 1 < argc;
+    if(arg != "--reps" && arg != "--warmup" && arg != "--filter" && arg != "--json" && arg != "--baseline" && arg != "--threshold") {
+        return 0;
+    }
+    if(!hasValue) {
+        fprintf(stderr, "ERROR: %s needs a value\n", arg.c_str());
+        return -1;
+    }
+    const char* value = argv[++*index];
+    if(arg == "--reps") {
+        repetitions = std::max(2, atoi(value));
+    }
+    else if(arg == "--warmup") {
+        warmup = std::max(0, atoi(value));
+    }
+    else if(arg == "--filter") {
+        filter = value;
+    }
+    else if(arg == "--json") {
+        jsonPath = value;
+    }
+    else if(arg == "--baseline") {
+        baselinePath = value;
+    }
+    else {
+        threshold = atof(value);
+    }
+    return 1;
+}
+
+/**
+ * @brief Checks if a benchmark passes the filter
+ *
+ * @param name
+ * @return true
+ * @return false
+ */
+bool BenchSuite::selected(const std::string& name) const {
+    return filter.empty() || name.find(filter) != std::string::npos;
+}
+
+/**
+ * @brief Computes and prints the statistics of a benchmark
+ *
+ * @param name
+ * @param operations
+ * @param samples Nanoseconds per operation of every repetition, sorted in place
+ */
+void BenchSuite::addResult(const std::string& name, long long operations, std::vector<double>& samples){
+    BenchResult result;
+    result.name = name;
+    result.repetitions = static_cast<int>(samples.size());
+    result.operations = operations;
+
+    double sum = 0.0;
+    for(double sample : samples) {
+        sum += sample;
+    }
+    result.mean = sum / samples.size();
+    double squares = 0.0;
+    for(double sample : samples) {
+        squares += (sample - result.mean) * (sample - result.mean);
+    }
+    size_t degrees = samples.size() - 1;
+    result.stddev = std::sqrt(squares / degrees);
+    double t = degrees <= sizeof(T_95) / sizeof(T_95[0]) ? T_95[degrees - 1] : 1.96;
+    result.ci95 = t * result.stddev / std::sqrt(static_cast<double>(samples.size()));
+
+    std::sort(samples.begin(), samples.end());
+    size_t middle = samples.size() / 2;
+    result.median = samples.size() % 2 ? samples[middle] : (samples[middle - 1] + samples[middle]) / 2.0;
+    result.min = samples.front();
+
+    if(results.empty()) {
+        printf("%-44s %12s %10s %12s %12s\n", "benchmark", "ns/op", "+-95%", "median", "min");
+    }
+    printf("%-44s %12.2f %9.1f%% %12.2f %12.2f\n", name.c_str(), result.mean,
+        result.mean > 0.0 ? result.ci95 / result.mean * 100.0 : 0.0, result.median, result.min);
+    fflush(stdout);
+    results.push_back(result);
+}
+
+/**
+ * @brief Writes the results to the JSON file
+ *
+ * @return int 0 on success, -1 if the file could not be written
+ */
+int BenchSuite::writeJson() const {
+    FILE* file = fopen(jsonPath.c_str(), "w");
+    if(!file) {
+        fprintf(stderr, "ERROR: Could not create %s\n", jsonPath.c_str());
+        return -1;
+    }
+    fprintf(file, "{\n  \"benchmarks\": [\n");
+    for(size_t i = 0; i < results.size(); i++) {
+        const BenchResult& result = results[i];
+        // the names are plain ASCII without quotes, they need no escaping
+        fprintf(file, "    {\"name\": \"%s\", \"repetitions\": %d, \"operations\": %lld, \"ns_per_op\": %.4f, "
+            "\"ci95\": %.4f, \"stddev\": %.4f, \"median\": %.4f, \"min\": %.4f}%s\n",
+            result.name.c_str(), result.repetitions, result.operations, result.mean, result.ci95, result.stddev,
+            result.median, result.min, i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    fclose(file);
+    return 0;
+}
+
+/**
+ * @brief Reads a number field of a JSON object
+ *
+ * @param object Text of the object
+ * @param field
+ * @param value Set to the number if the field is there
+ * @return true if the field was found
+ */
+static bool readNumber(const std::string& object, const char* field, double* value){
+    std::string key = std::string("\"") + field + "\"";
+    size_t at = object.find(key);
+    if(at == std::string::npos) {
+        return false;
+    }
+    at = object.find(':', at + key.size());
+    if(at == std::string::npos) {
+        return false;
+    }
+    *value = strtod(object.c_str() + at + 1, nullptr);
+    return true;
+}
+
+/**
+ * @brief Compares the results with the baseline. A benchmark regressed when it is slower by more than the
+ * threshold and the confidence intervals of both runs do not overlap, so noise alone does not fail the run
+ *
+ * @return int Number of regressions, -1 if the baseline could not be read
+ */
+int BenchSuite::compareBaseline() const {
+    std::ifstream file(baselinePath);
+    if(!file) {
+        fprintf(stderr, "ERROR: Could not open the baseline %s\n", baselinePath.c_str());
+        return -1;
+    }
+    std::stringstream content;
+    content << file.rdbuf();
+    std::string json = content.str();
+
+    // the baseline is a file written by writeJson(), one object per benchmark
+    std::map<std::string, BenchResult> baseline;
+    size_t at = 0;
+    while((at = json.find("{\"name\"", at)) != std::string::npos) {
+        size_t end = json.find('}', at);
+        if(end == std::string::npos) {
+            break;
+        }
+        std::string object = json.substr(at, end - at);
+        size_t nameStart = object.find('"', object.find(':')) + 1;
+        size_t nameEnd = object.find('"', nameStart);
+        BenchResult result;
+        result.name = object.substr(nameStart, nameEnd - nameStart);
+        if(readNumber(object, "ns_per_op", &result.mean)) {
+            readNumber(object, "ci95", &result.ci95);
+            baseline[result.name] = result;
+        }
+        at = end;
+    }
+
+    int regressions = 0;
+    printf("\n%-44s %12s %12s %9s\n", "compared with baseline", "baseline", "now", "change");
+    for(const BenchResult& result : results) {
+        auto found = baseline.find(result.name);
+        if(found == baseline.end()) {
+            printf("%-44s %12s %12.2f %9s\n", result.name.c_str(), "-", result.mean, "new");
+            continue;
+        }
+        const BenchResult& before = found->second;
+        double change = before.mean > 0.0 ? (result.mean - before.mean) / before.mean * 100.0 : 0.0;
+        const char* verdict = "";
+        if(change > threshold && result.mean - result.ci95 > before.mean + before.ci95) {
+            verdict = "  REGRESSION";
+            regressions++;
+        }
+        else if(change < -threshold && result.mean + result.ci95 < before.mean - before.ci95) {
+            verdict = "  faster";
+        }
+        printf("%-44s %12.2f %12.2f %+8.1f%%%s\n", result.name.c_str(), before.mean, result.mean, change, verdict);
+    }
+    return regressions;
+}
+
+/**
+ * @brief Writes the JSON file and compares with the baseline, if they were asked for
+ *
+ * @return int Exit code of the benchmark: 0, or 1 if something regressed or a file failed
+ */
+int BenchSuite::finish(){
+    int code = 0;
+    if(!jsonPath.empty() && writeJson() != 0) {
+        code = 1;
+    }
+    if(!baselinePath.empty()) {
+        int regressions = compareBaseline();
+        if(regressions != 0) {
+            if(regressions > 0) {
+                printf("%d benchmarks regressed more than %.1f%%\n", regressions, threshold);
+            }
+            code = 1;
+        }
+    }
+    return code;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file benchHarness.h
+ * @author Iván
+ * @brief Repetitions, statistics and JSON baselines for the microbenchmarks
+ * @version 0.1
+ * @date 2025-08-03
+ *
+ *
+ */
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+/**
+ * @struct BenchResult
+ * @brief Statistics of the repetitions of one benchmark, in nanoseconds per operation
+ */
+struct BenchResult {
+    std::string name; /*!< Name of the benchmark */
+    int repetitions = 0; /*!< Measured repetitions */
+    long long operations = 0; /*!< Operations per repetition */
+    double mean = 0.0; /*!< Mean time per operation */
+    double stddev = 0.0; /*!< Sample standard deviation between repetitions */
+    double ci95 = 0.0; /*!< Half width of the 95% confidence interval of the mean */
+    double median = 0.0; /*!< Median of the repetitions */
+    double min = 0.0; /*!< Fastest repetition */
+};
+
+/**
+ * @class BenchSuite
+ * @brief Runs benchmarks a number of times after some warmup repetitions, prints the statistics and optionally
+ * writes them to a JSON file and compares them with a baseline written by another build.
+ *
+ * Options: --reps N, --warmup N, --filter text (only benchmarks whose name contains it), --json file,
+ * --baseline file, --threshold percent (slowdown that counts as a regression, 5 by default).
+ */
+class BenchSuite {
+    private:
+        int repetitions = 20; /*!< Measured repetitions per benchmark */
+        int warmup = 3; /*!< Repetitions run before measuring */
+        std::string filter; /*!< Only benchmarks whose name contains it are run */
+        std::string jsonPath; /*!< File the results are written to */
+        std::string baselinePath; /*!< Results of another build to compare with */
+        double threshold = 5.0; /*!< Slowdown in percent that counts as a regression */
+        std::vector<BenchResult> results; /*!< Results of the benchmarks run */
+
+        void addResult(const std::string& name, long long operations, std::vector<double>& samples);
+        int writeJson() const;
+        int compareBaseline() const;
+
+    public:
+        int parseOption(int argc, char* argv[], int* index);
+        bool selected(const std::string& name) const;
+        int finish();
+
+        /**
+         * @brief Runs a benchmark. Every repetition calls setup (not timed), then body (timed), which must do
+         * the given number of operations
+         *
+         * @tparam Setup
+         * @tparam Body
+         * @param name
+         * @param operations Operations done by one call of body
+         * @param setup
+         * @param body
+         */
+        template <typename Setup, typename Body>
+        void run(const std::string& name, long long operations, Setup setup, Body body) {
+            if(!selected(name) || operations <= 0) {
+                return;
+            }
+            std::vector<double> samples;
+            for(int i = 0; i < warmup + repetitions; i++) {
+                setup();
+                auto start = std::chrono::steady_clock::now();
+                body();
+                auto end = std::chrono::steady_clock::now();
+                if(i >= warmup) {
+                    samples.push_back(std::chrono::duration<double, std::nano>(end - start).count() / operations);
+                }
+            }
+            addResult(name, operations, samples);
+        }
+
+        /**
+         * @brief Runs a benchmark without setup
+         *
+         * @tparam Body
+         * @param name
+         * @param operations
+         * @param body
+         */
+        template <typename Body>
+        void run(const std::string& name, long long operations, Body body) {
+            run(name, operations, []{}, body);
+        }
+};
+
+#endif
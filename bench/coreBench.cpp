@@ -0,0 +1,304 @@
+/**
+ * @file coreBench.cpp
+ * @author Iván Mansilla
+ * @brief Microbenchmarks of the building blocks of a frame: ObjectManager, Store, TextureManager, Text and TimingWheel.
+ * @version 0.1
+ * @date 2025-08-03
+ *
+ * Headless: drawing goes through the SDL software renderer into a surface.
+ *
+ * Usage: coreBench [--objects N] [--catalog N] [--reps N] [--warmup N] [--filter text]
+ *                  [--json file] [--baseline file] [--threshold percent]
+ *
+ * "--json" writes the results, a later build compares with them through "--baseline" and exits with 1 when
+ * some benchmark got slower than the threshold beyond the noise of both runs.
+ */
+#include "benchHarness.h"
+#include "../inc/store.h"
+#include "../inc/text.h"
+#include "../inc/frameArena.h"
+#include "../inc/sdlRenderBackend.h"
+#include "../inc/timingWheel.h"
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+#define BENCH_CLICKS 10000 /*!< Clicks per repetition of the hit-testing benchmark */
+#define BENCH_REFRESHES 100 /*!< Store refreshes per repetition */
+#define BENCH_STORE_UPDATES 10000 /*!< updateStore calls per repetition */
+#define BENCH_SCROLL_FRAMES 1000 /*!< Frames of store scrolling per repetition */
+#define BENCH_TEXTURES 256 /*!< Textures known by the texture manager */
+#define BENCH_DRAWS 10000 /*!< Texture draws per repetition */
+#define BENCH_TEXTS 1000 /*!< setContent calls per repetition */
+#define BENCH_TEXTURE_SIZE 16 /*!< Size of the textures drawn */
+#define BENCH_TIMERS 100000 /*!< Timers waiting in the wheel */
+#define BENCH_TIMER_FRAMES 1000 /*!< Wheel updates per repetition */
+#define BENCH_TIMER_FRAME_MS 16 /*!< Game time of a frame */
+
+/**
+ * @brief IDs "prefix0", "prefix1"... built before measuring, so the benchmarks do not time the string formatting
+ *
+ * @param prefix
+ * @param count
+ * @return std::vector<std::string>
+ */
+static std::vector<std::string> makeIds(const char* prefix, int count){
+    std::vector<std::string> ids;
+    for(int i = 0; i < count; i++) {
+        ids.push_back(prefix + std::to_string(i));
+    }
+    return ids;
+}
+
+/**
+ * @brief Adding, activating, deactivating and clicking objects
+ *
+ * @param suite
+ * @param count Number of objects
+ */
+static void benchObjects(BenchSuite& suite, int count){
+    std::vector<std::string> ids = makeIds("object", count);
+    std::string suffix = " (" + std::to_string(count) + " objects)";
+
+    ObjectManager adds;
+    suite.run("objects/addObject" + suffix, count, [&]{
+        adds.destroyAllObjects();
+        adds.damagedRects.clear();
+    }, [&]{
+        for(int i = 0; i < count; i++) {
+            adds.addObject(new Object(ids[i], 0, 0, BENCH_TEXTURE_SIZE, BENCH_TEXTURE_SIZE, "texture0"));
+        }
+    });
+    adds.destroyAllObjects();
+
+    ObjectManager toggles;
+    for(int i = 0; i < count; i++) {
+        toggles.addObject(new Object(ids[i], 0, 0, BENCH_TEXTURE_SIZE, BENCH_TEXTURE_SIZE, "texture0"));
+    }
+    suite.run("objects/activate+deactivate" + suffix, 2LL * count, [&]{
+        for(int i = 0; i < count; i++) {
+            toggles.activateObject(ids[i]);
+        }
+        for(int i = 0; i < count; i++) {
+            toggles.deactivateObject(ids[i]);
+        }
+    });
+    toggles.destroyAllObjects();
+
+    // clickable objects in a grid over the screen, overlapping when there are more than fit
+    ObjectManager clicks;
+    int columns = SCREEN_WIDTH / BENCH_TEXTURE_SIZE;
+    int rows = SCREEN_HEIGHT / BENCH_TEXTURE_SIZE;
+    for(int i = 0; i < count; i++) {
+        int cell = i % (columns * rows);
+        clicks.addObject(new Object(ids[i], (cell % columns) * BENCH_TEXTURE_SIZE, (cell / columns) * BENCH_TEXTURE_SIZE,
+            BENCH_TEXTURE_SIZE, BENCH_TEXTURE_SIZE, "texture0", true));
+        clicks.activateObject(ids[i]);
+    }
+    clicks.updateTransforms();
+    SDL_Event click = {};
+    click.type = SDL_MOUSEBUTTONDOWN;
+    suite.run("objects/handleMouseClick" + suffix, BENCH_CLICKS, [&]{
+        unsigned int seed = 12345;
+        for(int i = 0; i < BENCH_CLICKS; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            click.button.x = static_cast<int>((seed >> 8) % SCREEN_WIDTH);
+            click.button.y = static_cast<int>((seed >> 20) % SCREEN_HEIGHT);
+            clicks.handleMouseClick(click);
+        }
+    });
+    clicks.destroyAllObjects();
+}
+
+/**
+ * @brief Refreshing, updating and scrolling a store with a big catalog
+ *
+ * @param suite
+ * @param catalog Number of items
+ */
+static void benchStore(BenchSuite& suite, int catalog){
+    std::string suffix = " (" + std::to_string(catalog) + " items)";
+    ObjectManager objectManager;
+    Player player;
+    Store* store = new Store(310, 10, 300, 400, "store", &objectManager);
+    ItemEffect plusOne;
+    plusOne.amount = 1.0;
+    std::vector<std::string> ids = makeIds("item", catalog);
+    for(int i = 0; i < catalog; i++) {
+        new Item(ids[i], "texture0", 100, "", plusOne, 0.5f, store, &player);
+    }
+    store->setSeed(1);
+
+    suite.run("store/randomizeAvailableItems" + suffix, BENCH_REFRESHES, [&]{
+        for(int i = 0; i < BENCH_REFRESHES; i++) {
+            store->randomizeAvailableItems();
+            objectManager.applyCommands();
+            frameArena().reset();
+        }
+    });
+
+    // every update flips the affordability of the available items, so they are re-tinted
+    suite.run("store/updateStore" + suffix, BENCH_STORE_UPDATES, [&]{
+        for(int i = 0; i < BENCH_STORE_UPDATES; i++) {
+            player.addPoints(i % 2 ? 1000 : -1000);
+            store->updateStore(&player);
+        }
+    });
+
+    // the whole catalog listed and scrolled back and forth, a frame binds only the rows in view
+    store->offerCount = 0;
+    store->randomizeAvailableItems();
+    suite.run("store/scroll frame" + suffix, BENCH_SCROLL_FRAMES, [&]{
+        for(int i = 0; i < BENCH_SCROLL_FRAMES; i++) {
+            if(i % 60 == 0) {
+                store->scroll(i % 120 ? -20 * STORE_SCROLL_STEP : 20 * STORE_SCROLL_STEP);
+            }
+            store->updateScroll();
+            store->updateStore(&player);
+            objectManager.updateTransforms();
+        }
+    });
+    objectManager.destroyAllObjects();
+}
+
+/**
+ * @brief Drawing textures by ID, mostly the lookup: the textures are small and drawn at their own size
+ *
+ * @param suite
+ * @param backend
+ */
+static void benchTextures(BenchSuite& suite, RenderBackend* backend){
+    TextureManager textureManager(backend);
+    std::vector<std::string> ids = makeIds("texture", BENCH_TEXTURES);
+    for(const std::string& id : ids) {
+        RenderTexture* texture = backend->createTexture(BENCH_TEXTURE_SIZE, BENCH_TEXTURE_SIZE, false);
+        if(!texture || textureManager.addTexture(id, texture) != 0) {
+            SDL_Log("ERROR: Could not create the benchmark textures.\n");
+            textureManager.clearAllTextures();
+            return;
+        }
+    }
+
+    suite.run("texture/drawTexture (" + std::to_string(BENCH_TEXTURES) + " textures)", BENCH_DRAWS, [&]{
+        for(int i = 0; i < BENCH_DRAWS; i++) {
+            textureManager.drawTexture(ids[(i * 7) % BENCH_TEXTURES], static_cast<float>(i % 600), static_cast<float>(i % 440),
+                BENCH_TEXTURE_SIZE, BENCH_TEXTURE_SIZE);
+        }
+    });
+    textureManager.clearAllTextures();
+}
+
+/**
+ * @brief Changing the content of a text, which lays it out and renders its texture again
+ *
+ * @param suite
+ * @param backend
+ */
+static void benchText(BenchSuite& suite, RenderBackend* backend){
+    TextureManager fonts(backend);
+    fonts.loadAllFonts(FONT_PATH);
+    TTF_Font** font = fonts.getFont(DEFAULT_FONT);
+    if(!font || !*font) {
+        SDL_Log("ERROR: No font in %s, the text benchmark is skipped.\n", FONT_PATH);
+        return;
+    }
+
+    ObjectManager objectManager;
+    Text* text = new Text("points", 10, 10, 200, 24, "", font, {255, 255, 255, 255}, &objectManager);
+    std::vector<std::string> contents = makeIds("Points: ", 64);
+    suite.run("text/setContent", BENCH_TEXTS, [&]{
+        for(int i = 0; i < BENCH_TEXTS; i++) {
+            text->setContent(contents[i % contents.size()], backend);
+        }
+    });
+    objectManager.destroyAllObjects();
+    fonts.clearAllFonts();
+}
+
+/**
+ * @brief Adding and cancelling timers, and updating a wheel full of timers that are not due
+ *
+ * @param suite
+ */
+static void benchTimers(BenchSuite& suite){
+    std::string suffix = " (" + std::to_string(BENCH_TIMERS) + " timers)";
+    TimingWheel wheel;
+    std::vector<TimerId> ids(BENCH_TIMERS);
+    suite.run("timers/add+cancel" + suffix, 2LL * BENCH_TIMERS, [&]{
+        for(int i = 0; i < BENCH_TIMERS; i++) {
+            ids[i] = wheel.addEvent(static_cast<Uint32>(i) * 37, 1, TimerTarget());
+        }
+        for(int i = 0; i < BENCH_TIMERS; i++) {
+            wheel.cancel(ids[i]);
+        }
+    });
+
+    // the timers are due far after the frames measured, an update should not depend on how many there are
+    for(int i = 0; i < BENCH_TIMERS; i++) {
+        wheel.addEvent(3600000 + static_cast<Uint32>(i) * 37, 1, TimerTarget());
+    }
+    Uint32 now = 0;
+    suite.run("timers/idle update" + suffix, BENCH_TIMER_FRAMES, [&]{
+        for(int i = 0; i < BENCH_TIMER_FRAMES; i++) {
+            now += BENCH_TIMER_FRAME_MS;
+            wheel.update(now);
+        }
+    });
+    wheel.clear();
+}
+
+int main(int argc, char* argv[]){
+    BenchSuite suite;
+    int objects = 2000;
+    int catalog = 1000;
+    for(int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        int used = suite.parseOption(argc, argv, &i);
+        if(used == 1) {
+            continue;
+        }
+        if(used == 0 && arg == "--objects" && i + 1 < argc) {
+            objects = atoi(argv[++i]);
+        }
+        else if(used == 0 && arg == "--catalog" && i + 1 < argc) {
+            catalog = atoi(argv[++i]);
+        }
+        else {
+            fprintf(stderr, "Usage: %s [--objects N] [--catalog N] [--reps N] [--warmup N] [--filter text] "
+                "[--json file] [--baseline file] [--threshold percent]\n", argv[0]);
+            return 1;
+        }
+    }
+    if(objects <= 0 || catalog <= 0) {
+        fprintf(stderr, "ERROR: --objects and --catalog must be positive\n");
+        return 1;
+    }
+
+    // the managers and the store log every object and item they add
+    SDL_LogSetAllPriority(SDL_LOG_PRIORITY_WARN);
+    if(TTF_Init() < 0) {
+        SDL_Log("ERROR: Could not initialize SDL_ttf. %s\n", TTF_GetError());
+        return 1;
+    }
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, SCREEN_WIDTH, SCREEN_HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = surface ? SDL_CreateSoftwareRenderer(surface) : NULL;
+    if(!renderer) {
+        SDL_Log("ERROR: Could not create the software renderer. %s\n", SDL_GetError());
+        return 1;
+    }
+
+    {
+        SdlRenderBackend backend(renderer);
+        benchObjects(suite, objects);
+        benchStore(suite, catalog);
+        benchTextures(suite, &backend);
+        benchText(suite, &backend);
+    }
+    benchTimers(suite);
+    int code = suite.finish();
+
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(surface);
+    TTF_Quit();
+    return code;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file numberFormatBench.cpp
+ * @author Iván Mansilla
+ * @brief Microbenchmark of label formatting: std::to_string + concatenation against formatLabel.
+ * @version 0.1
+ * @date 2025-07-24
+ *
+ * Usage: numberFormatBench [iterations]
+ */
+#include "../inc/numberFormat.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+static unsigned long long allocations = 0; /*!< Heap allocations done through operator new */
+
+void* operator new(size_t size){
+    allocations++;
+    void* ptr = malloc(size ? size : 1);
+    if(!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    free(ptr);
+}
+
+/**
+ * @brief Result of one benchmark run
+ */
+struct BenchResult {
+    double nanosecondsPerCall; /*!< Average time per label */
+    double allocationsPerCall; /*!< Average heap allocations per label */
+    size_t checksum; /*!< Keeps the compiler from removing the work */
+};
+
+/**
+ * @brief Runs a label formatting function over a range of values
+ *
+ * @tparam Function
+ * @param iterations
+ * @param format
+ * @return BenchResult
+ */
+template <typename Function>
+static BenchResult run(long long iterations, Function format){
+    size_t checksum = 0;
+    unsigned long long allocationsBefore = allocations;
+    auto start = std::chrono::steady_clock::now();
+    for(long long i = 0; i < iterations; i++) {
+        // spread the values over several orders of magnitude
+        long long value = (i * 2654435761LL) % 100000000LL;
+        checksum += format(value);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    BenchResult result;
+    result.nanosecondsPerCall = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    result.allocationsPerCall = static_cast<double>(allocations - allocationsBefore) / iterations;
+    result.checksum = checksum;
+    return result;
+}
+
+int main(int argc, char* argv[]){
+    long long iterations = argc > 1 ? atoll(argv[1]) : 5000000;
+
+    // the label as main.cpp used to build it
+    BenchResult toString = run(iterations, [](long long value){
+        std::string label = "Points: " + std::to_string(value);
+        return label.size();
+    });
+
+    NumberFormat plain;
+    plain.notation = Notation::Plain;
+    BenchResult formatPlain = run(iterations, [&plain](long long value){
+        char buffer[NUMBER_BUFFER_SIZE + 16];
+        return formatLabel(buffer, sizeof(buffer), "Points: ", value, plain);
+    });
+
+    NumberFormat suffix;
+    BenchResult formatSuffix = run(iterations, [&suffix](long long value){
+        char buffer[NUMBER_BUFFER_SIZE + 16];
+        return formatLabel(buffer, sizeof(buffer), "Points: ", value, suffix);
+    });
+
+    NumberFormat scientific;
+    scientific.notation = Notation::Scientific;
+    BenchResult formatScientific = run(iterations, [&scientific](long long value){
+        char buffer[NUMBER_BUFFER_SIZE + 16];
+        return formatLabel(buffer, sizeof(buffer), "Points: ", value, scientific);
+    });
+
+    printf("%-28s %12s %14s\n", "label formatting", "ns/label", "allocs/label");
+    printf("%-28s %12.2f %14.2f\n", "std::to_string + concat", toString.nanosecondsPerCall, toString.allocationsPerCall);
+    printf("%-28s %12.2f %14.2f\n", "formatLabel plain", formatPlain.nanosecondsPerCall, formatPlain.allocationsPerCall);
+    printf("%-28s %12.2f %14.2f\n", "formatLabel suffix", formatSuffix.nanosecondsPerCall, formatSuffix.allocationsPerCall);
+    printf("%-28s %12.2f %14.2f\n", "formatLabel scientific", formatScientific.nanosecondsPerCall, formatScientific.allocationsPerCall);
+    printf("(checksum %zu)\n", toString.checksum + formatPlain.checksum + formatSuffix.checksum + formatScientific.checksum);
+    return 0;
+}
@@ -0,0 +1,151 @@
+/**
+ * @file renderBench.cpp
+ * @author Iván Mansilla
+ * @brief Headless benchmark of the render backends: SDL software renderer against the CPU rasterizer.
+ * @version 0.1
+ * @date 2025-08-03
+ *
+ * Draws the same scene (a background and many alpha blended sprites, half of them scaled) through both
+ * backends into an offscreen framebuffer at twice the logical resolution, like a high-DPI window.
+ *
+ * Usage: renderBench [frames] [sprites] [threads]
+ */
+#include "../inc/sdlRenderBackend.h"
+#include "../inc/cpuRenderBackend.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#define BENCH_SPRITE_SIZE 48
+
+/**
+ * @brief Creates a sprite with soft edges, so every pixel of it needs blending
+ *
+ * @param backend
+ * @return RenderTexture*
+ */
+static RenderTexture* createSprite(RenderBackend* backend){
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, BENCH_SPRITE_SIZE, BENCH_SPRITE_SIZE, 32, SDL_PIXELFORMAT_ARGB8888);
+    if(!surface) {
+        SDL_Log("ERROR: Could not create the sprite surface. %s\n", SDL_GetError());
+        return nullptr;
+    }
+    int half = BENCH_SPRITE_SIZE / 2;
+    for(int y = 0; y < BENCH_SPRITE_SIZE; y++) {
+        Uint32* row = reinterpret_cast<Uint32*>(static_cast<Uint8*>(surface->pixels) + y * surface->pitch);
+        for(int x = 0; x < BENCH_SPRITE_SIZE; x++) {
+            int distance = (x - half) * (x - half) + (y - half) * (y - half);
+            Uint32 alpha = distance >= half * half ? 0 : 255 - 255 * distance / (half * half);
+            row[x] = (alpha << 24) | (static_cast<Uint32>(x * 5) << 16) | (static_cast<Uint32>(y * 5) << 8) | 0x80;
+        }
+    }
+    RenderTexture* texture = backend->createTextureFromSurface(surface);
+    SDL_FreeSurface(surface);
+    return texture;
+}
+
+/**
+ * @brief Draws one frame of the scene
+ *
+ * @param backend
+ * @param sprite
+ * @param frame Moves the sprites between frames
+ * @param sprites Number of sprites
+ */
+static void drawScene(RenderBackend* backend, RenderTexture* sprite, int frame, int sprites){
+    backend->clear({30, 30, 40, 255});
+    backend->fillRect(nullptr, {60, 70, 90, 255});
+    for(int i = 0; i < sprites; i++) {
+        // spread the sprites over the screen with a cheap hash, half of them drawn bigger than the texture
+        int x = static_cast<int>((i * 2654435761u + frame * 7u) % (SCREEN_WIDTH - BENCH_SPRITE_SIZE));
+        int y = static_cast<int>((i * 40503u + frame * 3u) % (SCREEN_HEIGHT - BENCH_SPRITE_SIZE));
+        int size = i % 2 ? BENCH_SPRITE_SIZE * 3 / 2 : BENCH_SPRITE_SIZE;
+        SDL_Rect dst = {x, y, size, size};
+        backend->copy(sprite, nullptr, &dst);
+    }
+    backend->present();
+}
+
+/**
+ * @brief Draws the scene a number of times
+ *
+ * @param backend
+ * @param frames
+ * @param sprites
+ * @return double Milliseconds per frame
+ */
+static double run(RenderBackend* backend, int frames, int sprites){
+    RenderTexture* sprite = createSprite(backend);
+    if(!sprite) {
+        return 0.0;
+    }
+    backend->setTextureFilter(sprite, RENDER_FILTER_LINEAR);
+
+    // one frame to warm up caches and the thread pool
+    drawScene(backend, sprite, 0, sprites);
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 1; i <= frames; i++) {
+        drawScene(backend, sprite, i, sprites);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    backend->destroyTexture(sprite);
+    return std::chrono::duration<double, std::milli>(end - start).count() / frames;
+}
+
+int main(int argc, char* argv[]){
+    int frames = argc > 1 ? atoi(argv[1]) : 200;
+    int sprites = argc > 2 ? atoi(argv[2]) : 2000;
+    size_t threads = argc > 3 ? static_cast<size_t>(atoi(argv[3])) : 0;
+    if(frames <= 0 || sprites <= 0) {
+        printf("Usage: renderBench [frames] [sprites] [threads]\n");
+        return -1;
+    }
+    int width = SCREEN_WIDTH * 2;
+    int height = SCREEN_HEIGHT * 2;
+
+    // stock SDL path: software renderer drawing into a surface
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = surface ? SDL_CreateSoftwareRenderer(surface) : NULL;
+    if(!renderer) {
+        SDL_Log("ERROR: Could not create the software renderer. %s\n", SDL_GetError());
+        return -1;
+    }
+    SDL_RenderSetLogicalSize(renderer, SCREEN_WIDTH, SCREEN_HEIGHT);
+    double sdlTime;
+    {
+        SdlRenderBackend backend(renderer);
+        sdlTime = run(&backend, frames, sprites);
+    }
+
+    CpuRenderBackend cpu(nullptr, width, height, SCREEN_WIDTH, SCREEN_HEIGHT, threads);
+    double cpuTime = run(&cpu, frames, sprites);
+
+    // both backends drew the same last frame, they should only differ by rounding
+    int maxDifference = 0;
+    const CpuTexture& screen = cpu.getScreen();
+    for(int y = 0; y < height; y++) {
+        const Uint32* row = reinterpret_cast<const Uint32*>(static_cast<Uint8*>(surface->pixels) + y * surface->pitch);
+        for(int x = 0; x < width; x++) {
+            Uint32 a = row[x];
+            Uint32 b = screen.pixels[static_cast<size_t>(y) * width + x];
+            for(int shift = 0; shift < 24; shift += 8) {
+                int difference = abs(static_cast<int>((a >> shift) & 0xFF) - static_cast<int>((b >> shift) & 0xFF));
+                if(difference > maxDifference) {
+                    maxDifference = difference;
+                }
+            }
+        }
+    }
+
+    printf("%dx%d, %d sprites, %d frames\n", width, height, sprites, frames);
+    printf("%-28s %12s\n", "backend", "ms/frame");
+    printf("%-28s %12.3f\n", "sdl software", sdlTime);
+    printf("%-28s %12.3f\n", "cpu rasterizer", cpuTime);
+    printf("speedup %.2fx, max channel difference %d\n", cpuTime > 0.0 ? sdlTime / cpuTime : 0.0, maxDifference);
+    cpu.logStats();
+
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(surface);
+    return 0;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file allocTracker.h
+ * @author Iván
+ * @brief Heap allocation accounting per frame and per subsystem
+ * @version 0.1
+ * @date 2025-07-26
+ *
+ * Only active in builds with TRACK_ALLOCATIONS defined (make TRACK_ALLOCS=1), which replace the global
+ * operator new/delete to count allocations. Otherwise everything here compiles to nothing.
+ */
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+#include <cstddef>
+
+/**
+ * @brief Parts of the game allocations are attributed to
+ */
+enum AllocSubsystem {
+    ALLOC_OTHER, /*!< Anything outside a scope */
+    ALLOC_INPUT, /*!< Event handling and click handlers */
+    ALLOC_STORE, /*!< Store updates */
+    ALLOC_TEXT, /*!< Text updates */
+    ALLOC_RENDER, /*!< Drawing */
+    ALLOC_SUBSYSTEM_COUNT
+};
+
+/**
+ * @struct AllocCounters
+ * @brief Heap allocations and bytes
+ */
+struct AllocCounters {
+    unsigned long long allocations = 0; /*!< Number of allocations */
+    unsigned long long bytes = 0; /*!< Bytes allocated */
+};
+
+#ifdef TRACK_ALLOCATIONS
+
+/**
+ * @class AllocScope
+ * @brief Attributes the allocations of the calling thread to a subsystem while it lives
+ */
+class AllocScope {
+    private:
+        AllocSubsystem previous; /*!< Subsystem of the enclosing scope */
+    public:
+        AllocScope(AllocSubsystem subsystem);
+        ~AllocScope();
+};
+
+void allocTrackerEndFrame();
+AllocCounters getFrameAllocations(AllocSubsystem subsystem);
+void logAllocationReport();
+
+#else
+
+class AllocScope {
+    public:
+        AllocScope(AllocSubsystem) {}
+};
+
+inline void allocTrackerEndFrame() {}
+inline AllocCounters getFrameAllocations(AllocSubsystem) { return AllocCounters(); }
+inline void logAllocationReport() {}
+
+#endif
+
+#endif
@@ -0,0 +1,130 @@
+/**
+ * @file animation.h
+ * @author Iván
+ * @brief Sprite-sheet frame animations
+ * @version 0.1
+ * @date 2025-08-03
+ *
+ *
+ */
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include "config.h"
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+class Object;
+
+/**
+ * Name of the event fired when an animation that does not loop reaches its end
+ */
+#define ANIMATION_EVENT_END "end"
+
+/**
+ * @brief What an animation does after its last frame
+ */
+enum AnimationLoop {
+    ANIMATION_LOOP, /*!< Starts again from the first frame */
+    ANIMATION_ONCE, /*!< Stays on the last frame */
+    ANIMATION_PING_PONG /*!< Plays backwards to the first frame, then forwards again */
+};
+
+/**
+ * @struct AnimationClip
+ * @brief Frames of a sprite sheet played in sequence
+ */
+struct AnimationClip {
+    std::string id; /*!< ID of the clip */
+    std::string textureId; /*!< Sprite sheet */
+    std::vector<SDL_Rect> frames; /*!< Area of the sheet of every frame */
+    std::vector<float> durations; /*!< Milliseconds every frame is shown */
+    std::vector<std::vector<std::string>> events; /*!< Events fired when every frame is shown */
+    AnimationLoop loop = ANIMATION_LOOP; /*!< What happens after the last frame */
+
+    std::vector<int> steps; /*!< Frames in the order they are shown, ping-pong clips go back and forth */
+    std::vector<float> stepEnds; /*!< Time (from the start of the clip) every step ends */
+    float duration = 0.0f; /*!< Milliseconds of all the steps */
+};
+
+/**
+ * @class AnimationSystem
+ * @brief Plays clips on objects. The state of the playing animations is kept in parallel arrays, one entry per
+ * object, so advancing all of them is one pass over their clocks; only the animations whose frame ends this
+ * tick do more than an add and a compare.
+ *
+ * The object shows its clip through its textureId (the sheet) and frameClip (the current frame). Objects must be
+ * stopped (ObjectManager::destroyObject does it) before they are deleted.
+ *
+ * The events of the frames shown by update() are fired after every animation was advanced, so the handler may play,
+ * stop and destroy objects. Events of an object stopped by an earlier handler of the same update are dropped.
+ */
+class AnimationSystem {
+    private:
+        /**
+         * @brief Events of a frame shown by an update, fired once the update has advanced every animation
+         */
+        struct PendingEvent {
+            Object* owner; /*!< Object of the animation */
+            size_t index; /*!< Animation when the frame was shown */
+            int clip; /*!< Clip of the frame */
+            int frame; /*!< Frame of the clip, -1 for ANIMATION_EVENT_END */
+        };
+
+        std::vector<AnimationClip> clips; /*!< Defined clips, indexed by clip number */
+        std::map<std::string, int> clipIds; /*!< Clip number by ID */
+
+        std::vector<float> times; /*!< Time since the start of the clip, per animation */
+        std::vector<float> speeds; /*!< Playback speed, 0 when paused or finished */
+        std::vector<float> stepEnds; /*!< Time the current step ends, per animation */
+        std::vector<int> steps; /*!< Current step, per animation */
+        std::vector<int> clipIndices; /*!< Clip, per animation */
+        std::vector<Object*> owners; /*!< Object showing the animation */
+
+        std::function<void(Object*, const std::string&)> eventHandler; /*!< Called for every event of the played frames */
+        std::vector<PendingEvent> pendingEvents; /*!< Events of the frames shown by the current update */
+        std::vector<PendingEvent> firingEvents; /*!< Events being fired, swapped with pendingEvents */
+        bool updating = false; /*!< Whether update() is advancing the animations, events wait until it is done */
+
+        void rebuildSteps(AnimationClip& clip);
+        void showStep(size_t index, int step);
+        void advance(size_t index);
+        void remove(size_t index);
+        void fireEvents(Object* owner, int clip, int frame);
+        void firePendingEvents();
+
+    public:
+        int defineClip(const std::string& id, const std::string& textureId, int frameWidth, int frameHeight, int columns,
+            int frameCount, float frameDuration, AnimationLoop loop = ANIMATION_LOOP, int firstFrame = 0);
+        int setFrameDurations(const std::string& id, const std::vector<float>& durations);
+        int addEvent(const std::string& id, int frame, const std::string& name);
+        const AnimationClip* getClip(const std::string& id) const;
+
+        int play(Object* object, const std::string& clipId, float speed = 1.0f);
+        void stop(Object* object);
+        void setSpeed(Object* object, float speed);
+        void clear();
+        void update(float deltaMilliseconds);
+
+        /**
+         * @brief Sets the function called with the object and the name of every event of the frames shown
+         *
+         * @param handler
+         */
+        void setEventHandler(std::function<void(Object*, const std::string&)> handler) {
+            eventHandler = handler;
+        }
+
+        /**
+         * @brief Number of playing animations
+         *
+         * @return size_t
+         */
+        size_t getCount() const {
+            return times.size();
+        }
+};
+
+#endif
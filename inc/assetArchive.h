@@ -0,0 +1,134 @@
+/**
+ * @file assetArchive.h
+ * @author Iván
+ * @brief Packed asset archive, memory-mapped at load time
+ * @version 0.1
+ * @date 2025-07-22
+ *
+ *
+ */
+#ifndef ASSET_ARCHIVE_H
+#define ASSET_ARCHIVE_H
+
+#include "config.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * Layout of an archive (all values little endian):
+ *
+ *  ArchiveHeader
+ *  ArchiveEntry[entryCount]
+ *  data of every entry, aligned to ARCHIVE_ALIGNMENT
+ *
+ * Images are stored already decoded in the pixel format given by the entry, so they can be uploaded
+ * straight from the mapped file. Fonts are stored as the original file.
+ */
+#define ARCHIVE_MAGIC "CLKPAK1"
+#define ARCHIVE_VERSION 1
+#define ARCHIVE_ALIGNMENT 64
+#define ARCHIVE_NAME_LENGTH 64
+
+/**
+ * @brief Type of an asset stored in the archive
+ */
+enum ArchiveEntryType : uint32_t {
+    ARCHIVE_IMAGE = 1, /*!< Decoded pixels */
+    ARCHIVE_FONT = 2 /*!< Font file */
+};
+
+/**
+ * @brief Compression of the data of an entry
+ */
+enum ArchiveCompression : uint32_t {
+    ARCHIVE_RAW = 0, /*!< Stored as is */
+    ARCHIVE_LZ4 = 1 /*!< LZ4 block (needs a build with USE_LZ4) */
+};
+
+/**
+ * @struct ArchiveHeader
+ * @brief Header at the start of the archive
+ */
+struct ArchiveHeader {
+    char magic[8]; /*!< ARCHIVE_MAGIC */
+    uint32_t version; /*!< ARCHIVE_VERSION */
+    uint32_t entryCount; /*!< Number of entries in the index */
+};
+
+/**
+ * @struct ArchiveEntry
+ * @brief Index entry describing one asset
+ */
+struct ArchiveEntry {
+    char name[ARCHIVE_NAME_LENGTH]; /*!< ID of the asset (file name without extension) */
+    uint32_t type; /*!< ArchiveEntryType */
+    uint32_t compression; /*!< ArchiveCompression */
+    uint32_t format; /*!< SDL pixel format of images */
+    uint32_t width; /*!< Width of images */
+    uint32_t height; /*!< Height of images */
+    uint32_t pitch; /*!< Bytes per row of images */
+    uint64_t offset; /*!< Offset of the data from the start of the archive */
+    uint64_t storedSize; /*!< Size of the data in the archive */
+    uint64_t rawSize; /*!< Size of the data once decompressed */
+};
+
+/**
+ * @class AssetArchive
+ * @brief Read-only view of an archive mapped in memory
+ */
+class AssetArchive {
+
+    private:
+        const uint8_t* mapping = nullptr; /*!< Start of the mapped file */
+        size_t mappingSize = 0; /*!< Size of the mapped file */
+        const ArchiveEntry* entries = nullptr; /*!< Index of the archive */
+        uint32_t entryCount = 0; /*!< Number of entries */
+        std::vector<uint8_t> scratch; /*!< Buffer for decompressed entries */
+#ifdef _WIN32
+        void* fileHandle = nullptr; /*!< Handle of the archive file */
+        void* mappingHandle = nullptr; /*!< Handle of the file mapping */
+#endif
+
+    public:
+        AssetArchive() = default;
+        ~AssetArchive();
+        AssetArchive(const AssetArchive&) = delete;
+        AssetArchive& operator=(const AssetArchive&) = delete;
+
+        int open(const std::string& path);
+        void close();
+
+        /**
+         * @brief Whether an archive is mapped
+         *
+         * @return true
+         * @return false
+         */
+        bool isOpen() const {
+            return mapping != nullptr;
+        }
+
+        /**
+         * @brief Number of entries in the archive
+         *
+         * @return uint32_t
+         */
+        uint32_t getEntryCount() const {
+            return entryCount;
+        }
+
+        /**
+         * @brief Gets an entry of the index
+         *
+         * @param index
+         * @return const ArchiveEntry&
+         */
+        const ArchiveEntry& getEntry(uint32_t index) const {
+            return entries[index];
+        }
+
+        const ArchiveEntry* findEntry(const std::string& name) const;
+        const void* getData(const ArchiveEntry& entry);
+};
+
+#endif
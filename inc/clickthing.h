@@ -12,6 +12,7 @@
 
 #include "objects.h"
 #include "player.h"
+#include "metrics.h"
 
 /**
  * @class ClickThing
@@ -56,7 +57,8 @@ class ClickThing : public Object {
             }
 
             ptrToPlayer->addPoints(1 * ptrToPlayer->getMultiplier());
-            printf("Points: %d\n", ptrToPlayer->getPoints());
+            gameMetrics.clicks.add();
+            SDL_Log("Points: %d\n", ptrToPlayer->getPoints());
 
             resize(this->height-10, this->width-10);
         }
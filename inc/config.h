@@ -25,7 +25,7 @@
 #include <algorithm>
 
 /**
- * Screen constants
+ * Screen constants. This is the logical resolution, the window can be resized and the scene is scaled to it
  */
 #define SCREEN_WIDTH 640
 #define SCREEN_HEIGHT 480
@@ -33,6 +33,6 @@
 /**
  * Initialize SDL and window
  */
-int init_SDL(SDL_Window** window, SDL_Renderer** renderer);
+int init_SDL(SDL_Window** window, SDL_Renderer** renderer, bool createRenderer = true);
 
 #endif
\ No newline at end of file
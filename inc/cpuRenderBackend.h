@@ -0,0 +1,173 @@
+/**
+ * @file cpuRenderBackend.h
+ * @author Iván
+ * @brief Render backend that rasterizes on the CPU, for hosts without a GPU
+ * @version 0.1
+ * @date 2025-08-03
+ *
+ *
+ */
+#ifndef CPU_RENDER_BACKEND_H
+#define CPU_RENDER_BACKEND_H
+
+#include "renderBackend.h"
+#include "threadPool.h"
+#include <vector>
+
+/**
+ * Height in pixels of the tiles a frame is split into. Tiles are full-width bands, so every row of a draw stays in one task
+ */
+#define CPU_TILE_HEIGHT 32
+
+/**
+ * Pixels a flush has to touch before it is split across threads, smaller flushes run on the calling thread
+ */
+#define CPU_PARALLEL_MIN_PIXELS (64 * 1024)
+
+/**
+ * @class CpuTexture
+ * @brief Texture of the CPU backend. Pixels are premultiplied ARGB, so blending is one multiply per channel
+ */
+class CpuTexture : public RenderTexture {
+    public:
+        std::vector<Uint32> pixels; /*!< Pixels, row after row */
+};
+
+/**
+ * @brief Kinds of recorded draws
+ */
+enum CpuCommandType {
+    CPU_COMMAND_FILL, /*!< Fill a rectangle with a color */
+    CPU_COMMAND_COPY /*!< Draw a texture */
+};
+
+/**
+ * @struct CpuCommand
+ * @brief A draw recorded for the current target. All rectangles are in pixels of the target
+ */
+struct CpuCommand {
+    CpuCommandType type; /*!< Kind of draw */
+    CpuTexture* texture; /*!< Texture to draw, for copies */
+    SDL_Rect src; /*!< Area of the texture */
+    SDL_Rect dst; /*!< Area of the target the texture is scaled to, it can be outside of the target */
+    SDL_Rect clip; /*!< Pixels that may be written, inside the target */
+    Uint32 color; /*!< Premultiplied color, for fills */
+    RenderBlend blend; /*!< Blending of the texture when it was recorded */
+    RenderFilter filter; /*!< Sampling of the texture when it was recorded */
+    SDL_Color tint = {255, 255, 255, 255}; /*!< Color and alpha modulation, for copies */
+    int flip = RENDER_FLIP_NONE; /*!< Mirroring, for copies */
+    bool rotated = false; /*!< Whether the copy is rotated around the center of dst, clip is then its bounding box */
+    float cosAngle = 1.0f; /*!< Cosine of the rotation */
+    float sinAngle = 0.0f; /*!< Sine of the rotation */
+};
+
+/**
+ * @struct CpuRenderStats
+ * @brief Counters of the CPU backend
+ */
+struct CpuRenderStats {
+    unsigned long long commands = 0; /*!< Draws recorded */
+    unsigned long long flushes = 0; /*!< Times the recorded draws were executed */
+    unsigned long long parallelFlushes = 0; /*!< Flushes split into tiles across threads */
+    unsigned long long pixels = 0; /*!< Pixels written */
+};
+
+/**
+ * @class CpuRenderBackend
+ * @brief Renders into a framebuffer in memory and copies it to the window surface on present
+ *
+ * Draws are recorded and executed when the target changes or the frame is presented. The target is then
+ * split into tiles that run on a thread pool; every tile executes all the draws clipped to itself, so tiles
+ * never write the same pixels. Rows are blended with AVX2 or SSE2 when the CPU has them, and scaled draws
+ * sample the texture with nearest or bilinear filtering. Tinted and mirrored copies go through the same row
+ * sampling; rotated copies are sampled with nearest filtering and always blended.
+ *
+ * Without a window the screen is an offscreen framebuffer (for benchmarks and tests).
+ */
+class CpuRenderBackend : public RenderBackend {
+    private:
+        SDL_Window* window; /*!< Window the frames are shown in, nullptr to render offscreen */
+        int logicalWidth; /*!< Logical width of the screen */
+        int logicalHeight; /*!< Logical height of the screen */
+        CpuTexture screen; /*!< Framebuffer of the screen */
+        SDL_Rect viewport = {0, 0, 0, 0}; /*!< Area of the screen the logical resolution is scaled to */
+        float screenScale = 1.0f; /*!< Pixels per logical unit on the screen */
+
+        CpuTexture* target = nullptr; /*!< Current target, nullptr for the screen */
+        float scaleX = 1.0f; /*!< Scale of the current target */
+        float scaleY = 1.0f; /*!< Scale of the current target */
+        bool clipEnabled = false; /*!< Whether draws are clipped */
+        SDL_Rect clip = {0, 0, 0, 0}; /*!< Clip rectangle in logical units */
+
+        std::vector<CpuCommand> commands; /*!< Draws recorded for the current target */
+        size_t commandPixels = 0; /*!< Pixels the recorded draws touch */
+        ThreadPool pool; /*!< Threads that execute the tiles */
+        const char* blendPath = "scalar"; /*!< Instruction set used to blend rows */
+        CpuRenderStats stats; /*!< Counters */
+
+        CpuTexture* currentTarget();
+        SDL_Rect targetBounds();
+        SDL_Rect toPixels(const SDL_Rect& rect);
+        bool clipToTarget(const SDL_Rect& rect, SDL_Rect* clipped);
+        void resizeScreen(int width, int height);
+        void flush();
+        void runTile(CpuTexture* output, const SDL_Rect& tile);
+
+    public:
+        CpuRenderBackend(SDL_Window* window, int width, int height, int logicalWidth, int logicalHeight, size_t threads = 0);
+        ~CpuRenderBackend();
+
+        /**
+         * @brief Name of the backend, for logs
+         *
+         * @return const char*
+         */
+        const char* getName() const override {
+            return "cpu";
+        }
+
+        RenderTexture* createTexture(int width, int height, bool target, Uint32 format = SDL_PIXELFORMAT_ARGB8888) override;
+        RenderTexture* createTextureFromSurface(SDL_Surface* surface) override;
+        int updateTexture(RenderTexture* texture, const SDL_Rect* rect, const void* pixels, int pitch) override;
+        void destroyTexture(RenderTexture* texture) override;
+        void setTextureBlend(RenderTexture* texture, RenderBlend blend) override;
+        void setTextureFilter(RenderTexture* texture, RenderFilter filter) override;
+
+        bool supportsTargets() const override;
+        int setTarget(RenderTexture* target) override;
+        RenderTexture* getTarget() const override;
+        void setScale(float scaleX, float scaleY) override;
+        void getScale(float* scaleX, float* scaleY) const override;
+        void setClip(const SDL_Rect* clip) override;
+        bool getClip(SDL_Rect* clip) const override;
+
+        void clear(SDL_Color color) override;
+        void fillRect(const SDL_Rect* rect, SDL_Color color) override;
+        void copy(RenderTexture* texture, const SDL_Rect* src, const SDL_Rect* dst) override;
+        void copyEx(RenderTexture* texture, const SDL_Rect* src, const SDL_Rect* dst, const RenderState& state) override;
+        void present() override;
+        void handleEvent(SDL_Event& e) override;
+
+        void finish();
+        void logStats() const;
+
+        /**
+         * @brief Framebuffer of the screen. Call finish() first so every draw is in it
+         *
+         * @return const CpuTexture&
+         */
+        const CpuTexture& getScreen() const {
+            return screen;
+        }
+
+        /**
+         * @brief Counters of the backend
+         *
+         * @return const CpuRenderStats&
+         */
+        const CpuRenderStats& getStats() const {
+            return stats;
+        }
+};
+
+#endif
@@ -0,0 +1,118 @@
+/**
+ * @file debugHud.h
+ * @author Iván
+ * @brief On-screen performance overlay and overdraw heatmap
+ * @version 0.1
+ * @date 2025-08-03
+ *
+ *
+ */
+#ifndef DEBUG_HUD_H
+#define DEBUG_HUD_H
+
+#include "config.h"
+#include "renderBackend.h"
+#include "textLayout.h"
+#include <memory>
+#include <vector>
+
+class ObjectManager;
+class TextureManager;
+
+#define DEBUG_HUD_GRAPH_SIZE 120 /*!< Frames shown in the frame time graph */
+#define DEBUG_HUD_GRAPH_HEIGHT 60 /*!< Height of the graph in pixels */
+#define DEBUG_HUD_GRAPH_MAX_MS 50.0f /*!< Frame time at the top of the graph */
+#define DEBUG_HUD_TEXT_INTERVAL 15 /*!< Frames between refreshes of the counters text */
+#define DEBUG_HUD_HEATMAP_ALPHA 160 /*!< Opacity of the heatmap over the scene */
+
+/**
+ * @class OverdrawMap
+ * @brief Number of times every pixel of the logical screen was written in a frame
+ */
+class OverdrawMap {
+    private:
+        std::vector<Uint16> counts; /*!< Writes per pixel, row by row */
+        int width = 0; /*!< Width of the map */
+        int height = 0; /*!< Height of the map */
+
+    public:
+        OverdrawMap(int width, int height);
+
+        void clear();
+        void add(const SDL_Rect& rect, const SDL_Rect* region = nullptr);
+
+        /**
+         * @brief Writes of a pixel
+         *
+         * @param x
+         * @param y
+         * @return int
+         */
+        int get(int x, int y) const {
+            return counts[static_cast<size_t>(y) * width + x];
+        }
+
+        int getWidth() const {
+            return width;
+        }
+
+        int getHeight() const {
+            return height;
+        }
+};
+
+/**
+ * @class DebugHud
+ * @brief Overlay with a rolling frame time graph, the draw calls and texture switches of the last frame, the
+ * number of objects and the texture memory. It can also show an overdraw heatmap: every pixel tinted by how many
+ * times drawActiveObjects and drawAllTexts wrote it in the frame.
+ *
+ * It is drawn on the screen after the scene, so it is never part of the cached scene layer.
+ */
+class DebugHud {
+    private:
+        RenderBackend* backend; /*!< Backend it draws with */
+        TTF_Font** font; /*!< Font of the counters */
+
+        float frameTimes[DEBUG_HUD_GRAPH_SIZE] = {}; /*!< Last frame times in milliseconds, a ring buffer */
+        int nextFrame = 0; /*!< Slot of the next frame time */
+        int framesSinceText = DEBUG_HUD_TEXT_INTERVAL; /*!< Frames since the counters text was refreshed */
+
+        RenderCounters frameCounters; /*!< Work of the backend for the last scene */
+        std::unique_ptr<TextLayout> text; /*!< Counters text */
+
+        OverdrawMap overdraw; /*!< Writes per pixel of the last scene */
+        RenderTexture* heatmap = nullptr; /*!< Heatmap texture, updated every frame */
+        std::vector<Uint32> heatmapPixels; /*!< Pixels of the heatmap */
+
+        void refreshText(ObjectManager& objManager, TextureManager& textureManager);
+        void drawGraph(int x, int y);
+        void drawHeatmap();
+
+    public:
+        bool visible = false; /*!< Whether the counters and the graph are shown */
+        bool showHeatmap = false; /*!< Whether the overdraw heatmap is shown */
+
+        DebugHud(RenderBackend* backend, TTF_Font** font);
+        ~DebugHud();
+        DebugHud(const DebugHud&) = delete;
+        DebugHud& operator=(const DebugHud&) = delete;
+
+        void release();
+        void addFrameTime(float milliseconds);
+        void beginFrame(ObjectManager& objManager);
+        void draw(ObjectManager& objManager, TextureManager& textureManager);
+
+        /**
+         * @brief Whether the scene must be fully redrawn this frame. The heatmap counts the writes of a whole scene,
+         * not only of its dirty areas
+         *
+         * @return true
+         * @return false
+         */
+        bool needsFullRedraw() const {
+            return showHeatmap;
+        }
+};
+
+#endif
@@ -0,0 +1,75 @@
+/**
+ * @file dirtyRenderer.h
+ * @author Iván
+ * @brief Dirty-rectangle renderer that keeps the composed scene cached in a render target
+ * @version 0.1
+ * @date 2025-07-20
+ *
+ *
+ */
+#ifndef DIRTY_RENDERER_H
+#define DIRTY_RENDERER_H
+
+#include "config.h"
+#include <vector>
+
+#include "objects.h"
+#include "textureManager.h"
+
+/**
+ * @class DirtyRectRenderer
+ * @brief Renders the scene by recompositing only the areas that changed since the last frame.
+ *
+ * The composed scene lives in a render-target texture. Every frame the renderer collects the
+ * areas touched by moved, resized, retextured, (de)activated or destroyed objects and redraws
+ * only the objects that intersect them, clipped to those areas. The cached scene is then copied
+ * to the screen with a single copy.
+ *
+ * Objects are placed in logical coordinates (SCREEN_WIDTH x SCREEN_HEIGHT). The layer has the size of the
+ * scene on the screen in pixels and is drawn with the logical to pixel scale, so a resized window or a
+ * high-DPI display gets a sharp scene instead of an upscaled 640x480 one.
+ */
+class DirtyRectRenderer {
+
+    private:
+        RenderBackend* backend; /*!< Backend the scene is drawn with */
+        RenderTexture* sceneLayer = nullptr; /*!< Cached composition of the whole scene */
+        std::vector<SDL_Rect> dirtyRects; /*!< Areas to recomposite this frame */
+        bool fullRedraw = true; /*!< Whether the whole scene must be recomposited */
+        int width; /*!< Logical width of the scene */
+        int height; /*!< Logical height of the scene */
+        int layerWidth = 0; /*!< Width of the cached layer in pixels */
+        int layerHeight = 0; /*!< Height of the cached layer in pixels */
+        float scaleX = 1.0f; /*!< Pixels per logical unit, horizontally */
+        float scaleY = 1.0f; /*!< Pixels per logical unit, vertically */
+        int lastDirtyArea = 0; /*!< Pixels recomposited during the last frame */
+
+        int createLayer();
+        void collectDirtyRects(ObjectManager& objManager);
+        void collectSubtree(Object* obj, bool parentVisible);
+        void mergeDirtyRects();
+        void drawRegion(ObjectManager& objManager, TextureManager& textureManager, const SDL_Rect* region);
+
+    public:
+        bool enabled = true; /*!< When false every frame is cleared and fully redrawn */
+
+        DirtyRectRenderer(RenderBackend* backend, int width, int height);
+        ~DirtyRectRenderer();
+
+        int init();
+        void release();
+        void invalidate();
+        void handleEvent(SDL_Event& e);
+        void renderFrame(ObjectManager& objManager, TextureManager& textureManager);
+
+        /**
+         * @brief Get the amount of pixels recomposited during the last frame
+         *
+         * @return int
+         */
+        int getLastDirtyArea() const {
+            return lastDirtyArea;
+        }
+};
+
+#endif
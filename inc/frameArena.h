@@ -0,0 +1,96 @@
+/**
+ * @file frameArena.h
+ * @author Iván
+ * @brief Frame-scoped bump allocator for transient allocations
+ * @version 0.1
+ * @date 2025-07-26
+ *
+ *
+ */
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+/**
+ * Initial size of the frame arena
+ */
+#define FRAME_ARENA_SIZE (64 * 1024)
+
+/**
+ * @class FrameArena
+ * @brief Bump allocator reset at the end of every frame. Deallocation does nothing, memory is reclaimed all at once by reset().
+ *
+ * Use it through std::pmr containers for data that does not outlive the frame:
+ *
+ *     std::pmr::vector<Item*> list(&frameArena());
+ *
+ * If a frame needs more than the arena capacity, extra blocks are chained; on the next reset they are merged
+ * into one bigger block, so in steady state the arena does not touch the heap at all.
+ */
+class FrameArena : public std::pmr::memory_resource {
+
+    private:
+        /**
+         * @brief A chunk of memory of the arena
+         */
+        struct Block {
+            char* data; /*!< Memory of the block */
+            size_t size; /*!< Size of the block */
+        };
+
+        std::vector<Block> blocks; /*!< Blocks of the arena, only the first one is used in steady state */
+        size_t currentBlock = 0; /*!< Block allocations are taken from */
+        size_t offset = 0; /*!< Used bytes of the current block */
+        size_t usedBytes = 0; /*!< Bytes handed out since the last reset */
+        size_t highWater = 0; /*!< Maximum bytes handed out during a frame */
+        unsigned long long growths = 0; /*!< Times the arena needed a new block */
+
+        void addBlock(size_t size);
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    public:
+        FrameArena(size_t initialSize = FRAME_ARENA_SIZE);
+        ~FrameArena();
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        void reset();
+
+        /**
+         * @brief Bytes handed out since the last reset
+         *
+         * @return size_t
+         */
+        size_t getUsedBytes() const {
+            return usedBytes;
+        }
+
+        /**
+         * @brief Maximum bytes handed out during a frame
+         *
+         * @return size_t
+         */
+        size_t getHighWater() const {
+            return highWater;
+        }
+
+        /**
+         * @brief Times the arena had to get more memory from the heap
+         *
+         * @return unsigned long long
+         */
+        unsigned long long getGrowths() const {
+            return growths;
+        }
+};
+
+FrameArena& frameArena();
+
+#endif
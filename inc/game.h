@@ -0,0 +1,68 @@
+/**
+ * @file game.h
+ * @author Iván
+ * @brief Game state and rules, shared by the live game and the replay
+ * @version 0.1
+ * @date 2025-07-27
+ *
+ *
+ */
+#ifndef GAME_H
+#define GAME_H
+
+#include "objects.h"
+#include "player.h"
+#include "clickthing.h"
+#include "store.h"
+#include "rulesEngine.h"
+#include "scheduler.h"
+#include "timingWheel.h"
+#include <cstdint>
+
+/**
+ * @enum GameTimerEvent
+ * @brief Event IDs of the timers of the game
+ */
+enum GameTimerEvent {
+    GAME_EVENT_STORE_RESTOCK = 1 /*!< The store offers new items, the target is the store */
+};
+
+/**
+ * @class Game
+ * @brief Owns the player, the clickable thing and the store with its items. Everything that changes the
+ * game state goes through handleEvent() and update(), so the same input replayed gives the same state.
+ *
+ * Periodic effects (the store restock) are timers of a timing wheel and timed sequences (timed effects) run on the
+ * scheduler. Both run on the time passed to update(): the recorded frame times in a replay.
+ */
+class Game {
+    public:
+        Player player; /*!< The player */
+        ObjectManager objectManager; /*!< Objects of the game */
+        ClickThing clicky; /*!< The object clicked to get points */
+        Store store; /*!< The store */
+        std::vector<Item*> items; /*!< Items of the store, owned by the game */
+        RulesEngine rules; /*!< Achievements and item unlocks */
+        int pointsStat; /*!< Points in the rules engine */
+        int multiplierStat; /*!< Multiplier in the rules engine */
+        std::vector<int> levelStats; /*!< Level of every item in the rules engine */
+        TimingWheel timers; /*!< Periodic and delayed effects of the game */
+        Scheduler scheduler; /*!< Timed sequences of the game. Declared last, so they are destroyed before what they use */
+
+        Game();
+        ~Game();
+        Game(const Game&) = delete;
+        Game& operator=(const Game&) = delete;
+
+        void setupRules();
+        void updateRules();
+        void addCatalog(int count);
+        void start(unsigned int seed);
+        void handleEvent(SDL_Event& e);
+        void update(Uint32 milliseconds);
+        void handleTimerEvent(const TimerEvent& event);
+        uint64_t stateHash();
+        void logState();
+};
+
+#endif
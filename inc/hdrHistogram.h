@@ -0,0 +1,87 @@
+/**
+ * @file hdrHistogram.h
+ * @author Iván
+ * @brief High dynamic range histogram
+ * @version 0.1
+ * @date 2025-07-30
+ *
+ *
+ */
+#ifndef HDR_HISTOGRAM_H
+#define HDR_HISTOGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class HdrHistogram
+ * @brief Histogram of integer values (microseconds for latencies) that keeps a fixed number of significant
+ * figures over the whole range. Buckets are powers of two, each split linearly in sub-buckets, so recording is
+ * a few bit operations and an increment, and memory does not depend on the number of values recorded.
+ *
+ * Not thread safe, values are recorded by the thread that owns it.
+ */
+class HdrHistogram {
+    private:
+        int64_t highestTrackable; /*!< Values above are recorded as this value */
+        int unitMagnitude; /*!< log2 of the lowest discernible value */
+        int subBucketHalfCountMagnitude; /*!< log2 of half the sub-buckets of a bucket */
+        int64_t subBucketCount; /*!< Sub-buckets in a bucket */
+        int64_t subBucketHalfCount; /*!< Half of subBucketCount */
+        int64_t subBucketMask; /*!< Mask of the values that fall in the first bucket */
+        std::vector<uint64_t> counts; /*!< Values recorded in every sub-bucket */
+        uint64_t totalCount = 0; /*!< Values recorded */
+        int64_t minValue = INT64_MAX; /*!< Lowest value recorded */
+        int64_t maxValue = 0; /*!< Highest value recorded */
+        double sum = 0.0; /*!< Sum of the values recorded, for the mean */
+
+        size_t countsIndexFor(int64_t value) const;
+        int64_t valueFromIndex(size_t index) const;
+        int64_t highestEquivalentValue(int64_t value) const;
+
+    public:
+        HdrHistogram(int64_t lowestDiscernible, int64_t highestTrackable, int significantFigures);
+
+        void record(int64_t value);
+        void reset();
+        int64_t valueAtPercentile(double percentile) const;
+
+        /**
+         * @brief Gets the number of values recorded
+         *
+         * @return uint64_t
+         */
+        uint64_t getTotalCount() const {
+            return totalCount;
+        }
+
+        /**
+         * @brief Gets the highest value recorded
+         *
+         * @return int64_t
+         */
+        int64_t getMax() const {
+            return maxValue;
+        }
+
+        /**
+         * @brief Gets the lowest value recorded
+         *
+         * @return int64_t
+         */
+        int64_t getMin() const {
+            return totalCount ? minValue : 0;
+        }
+
+        /**
+         * @brief Gets the mean of the values recorded
+         *
+         * @return double
+         */
+        double getMean() const {
+            return totalCount ? sum / totalCount : 0.0;
+        }
+};
+
+#endif
@@ -0,0 +1,123 @@
+/**
+ * @file inputLog.h
+ * @author Iván
+ * @brief Recording and replay of the input of a game
+ * @version 0.1
+ * @date 2025-07-27
+ *
+ *
+ */
+#ifndef INPUT_LOG_H
+#define INPUT_LOG_H
+
+#include "config.h"
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+/**
+ * Layout of an input log (all values little endian):
+ *
+ *  magic (8 bytes, INPUT_LOG_MAGIC), version (u32), seed of the game (u32)
+ *  records until the end of the file
+ *
+ * Every record starts with its type (u8) and the milliseconds since the previous record (u16). Mouse button
+ * records follow with the button (u8), x (i16) and y (i16). Mouse wheel records follow with the notches scrolled
+ * (i16, positive away from the user). A frame record marks the point of the main loop where the game is updated,
+ * so the replay runs the updates between the same events. A gap longer than the u16 delta (a stall, a window
+ * being dragged) is written as a time skip record with the milliseconds (u32) before the record that follows it.
+ *
+ * Version 2 added the wheel records and version 3 the time skip records, older logs are still read (their
+ * deltas were saturated).
+ */
+#define INPUT_LOG_MAGIC "CLKREC1"
+#define INPUT_LOG_VERSION 3
+
+/**
+ * Bytes the recorder buffers before writing to the file
+ */
+#define INPUT_LOG_BUFFER_SIZE (64 * 1024)
+
+/**
+ * @brief Type of a record of the log
+ */
+enum InputRecordType : uint8_t {
+    INPUT_FRAME = 0, /*!< End of the events of a frame */
+    INPUT_BUTTON_DOWN = 1, /*!< SDL_MOUSEBUTTONDOWN */
+    INPUT_BUTTON_UP = 2, /*!< SDL_MOUSEBUTTONUP */
+    INPUT_WHEEL = 3, /*!< SDL_MOUSEWHEEL */
+    INPUT_TIME_SKIP = 4 /*!< Time that did not fit in the delta of the next record, never returned by InputReplay */
+};
+
+/**
+ * @struct InputRecord
+ * @brief A record read back from a log
+ */
+struct InputRecord {
+    InputRecordType type; /*!< Type of the record */
+    Uint32 timestamp; /*!< Milliseconds since the start of the recording */
+    SDL_Event event; /*!< Rebuilt event of button and wheel records */
+};
+
+/**
+ * @class InputRecorder
+ * @brief Writes the input the main loop sees to a log
+ */
+class InputRecorder {
+    private:
+        FILE* file = nullptr; /*!< Log being written */
+        std::vector<unsigned char> buffer; /*!< Records not written yet */
+        Uint32 lastTimestamp = 0; /*!< Timestamp of the previous record */
+        unsigned long long records = 0; /*!< Records written */
+
+        void writeRecordStart(InputRecordType type, Uint32 timestamp);
+        int flush();
+
+    public:
+        InputRecorder() = default;
+        ~InputRecorder();
+        InputRecorder(const InputRecorder&) = delete;
+        InputRecorder& operator=(const InputRecorder&) = delete;
+
+        int open(const std::string& path, unsigned int seed, Uint32 startTimestamp);
+        void recordEvent(const SDL_Event& e);
+        void recordFrame(Uint32 timestamp);
+        int close();
+
+        /**
+         * @brief Checks if a log is being recorded
+         *
+         * @return true
+         * @return false
+         */
+        bool isOpen() const {
+            return file != nullptr;
+        }
+};
+
+/**
+ * @class InputReplay
+ * @brief Reads back a log recorded by InputRecorder. The whole log is loaded in memory so it can be read as fast as possible
+ */
+class InputReplay {
+    private:
+        std::vector<unsigned char> data; /*!< Contents of the log */
+        size_t position = 0; /*!< Offset of the next record */
+        Uint32 timestamp = 0; /*!< Timestamp of the last record read */
+        unsigned int seed = 0; /*!< Seed of the recorded game */
+
+    public:
+        int open(const std::string& path);
+        bool next(InputRecord& record);
+
+        /**
+         * @brief Gets the seed of the recorded game
+         *
+         * @return unsigned int
+         */
+        unsigned int getSeed() const {
+            return seed;
+        }
+};
+
+#endif
@@ -0,0 +1,90 @@
+/**
+ * @file latencyTracker.h
+ * @author Iván
+ * @brief Input-to-present latency and frame time measurement
+ * @version 0.1
+ * @date 2025-07-30
+ *
+ *
+ */
+#ifndef LATENCY_TRACKER_H
+#define LATENCY_TRACKER_H
+
+#include "config.h"
+#include "hdrHistogram.h"
+
+/**
+ * Handled inputs waiting for a present, more in a single frame are dropped
+ */
+#define LATENCY_MAX_PENDING 64
+
+/**
+ * Highest latency or frame time tracked, in microseconds
+ */
+#define LATENCY_MAX_MICROSECONDS (10 * 1000 * 1000)
+
+/**
+ * @class LatencyTracker
+ * @brief Measures the time from an input event (its SDL timestamp) to the SDL_RenderPresent that first shows
+ * its effect. ObjectManager reports every event that reached an onClick handler, and the main loop reports
+ * every present; all events handled before a present are shown by it.
+ */
+class LatencyTracker {
+    private:
+        /**
+         * @brief An input handled but not presented yet
+         */
+        struct PendingInput {
+            Uint32 eventTicks; /*!< SDL timestamp of the event */
+            Uint32 handledTicks; /*!< SDL_GetTicks() when it was handled */
+            Uint64 handledCounter; /*!< Performance counter when it was handled */
+        };
+
+        bool enabled = false; /*!< Only the live game measures, replays do not present */
+        PendingInput pending[LATENCY_MAX_PENDING]; /*!< Inputs waiting for a present */
+        int pendingCount = 0; /*!< Number of pending inputs */
+        unsigned long long droppedInputs = 0; /*!< Inputs that did not fit in pending */
+        Uint64 lastPresent = 0; /*!< Performance counter of the last present */
+        HdrHistogram inputLatency; /*!< Input-to-present latency in microseconds */
+        HdrHistogram frameTime; /*!< Time between presents in microseconds */
+
+    public:
+        LatencyTracker();
+
+        /**
+         * @brief Turns the measurement on or off
+         *
+         * @param on
+         */
+        void setEnabled(bool on) {
+            enabled = on;
+        }
+
+        void inputHandled(Uint32 eventTimestamp);
+        long long framePresented();
+
+        int formatSummary(char* buffer, size_t size) const;
+        void logReport() const;
+
+        /**
+         * @brief Gets the input-to-present latencies, in microseconds
+         *
+         * @return const HdrHistogram&
+         */
+        const HdrHistogram& getInputLatency() const {
+            return inputLatency;
+        }
+
+        /**
+         * @brief Gets the frame times, in microseconds
+         *
+         * @return const HdrHistogram&
+         */
+        const HdrHistogram& getFrameTime() const {
+            return frameTime;
+        }
+};
+
+LatencyTracker& latencyTracker();
+
+#endif
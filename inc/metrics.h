@@ -0,0 +1,211 @@
+/**
+ * @file metrics.h
+ * @author Iván
+ * @brief In-process metrics (counters, gauges and histograms) and their Prometheus text export
+ * @version 0.1
+ * @date 2025-07-29
+ *
+ *
+ */
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Milliseconds between two exports
+ */
+#define METRICS_EXPORT_INTERVAL 1000
+
+/**
+ * Maximum number of buckets of a histogram (without the +Inf bucket)
+ */
+#define HISTOGRAM_MAX_BUCKETS 16
+
+/**
+ * @class Metric
+ * @brief A named metric of the registry. Metrics register themselves on construction and must outlive the exports
+ */
+class Metric {
+    protected:
+        const char* name; /*!< Prometheus name of the metric */
+        const char* help; /*!< Description of the metric */
+
+    public:
+        Metric(const char* name, const char* help);
+        virtual ~Metric() = default;
+        Metric(const Metric&) = delete;
+        Metric& operator=(const Metric&) = delete;
+
+        virtual void write(std::string& out) const = 0;
+};
+
+/**
+ * @class Counter
+ * @brief Value that only goes up. Prometheus gets rates (clicks per second...) from it with rate()
+ */
+class Counter : public Metric {
+    private:
+        std::atomic<uint64_t> value{0}; /*!< Current value */
+
+    public:
+        Counter(const char* name, const char* help) : Metric(name, help) {}
+
+        /**
+         * @brief Adds to the counter. Only a relaxed atomic increment, safe on the hot path and from any thread
+         *
+         * @param amount
+         */
+        void add(uint64_t amount = 1) {
+            value.fetch_add(amount, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Gets the value of the counter
+         *
+         * @return uint64_t
+         */
+        uint64_t get() const {
+            return value.load(std::memory_order_relaxed);
+        }
+
+        void write(std::string& out) const override;
+};
+
+/**
+ * @class Gauge
+ * @brief Value that goes up and down
+ */
+class Gauge : public Metric {
+    private:
+        std::atomic<long long> value{0}; /*!< Current value */
+
+    public:
+        Gauge(const char* name, const char* help) : Metric(name, help) {}
+
+        /**
+         * @brief Sets the value of the gauge
+         *
+         * @param newValue
+         */
+        void set(long long newValue) {
+            value.store(newValue, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Adds to the gauge (negative to subtract)
+         *
+         * @param amount
+         */
+        void add(long long amount) {
+            value.fetch_add(amount, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Gets the value of the gauge
+         *
+         * @return long long
+         */
+        long long get() const {
+            return value.load(std::memory_order_relaxed);
+        }
+
+        void write(std::string& out) const override;
+};
+
+/**
+ * @class Histogram
+ * @brief Distribution of observed values over fixed buckets
+ */
+class Histogram : public Metric {
+    private:
+        double bounds[HISTOGRAM_MAX_BUCKETS]; /*!< Upper bound of every bucket, ascending */
+        int bucketCount; /*!< Number of bounds */
+        std::atomic<uint64_t> buckets[HISTOGRAM_MAX_BUCKETS + 1]; /*!< Observations per bucket, the last one is +Inf */
+        std::atomic<uint64_t> count{0}; /*!< Number of observations */
+        std::atomic<double> sum{0.0}; /*!< Sum of the observations */
+
+    public:
+        Histogram(const char* name, const char* help, std::initializer_list<double> upperBounds);
+
+        void observe(double value);
+        void write(std::string& out) const override;
+};
+
+/**
+ * @class MetricsRegistry
+ * @brief List of every metric of the process
+ */
+class MetricsRegistry {
+    private:
+        std::mutex mutex; /*!< Protects the list, only taken on registration and export */
+        std::vector<Metric*> metrics; /*!< Registered metrics */
+
+    public:
+        void add(Metric* metric);
+        void writePrometheus(std::string& out);
+};
+
+MetricsRegistry& metricsRegistry();
+
+/**
+ * @struct GameMetrics
+ * @brief Metrics of the game. Counters are updated where things happen, gauges are sampled once per frame
+ */
+struct GameMetrics {
+    Counter clicks{"clicker_clicks_total", "Clicks on the click thing"};
+    Counter purchases{"clicker_purchases_total", "Items bought in the store"};
+    Counter storeRefreshes{"clicker_store_refreshes_total", "Times the available items of the store were randomized"};
+    Counter frames{"clicker_frames_total", "Frames presented"};
+    Histogram frameTime{"clicker_frame_seconds", "Time between two presented frames",
+        {0.004, 0.008, 0.012, 0.016, 0.02, 0.025, 0.033, 0.05, 0.1, 0.25, 1.0}};
+    Gauge residentTextures{"clicker_textures_resident", "Textures loaded in video memory"};
+    Gauge textureBytes{"clicker_texture_bytes", "Video memory used by resident textures"};
+    Gauge objects{"clicker_objects", "Objects in the object manager"};
+    Gauge activeObjects{"clicker_active_objects", "Active objects in the object manager"};
+    Gauge availableItems{"clicker_store_available_items", "Items available in the store"};
+    Gauge points{"clicker_player_points", "Points of the player"};
+    Gauge multiplier{"clicker_player_multiplier", "Points per click of the player"};
+};
+
+extern GameMetrics gameMetrics;
+
+/**
+ * @class MetricsExporter
+ * @brief Thread that exports the registry in Prometheus text format, periodically to a file and/or on request
+ * through a Unix domain socket (every connection gets the current values). Sockets are not available on Windows.
+ */
+class MetricsExporter {
+    private:
+        std::thread thread; /*!< Export thread */
+        std::mutex mutex; /*!< Protects running */
+        std::condition_variable stopRequested; /*!< Wakes the thread to stop */
+        bool running = false; /*!< Cleared to stop the thread */
+        std::string filePath; /*!< File written every interval, empty for none */
+        std::string socketPath; /*!< Socket listened on, empty for none */
+        int listenSocket = -1; /*!< Listening socket */
+        int interval = METRICS_EXPORT_INTERVAL; /*!< Milliseconds between exports to the file */
+
+        int openSocket();
+        void writeFile(const std::string& text);
+        void serveSocket(int timeout);
+        void exportLoop();
+
+    public:
+        MetricsExporter() = default;
+        ~MetricsExporter();
+        MetricsExporter(const MetricsExporter&) = delete;
+        MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+        int start(const std::string& filePath, const std::string& socketPath, int interval = METRICS_EXPORT_INTERVAL);
+        void stop();
+};
+
+#endif
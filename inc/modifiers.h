@@ -0,0 +1,102 @@
+/**
+ * @file modifiers.h
+ * @author Iván
+ * @brief Stat modifiers with cached aggregate values
+ * @version 0.1
+ * @date 2025-07-31
+ *
+ *
+ */
+#ifndef MODIFIERS_H
+#define MODIFIERS_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @brief How a modifier changes the value of a stat
+ */
+enum ModifierType {
+    MODIFIER_ADD = 0, /*!< value + amount */
+    MODIFIER_MULTIPLY = 1, /*!< value * amount */
+    MODIFIER_EXPONENT = 2 /*!< pow(value, amount) */
+};
+
+/**
+ * @struct Modifier
+ * @brief A change applied to a stat
+ */
+struct Modifier {
+    int id; /*!< Handle of the modifier, used to remove it */
+    ModifierType type; /*!< How it changes the stat */
+    double amount; /*!< Amount added, multiplied or raised to */
+    std::string source; /*!< What applied the modifier (an item ID...), all modifiers of a source can be removed at once */
+    int priority; /*!< Modifiers with lower priority are applied first */
+};
+
+/**
+ * @class ModifierStack
+ * @brief Named stats with a base value and a list of modifiers. The value of a stat is
+ *
+ *     base, then every modifier in order of priority (and add, multiply, exponent within the same priority)
+ *
+ * It is cached and only recomputed after the modifiers of that stat change, so reading a stat is a flag check
+ * and a load no matter how many modifiers it has.
+ */
+class ModifierStack {
+    private:
+        /**
+         * @brief A stat and its modifiers
+         */
+        struct Stat {
+            std::string name; /*!< Name of the stat */
+            double base; /*!< Value without modifiers */
+            double value; /*!< Cached value with modifiers */
+            bool dirty; /*!< Whether the cached value must be recomputed */
+            std::vector<Modifier> modifiers; /*!< Modifiers, kept in the order they are applied */
+        };
+
+        std::vector<Stat> stats; /*!< Stats, indexed by their ID */
+        std::map<std::string, int> statIds; /*!< ID of every stat by name */
+        std::map<int, int> modifierStats; /*!< Stat of every modifier by modifier ID */
+        int nextModifierId = 1; /*!< ID of the next modifier */
+        unsigned long long recomputes = 0; /*!< Times a cached value was recomputed */
+
+        void recompute(Stat& stat);
+
+    public:
+        int addStat(const std::string& name, double base);
+        int findStat(const std::string& name) const;
+        void setBase(int stat, double base);
+
+        int addModifier(int stat, ModifierType type, double amount, const std::string& source, int priority = 0);
+        int removeModifier(int modifierId);
+        int removeSource(const std::string& source);
+        const std::vector<Modifier>& getModifiers(int stat) const;
+
+        /**
+         * @brief Gets the value of a stat with all its modifiers
+         *
+         * @param stat ID of the stat
+         * @return double
+         */
+        double getValue(int stat) {
+            Stat& entry = stats[stat];
+            if(entry.dirty) {
+                recompute(entry);
+            }
+            return entry.value;
+        }
+
+        /**
+         * @brief Gets how many times a value was recomputed
+         *
+         * @return unsigned long long
+         */
+        unsigned long long getRecomputes() const {
+            return recomputes;
+        }
+};
+
+#endif
@@ -0,0 +1,98 @@
+/**
+ * @file mpscQueue.h
+ * @author Iván
+ * @brief Lock-free multiple producer, single consumer queue
+ * @version 0.1
+ * @date 2025-08-03
+ *
+ *
+ */
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <atomic>
+#include <utility>
+
+/**
+ * @class MpscQueue
+ * @brief Unbounded queue any thread can push to and one thread pops from (Vyukov's node-based MPSC queue).
+ *
+ * A push is one atomic exchange on the head and a store to the previous node, so producers never wait for each
+ * other or for the consumer. The consumer walks the nodes from the tail. A node whose producer exchanged the
+ * head but has not linked it yet ends the walk, it is popped on the next call.
+ *
+ * @tparam T Type of the values
+ */
+template <typename T>
+class MpscQueue {
+    private:
+        /**
+         * @brief A value in the queue. The node at the tail holds no value (it was popped or it is the first one)
+         */
+        struct Node {
+            std::atomic<Node*> next{nullptr}; /*!< Next node, pushed after this one */
+            T value; /*!< Value */
+        };
+
+        alignas(64) std::atomic<Node*> head; /*!< Last pushed node, producers swap it */
+        alignas(64) Node* tail; /*!< Node before the first value, only the consumer touches it */
+
+    public:
+        MpscQueue() {
+            Node* stub = new Node();
+            head.store(stub, std::memory_order_relaxed);
+            tail = stub;
+        }
+
+        ~MpscQueue() {
+            T value;
+            while(pop(value)) {
+            }
+            delete tail;
+        }
+
+        MpscQueue(const MpscQueue&) = delete;
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+        /**
+         * @brief Adds a value at the end of the queue. Can be called from any thread
+         *
+         * @param value
+         */
+        void push(T value) {
+            Node* node = new Node();
+            node->value = std::move(value);
+            Node* previous = head.exchange(node, std::memory_order_acq_rel);
+            previous->next.store(node, std::memory_order_release);
+        }
+
+        /**
+         * @brief Takes the first value of the queue. Only the consumer thread can call it
+         *
+         * @param value Set to the value taken
+         * @return true if a value was taken
+         * @return false if the queue is empty (or its first value is still being pushed)
+         */
+        bool pop(T& value) {
+            Node* next = tail->next.load(std::memory_order_acquire);
+            if(!next) {
+                return false;
+            }
+            value = std::move(next->value);
+            delete tail;
+            tail = next;
+            return true;
+        }
+
+        /**
+         * @brief Checks if there is a value to pop. Only the consumer thread can call it
+         *
+         * @return true
+         * @return false
+         */
+        bool empty() const {
+            return tail->next.load(std::memory_order_acquire) == nullptr;
+        }
+};
+
+#endif
@@ -0,0 +1,44 @@
+/**
+ * @file numberFormat.h
+ * @author Iván
+ * @brief Number formatting into fixed buffers, without heap allocations
+ * @version 0.1
+ * @date 2025-07-24
+ *
+ *
+ */
+#ifndef NUMBER_FORMAT_H
+#define NUMBER_FORMAT_H
+
+#include <cstddef>
+
+/**
+ * Size of a buffer big enough for any formatted number
+ */
+#define NUMBER_BUFFER_SIZE 48
+
+/**
+ * @brief How numbers are written
+ */
+enum class Notation {
+    Plain, /*!< All the digits: 1234567 */
+    Suffix, /*!< Short scale suffixes: 1.23M (scientific once the suffixes run out) */
+    Scientific, /*!< 1.23e6 */
+    Engineering /*!< Exponent multiple of 3: 1.23e6, 12.3e3 */
+};
+
+/**
+ * @struct NumberFormat
+ * @brief Options for formatting numbers
+ */
+struct NumberFormat {
+    Notation notation = Notation::Suffix; /*!< Notation to use */
+    int precision = 2; /*!< Maximum decimals of the mantissa, trailing zeros are removed */
+    double threshold = 1000; /*!< Numbers below this are always written plain */
+};
+
+size_t formatNumber(char* buffer, size_t size, long long value, const NumberFormat& format);
+size_t formatNumber(char* buffer, size_t size, double value, const NumberFormat& format);
+size_t formatLabel(char* buffer, size_t size, const char* prefix, long long value, const NumberFormat& format);
+
+#endif
@@ -15,14 +15,57 @@
 #include <vector>
 
 #include "textureManager.h"
+#include "animation.h"
+#include "mpscQueue.h"
 
 class TextureManager;
 class Object;
 class Text;
+class OverdrawMap;
+
+/**
+ * @brief How an object is drawn. Objects are drawn in one batch per kind, so each batch is a loop over a single concrete type
+ */
+enum ObjectKind {
+    OBJECT_SPRITE, /*!< Drawn with its texture from the texture manager (Object, ClickThing, Store, StoreRow...) */
+    OBJECT_TEXT /*!< Text, drawn with its own texture on top of the sprites */
+};
+
+/**
+ * @brief Mutations of the ObjectManager that can be deferred
+ */
+enum ObjectCommandType {
+    OBJECT_COMMAND_ADD, /*!< addObject(object) */
+    OBJECT_COMMAND_DESTROY, /*!< destroyObject(id) */
+    OBJECT_COMMAND_ACTIVATE, /*!< activateObject(id) */
+    OBJECT_COMMAND_DEACTIVATE, /*!< deactivateObject(id) */
+    OBJECT_COMMAND_MAKE_CLICKABLE, /*!< makeClickable(id) */
+    OBJECT_COMMAND_MAKE_NON_CLICKABLE, /*!< makeNonClickable(id) */
+    OBJECT_COMMAND_ATTACH, /*!< attachChild(parentId, id) */
+    OBJECT_COMMAND_DETACH, /*!< detachChild(id) */
+    OBJECT_COMMAND_SET_POSITION /*!< setPosition(x, y) of the object id */
+};
+
+/**
+ * @struct ObjectCommand
+ * @brief A mutation recorded to be applied later by ObjectManager::applyCommands()
+ */
+struct ObjectCommand {
+    ObjectCommandType type = OBJECT_COMMAND_ACTIVATE; /*!< Mutation */
+    std::string id; /*!< Object it applies to */
+    std::string parentId; /*!< Parent, for OBJECT_COMMAND_ATTACH */
+    Object* object = nullptr; /*!< Object to add, for OBJECT_COMMAND_ADD */
+    float x = 0.0f; /*!< Position, for OBJECT_COMMAND_SET_POSITION */
+    float y = 0.0f; /*!< Position, for OBJECT_COMMAND_SET_POSITION */
+};
 
 /**
  * @class ObjectManager
  * @brief Manages the creation, destruction, and interaction of objects in the game.
+ *
+ * The manager is not thread-safe and its lists must not change while they are iterated. Code running in the
+ * callbacks of the objects or in other threads records its mutations with defer(), they are applied by
+ * applyCommands() at the start of Game::update().
  */
 class ObjectManager{
 
@@ -32,7 +75,15 @@ class ObjectManager{
         std::vector<Object*> activeObjects; /*!< List of active objects*/
         std::vector<Object*> clickActiveObjects; /*< List of active and clickable objects*/
 
-        std::vector<Text*> textObjects; /*< List of text objects*/
+        std::vector<Object*> rootObjects; /*< Objects without a parent, in the order they were added*/
+
+        std::vector<Object*> spriteBatch; /*< Visible sprites in drawing order (parents before children)*/
+        std::vector<size_t> spriteSubtreeEnd; /*< Index of spriteBatch after the sprites of the subtree of every sprite*/
+        std::vector<Text*> textBatch; /*< Visible texts in drawing order*/
+        std::vector<SDL_Rect> damagedRects; /*< Screen areas left behind by destroyed objects, consumed by the renderer*/
+        std::vector<Object*> hoveredObjects; /*< Object under the mouse and its ancestors, innermost first*/
+        AnimationSystem animations; /*< Sprite-sheet animations playing on the objects*/
+        OverdrawMap* overdraw = nullptr; /*< Counts the pixels written by the draws when set (debug heatmap)*/
 
         ObjectManager() = default;
 
@@ -47,15 +98,46 @@ class ObjectManager{
         void makeClickable(const std::string& id);
         void makeNonClickable(const std::string& id);
 
+        int attachChild(const std::string& parentId, const std::string& childId);
+        int detachChild(const std::string& childId);
+        void updateTransforms();
+
         void destroyAllObjects();
 
-        void drawActiveObjects(TextureManager& textureManager);
+        void drawActiveObjects(TextureManager& textureManager, const SDL_Rect* region = nullptr);
+        Object* hitTest(int x, int y, bool clickableOnly = true);
 
         int handleMouseRelease(SDL_Event& e);
         int handleMouseClick(SDL_Event& e);
         int handleMouseOver(SDL_Event& e);
-
-        void drawAllTexts(SDL_Renderer** rendererPtr);
+        void queueMouseMotion(const SDL_Event& e);
+        void mouseLeft();
+        void updateHover();
+
+        void drawAllTexts(RenderBackend* backend, const SDL_Rect* region = nullptr);
+
+        void defer(const ObjectCommand& command);
+        void defer(ObjectCommandType type, const std::string& id);
+        void deferAdd(Object* object);
+        void deferAttach(const std::string& parentId, const std::string& childId);
+        void deferSetPosition(const std::string& id, float x, float y);
+        int applyCommands();
+
+    private:
+        MpscQueue<ObjectCommand> commands; /*< Deferred mutations, pushed from any thread and applied by the main thread*/
+
+        bool hasMouse = false; /*< Whether the mouse is inside the window*/
+        int mouseX = 0; /*< Last known mouse position*/
+        int mouseY = 0;
+        bool hoverDirty = false; /*< Whether the mouse moved or the objects changed since the last hover update*/
+        std::vector<Object*> nextHovered; /*< Scratch list of updateHover()*/
+        bool drawBatchesDirty = true; /*< Whether objects were added, removed, activated or reparented since the batches were built*/
+
+        void updateSubtree(Object* obj, float parentX, float parentY, bool force);
+        void rebuildDrawBatches();
+        void collectDrawBatches(Object* obj);
+        Object* hitTestSubtree(Object* obj, int x, int y, bool clickableOnly);
+        void removeFromParent(Object* obj);
 };
 
 /**
@@ -66,12 +148,29 @@ class Object {
     public:
         std::string id; /*!< ID of the object */
         bool isActive = true; /*!< Whether the project must be draw on the screen*/
-        float x; /*!< X coordinate of the object */
-        float y; /*!< X and Y coordinates of the object */
+        float x; /*!< X coordinate of the object, relative to its parent */
+        float y; /*!< Y coordinate of the object, relative to its parent */
         float width; /*!< Width of the object */
         float height; /*!< Height of the object */
         std::string textureId; /*!< ID of the texture associated with this object */
+        RenderState renderState; /*!< Tint, alpha, flip and rotation the object is drawn with */
+        SDL_Rect frameClip = {0, 0, 0, 0}; /*!< Area of the texture shown (a frame of a sprite sheet), the whole texture when empty */
+        SDL_Rect clipRect = {0, 0, 0, 0}; /*!< Area of the screen the object is cut to (a scrolling list), none when empty */
+        int animation = -1; /*!< Animation playing on the object in the AnimationSystem, -1 if none */
+        ObjectKind kind = OBJECT_SPRITE; /*!< How the object is drawn */
         bool isClickable; /*! Whether the object can be clicked by the player an execute an action*/
+        bool isDirty = true; /*!< Whether the object changed since it was last drawn */
+        bool wasDrawn = false; /*!< Whether the object was visible the last time it was drawn */
+        SDL_Rect lastDrawnRect = {0, 0, 0, 0}; /*!< Screen area the object covered the last time it was drawn */
+        bool hasDirtyChildren = false; /*!< Whether some descendant is dirty */
+
+        Object* parent = nullptr; /*!< Parent object, its position is the origin of this object's coordinates */
+        std::vector<Object*> children; /*!< Children of the object, drawn after (on top of) it */
+        float worldX; /*!< Cached X coordinate on the screen */
+        float worldY; /*!< Cached Y coordinate on the screen */
+        SDL_Rect subtreeBounds = {0, 0, 0, 0}; /*!< Cached screen area covered by the object and all its descendants */
+        bool transformDirty = true; /*!< Whether the cached world position must be recomputed */
+        bool hasDirtyTransforms = false; /*!< Whether some descendant must recompute its world position */
 
         /**
          * @brief Construct a new Object object
@@ -89,6 +188,8 @@ class Object {
             this->isActive = false;
             this->x = x;
             this->y = y;
+            this->worldX = x;
+            this->worldY = y;
             this->width = width;
             this->height = height;
             this->textureId = textureId;
@@ -102,6 +203,13 @@ class Object {
         void move(float dx, float dy);
         void resize(float newWidth, float newHeight);
         int changeTexture(const std::string& newTextureId, TextureManager& textureManager);
+        void markDirty();
+        void markSubtreeDirty();
+        void markTransformDirty();
+        void setRenderState(const RenderState& state);
+        SDL_Rect getRect() const;
+        SDL_Rect getDrawnRect() const;
+        bool isVisible() const;
 
         bool isMouseOver(int mouseX, int mouseY);
 
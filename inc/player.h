@@ -11,6 +11,13 @@
 #define PLAYER_H
 
 #include "config.h"
+#include "modifiers.h"
+#include <cmath>
+
+/**
+ * Name of the points per click stat
+ */
+#define STAT_MULTIPLIER "multiplier"
 
 /**
  * @class Player
@@ -19,15 +26,19 @@
 class Player {
     private:
         int points; /*!< Points of the player*/
-        int multiplier; /*!< Multiplier for every click*/
+        int multiplierStat; /*!< ID of the multiplier stat in the modifiers*/
         int pointsPerSecond; /*!< Points per second the player gets*/
 
     public:
+        ModifierStack modifiers; /*!< Stats of the player and the upgrades applied to them*/
+
         /**
          * @brief Construct a new Player object
          * 
          */
-        Player() : points(0), multiplier(1) {}
+        Player() : points(0) {
+            multiplierStat = modifiers.addStat(STAT_MULTIPLIER, 1);
+        }
     
         /**
          * @brief Adds points to the player
@@ -48,12 +59,13 @@ class Player {
         }
 
         /**
-         * @brief Get the multiplier of the player
+         * @brief Get the multiplier of the player, with all its modifiers. It is cached until the modifiers change
          * 
          * @return int Multiplier of the player
          */
         int getMultiplier(){
-            return multiplier;
+            // the epsilon keeps results like 2.9999999 from truncating to 2
+            return static_cast<int>(std::floor(modifiers.getValue(multiplierStat) + 1e-9));
         }
 
         /**
@@ -62,7 +74,7 @@ class Player {
          * @param m Amount to add to the multiplier
          */
         void addMultiplier(int m) {
-            multiplier += m;
+            modifiers.addModifier(multiplierStat, MODIFIER_ADD, m, "player");
         }
 };
 
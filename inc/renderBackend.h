@@ -0,0 +1,197 @@
+/**
+ * @file renderBackend.h
+ * @author Iván
+ * @brief Interface between the drawing code and the renderer that puts pixels on the screen
+ * @version 0.1
+ * @date 2025-08-03
+ *
+ * The texture manager, texts and the dirty-rect renderer only draw through a RenderBackend, so the game can
+ * run on the SDL renderer (SdlRenderBackend) or on its own CPU rasterizer (CpuRenderBackend) for hosts
+ * without a GPU. Coordinates are logical units, backends scale them to pixels.
+ */
+#ifndef RENDER_BACKEND_H
+#define RENDER_BACKEND_H
+
+#include "config.h"
+#include <cmath>
+
+/**
+ * @brief How the pixels of a texture are combined with the target
+ */
+enum RenderBlend {
+    RENDER_BLEND_NONE, /*!< Pixels overwrite the target, alpha included */
+    RENDER_BLEND_ALPHA /*!< Pixels are blended over the target by their alpha */
+};
+
+/**
+ * @brief How a texture is sampled when it is drawn scaled
+ */
+enum RenderFilter {
+    RENDER_FILTER_NEAREST, /*!< Nearest pixel */
+    RENDER_FILTER_LINEAR /*!< Bilinear interpolation */
+};
+
+/**
+ * @brief Mirroring of a draw, the values can be combined
+ */
+enum RenderFlip {
+    RENDER_FLIP_NONE = 0, /*!< Not mirrored */
+    RENDER_FLIP_HORIZONTAL = 1, /*!< Mirrored left to right */
+    RENDER_FLIP_VERTICAL = 2 /*!< Mirrored top to bottom */
+};
+
+/**
+ * @struct RenderState
+ * @brief How a single draw is modulated and transformed, without changing the texture
+ */
+struct RenderState {
+    SDL_Color tint = {255, 255, 255, 255}; /*!< Color multiplied with the texture, tint.a multiplies its alpha */
+    int flip = RENDER_FLIP_NONE; /*!< Mirroring, RenderFlip values */
+    float angle = 0.0f; /*!< Rotation in degrees, clockwise around the center of the destination */
+
+    /**
+     * @brief Checks if the state leaves the draw untouched, so it can use a plain copy
+     *
+     * @return true
+     * @return false
+     */
+    bool isDefault() const {
+        return tint.r == 255 && tint.g == 255 && tint.b == 255 && tint.a == 255 && flip == RENDER_FLIP_NONE && angle == 0.0f;
+    }
+};
+
+/**
+ * @brief Area covered by a rectangle rotated around its center
+ *
+ * @param rect
+ * @param angle Degrees, clockwise
+ * @return SDL_Rect Bounding box of the rotated rectangle, rect itself when it is not rotated
+ */
+inline SDL_Rect rotatedBounds(const SDL_Rect& rect, float angle){
+    if(angle == 0.0f) {
+        return rect;
+    }
+    float radians = angle * static_cast<float>(M_PI) / 180.0f;
+    float c = std::fabs(std::cos(radians));
+    float s = std::fabs(std::sin(radians));
+    float width = rect.w * c + rect.h * s;
+    float height = rect.w * s + rect.h * c;
+    float centerX = rect.x + rect.w * 0.5f;
+    float centerY = rect.y + rect.h * 0.5f;
+    int x0 = static_cast<int>(std::floor(centerX - width * 0.5f));
+    int y0 = static_cast<int>(std::floor(centerY - height * 0.5f));
+    int x1 = static_cast<int>(std::ceil(centerX + width * 0.5f));
+    int y1 = static_cast<int>(std::ceil(centerY + height * 0.5f));
+    return {x0, y0, x1 - x0, y1 - y0};
+}
+
+/**
+ * @class RenderTexture
+ * @brief A texture of a backend. Each backend extends it with its own data
+ */
+class RenderTexture {
+    public:
+        int width = 0; /*!< Width in pixels */
+        int height = 0; /*!< Height in pixels */
+        Uint32 format = SDL_PIXELFORMAT_ARGB8888; /*!< Pixel format of the data uploaded to it */
+        bool target = false; /*!< Whether it can be drawn into */
+        RenderBlend blend = RENDER_BLEND_ALPHA; /*!< Blending when it is drawn */
+        RenderFilter filter = RENDER_FILTER_NEAREST; /*!< Sampling when it is drawn scaled */
+
+        virtual ~RenderTexture() = default;
+};
+
+/**
+ * @struct RenderCounters
+ * @brief Work sent to a backend since the counters were reset
+ */
+struct RenderCounters {
+    unsigned long long draws = 0; /*!< Textures drawn */
+    unsigned long long textureSwitches = 0; /*!< Draws with a different texture than the draw before them */
+    unsigned long long fills = 0; /*!< Rectangles filled and clears */
+};
+
+/**
+ * @class RenderBackend
+ * @brief Draws textures and rectangles into the screen or into target textures
+ *
+ * The state works like the SDL renderer: draws go to the current target, clipped to the clip rectangle and
+ * scaled by the scale. Setting a target resets the scale to 1 and removes the clip; setting the screen back
+ * restores the logical resolution scaling.
+ */
+class RenderBackend {
+    protected:
+        RenderCounters counters; /*!< Work since the last resetCounters() */
+        const RenderTexture* lastTexture = nullptr; /*!< Texture of the last draw, to count switches */
+
+        /**
+         * @brief Counts a draw of a texture
+         *
+         * @param texture
+         */
+        void countDraw(const RenderTexture* texture) {
+            counters.draws++;
+            if(texture != lastTexture) {
+                counters.textureSwitches++;
+                lastTexture = texture;
+            }
+        }
+
+    public:
+        virtual ~RenderBackend() = default;
+
+        /**
+         * @brief Name of the backend, for logs
+         *
+         * @return const char*
+         */
+        virtual const char* getName() const = 0;
+
+        virtual RenderTexture* createTexture(int width, int height, bool target, Uint32 format = SDL_PIXELFORMAT_ARGB8888) = 0;
+        virtual RenderTexture* createTextureFromSurface(SDL_Surface* surface) = 0;
+        virtual int updateTexture(RenderTexture* texture, const SDL_Rect* rect, const void* pixels, int pitch) = 0;
+        virtual void destroyTexture(RenderTexture* texture) = 0;
+        virtual void setTextureBlend(RenderTexture* texture, RenderBlend blend) = 0;
+        virtual void setTextureFilter(RenderTexture* texture, RenderFilter filter) = 0;
+
+        virtual bool supportsTargets() const = 0;
+        virtual int setTarget(RenderTexture* target) = 0;
+        virtual RenderTexture* getTarget() const = 0;
+        virtual void setScale(float scaleX, float scaleY) = 0;
+        virtual void getScale(float* scaleX, float* scaleY) const = 0;
+        virtual void setClip(const SDL_Rect* clip) = 0;
+        virtual bool getClip(SDL_Rect* clip) const = 0;
+
+        virtual void clear(SDL_Color color) = 0;
+        virtual void fillRect(const SDL_Rect* rect, SDL_Color color) = 0;
+        virtual void copy(RenderTexture* texture, const SDL_Rect* src, const SDL_Rect* dst) = 0;
+        virtual void copyEx(RenderTexture* texture, const SDL_Rect* src, const SDL_Rect* dst, const RenderState& state) = 0;
+        virtual void present() = 0;
+
+        /**
+         * @brief Handles window events that change the output (e.g. a resize) and maps mouse coordinates to logical units if the backend scales the screen itself. Call it before anything else uses the event
+         *
+         * @param e
+         */
+        virtual void handleEvent(SDL_Event& e) { (void)e; }
+
+        /**
+         * @brief Work sent to the backend since the counters were reset
+         *
+         * @return const RenderCounters&
+         */
+        const RenderCounters& getCounters() const {
+            return counters;
+        }
+
+        /**
+         * @brief Resets the counters, e.g. at the start of every frame
+         *
+         */
+        void resetCounters() {
+            counters = RenderCounters();
+            lastTexture = nullptr;
+        }
+};
+
+#endif
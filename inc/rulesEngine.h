@@ -0,0 +1,114 @@
+/**
+ * @file rulesEngine.h
+ * @author Iván
+ * @brief Achievements and unlock conditions over numeric stats
+ * @version 0.1
+ * @date 2025-08-01
+ *
+ *
+ */
+#ifndef RULES_ENGINE_H
+#define RULES_ENGINE_H
+
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @class RulesEngine
+ * @brief Evaluates conditions like "points >= 1000" or "item X at level >= 3", combined with all/any, and
+ * fires rules the first time their condition holds.
+ *
+ * Threshold conditions are indexed per stat in a sorted list, so a stat change only visits the thresholds
+ * between the old and the new value. Compound conditions keep how many of their children hold and are updated
+ * only when a child changes. The cost of a change depends on the conditions it flips, not on how many exist.
+ */
+class RulesEngine {
+    private:
+        /**
+         * @brief Type of a condition node
+         */
+        enum NodeType {
+            NODE_THRESHOLD, /*!< stat >= threshold */
+            NODE_ALL, /*!< Every child holds */
+            NODE_ANY /*!< At least one child holds */
+        };
+
+        /**
+         * @brief A condition
+         */
+        struct Node {
+            NodeType type; /*!< Type of the condition */
+            bool satisfied = false; /*!< Whether the condition holds */
+            int childCount = 0; /*!< Children of a compound condition */
+            int satisfiedChildren = 0; /*!< Children that hold */
+            std::vector<int> parents; /*!< Compound conditions this one is part of */
+            std::vector<int> rules; /*!< Rules fired by this condition */
+        };
+
+        /**
+         * @brief A numeric stat and the thresholds conditions use on it
+         */
+        struct Stat {
+            std::string name; /*!< Name of the stat */
+            double value; /*!< Current value */
+            std::vector<std::pair<double, int>> thresholds; /*!< Threshold and condition, sorted by threshold */
+        };
+
+        /**
+         * @brief An achievement or unlock
+         */
+        struct Rule {
+            std::string name; /*!< Name of the rule */
+            int node; /*!< Condition of the rule */
+            std::function<void()> onSatisfied; /*!< Called once, the first time the condition holds */
+            bool fired = false; /*!< Whether it was already fired */
+        };
+
+        std::vector<Stat> stats; /*!< Stats by ID */
+        std::map<std::string, int> statIds; /*!< ID of every stat by name */
+        std::vector<Node> nodes; /*!< Conditions by ID */
+        std::vector<Rule> rules; /*!< Rules by ID */
+        std::vector<int> firedRules; /*!< Rules fired during the running change, called once it is done */
+        unsigned long long evaluations = 0; /*!< Conditions that changed state */
+
+        void setNodeState(int node, bool satisfied);
+        int addCompound(NodeType type, const std::vector<int>& children);
+        void runFiredRules();
+
+    public:
+        int addStat(const std::string& name, double value = 0.0);
+        int findStat(const std::string& name) const;
+        void setStat(int stat, double value);
+
+        /**
+         * @brief Gets the value of a stat
+         *
+         * @param stat
+         * @return double
+         */
+        double getStat(int stat) const {
+            return stats[stat].value;
+        }
+
+        int addThreshold(int stat, double threshold);
+        int addAll(const std::vector<int>& children);
+        int addAny(const std::vector<int>& children);
+        int addRule(const std::string& name, int condition, std::function<void()> onSatisfied);
+
+        bool isSatisfied(int condition) const;
+        bool hasFired(const std::string& name) const;
+
+        /**
+         * @brief Gets how many times a condition changed state
+         *
+         * @return unsigned long long
+         */
+        unsigned long long getEvaluations() const {
+            return evaluations;
+        }
+};
+
+#endif
@@ -0,0 +1,255 @@
+/**
+ * @file scheduler.h
+ * @author Iván
+ * @brief Cooperative scheduler of coroutine sequences driven by the game clock
+ * @version 0.1
+ * @date 2025-08-03
+ *
+ *
+ */
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "config.h"
+#include "timingWheel.h"
+#include <coroutine>
+#include <cstddef>
+#include <functional>
+#include <memory_resource>
+#include <vector>
+
+#define SEQUENCE_FRAME_POOL_MAX 1024 /*!< Biggest coroutine frame served by the pool, bigger ones come from the heap */
+
+class Scheduler;
+
+/**
+ * ID of a started sequence, 0 is never a valid ID
+ */
+typedef Uint64 SequenceId;
+
+/**
+ * @class Sequence
+ * @brief A timed game sequence: a coroutine that suspends with co_await nextTick(), delay(ms) or waitUntil(condition)
+ * and is resumed by the scheduler that started it. Calling the coroutine only creates it, it runs once started:
+ *
+ *     Sequence doubleForAWhile(Player* player){
+ *         int id = player->modifiers.addModifier(stat, MODIFIER_MULTIPLY, 2.0, "buff");
+ *         co_await delay(30000);
+ *         player->modifiers.removeModifier(id);
+ *     }
+ *
+ *     scheduler.start(doubleForAWhile(&player));
+ *
+ * The frames of the coroutines come from coroutineFramePool(), so starting and finishing sequences does not touch
+ * the heap in steady state.
+ */
+class Sequence {
+    public:
+        /**
+         * @brief Promise of the coroutine, it knows the scheduler and the slot that run it
+         */
+        struct promise_type {
+            Scheduler* scheduler = nullptr; /*!< Scheduler of the sequence, set when it is started */
+            int slot = -1; /*!< Slot of the sequence in the scheduler */
+
+            Sequence get_return_object() {
+                return Sequence(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            // created suspended, it runs when started. It stays suspended at the end so the scheduler destroys it
+            std::suspend_always initial_suspend() noexcept {
+                return {};
+            }
+
+            std::suspend_always final_suspend() noexcept {
+                return {};
+            }
+
+            void return_void() {
+            }
+
+            void unhandled_exception();
+
+            static void* operator new(size_t size);
+            static void operator delete(void* ptr, size_t size);
+        };
+
+        typedef std::coroutine_handle<promise_type> Handle;
+
+    private:
+        Handle handle; /*!< Coroutine, owned until the sequence is started */
+
+        explicit Sequence(Handle handle) : handle(handle) {
+        }
+
+        friend class Scheduler;
+
+    public:
+        Sequence(Sequence&& other) noexcept : handle(other.handle) {
+            other.handle = nullptr;
+        }
+        Sequence& operator=(Sequence&& other) noexcept;
+        Sequence(const Sequence&) = delete;
+        Sequence& operator=(const Sequence&) = delete;
+        ~Sequence();
+};
+
+/**
+ * @brief Awaitable that resumes the sequence on the next update of the scheduler
+ */
+struct NextTickAwaiter {
+    bool await_ready() const noexcept {
+        return false;
+    }
+    void await_suspend(Sequence::Handle handle);
+    void await_resume() const noexcept {
+    }
+};
+
+/**
+ * @brief Awaitable that resumes the sequence when the clock of the scheduler reaches a time
+ */
+struct DelayAwaiter {
+    Uint32 milliseconds; /*!< Time to wait, 0 waits for the next update */
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+    void await_suspend(Sequence::Handle handle);
+    void await_resume() const noexcept {
+    }
+};
+
+/**
+ * @brief Awaitable that resumes the sequence once a condition is true
+ */
+struct WaitUntilAwaiter {
+    std::function<bool()> condition; /*!< Condition waited for */
+    Uint32 interval; /*!< Milliseconds between checks, 0 checks it on every update */
+
+    bool await_ready() const {
+        return condition();
+    }
+    void await_suspend(Sequence::Handle handle);
+    void await_resume() const noexcept {
+    }
+};
+
+/**
+ * @brief Suspends the sequence until the next update
+ *
+ * @return NextTickAwaiter
+ */
+inline NextTickAwaiter nextTick(){
+    return NextTickAwaiter{};
+}
+
+/**
+ * @brief Suspends the sequence for a time of the game clock
+ *
+ * @param milliseconds
+ * @return DelayAwaiter
+ */
+inline DelayAwaiter delay(Uint32 milliseconds){
+    return DelayAwaiter{milliseconds};
+}
+
+/**
+ * @brief Suspends the sequence until a condition is true. It is not suspended at all if it already is
+ *
+ * @param condition
+ * @param interval Milliseconds between checks. 0 checks it on every update, which costs a call per update for as
+ * long as the sequence waits: conditions that can be checked less often should say so
+ * @return WaitUntilAwaiter
+ */
+inline WaitUntilAwaiter waitUntil(std::function<bool()> condition, Uint32 interval = 0){
+    return WaitUntilAwaiter{std::move(condition), interval};
+}
+
+/**
+ * @class Scheduler
+ * @brief Runs sequences cooperatively on the game clock. update() is called once per game update with the time of
+ * the frame, so a replay wakes the same sequences in the same frames as the recorded game.
+ *
+ * Sequences waiting for a time are timers of a timing wheel, an update only touches the ones that are due: thousands
+ * of suspended sequences cost nothing until they wake. Sequences waiting for the next tick or polling a condition on
+ * every update are the only ones touched by every update.
+ *
+ * Sequences run on the thread that calls update(), as do their frame allocations.
+ */
+class Scheduler {
+    private:
+        /**
+         * @brief A started sequence
+         */
+        struct Slot {
+            Sequence::Handle handle; /*!< Coroutine, nullptr if the slot is free */
+            unsigned int generation = 1; /*!< Incremented when the slot is freed, so stale wakeups are ignored */
+            std::function<bool()> condition; /*!< Condition it waits for, if any */
+            Uint32 interval = 0; /*!< Milliseconds between checks of the condition */
+            bool resuming = false; /*!< Whether the sequence is running now */
+            bool cancelled = false; /*!< Whether it was cancelled while running, it is destroyed when it suspends */
+            TimerId timer = 0; /*!< Timer that wakes it, if it waits for a time */
+        };
+
+        /**
+         * @brief A reference to a slot that becomes stale when the sequence in it ends
+         */
+        struct Waiter {
+            int slot; /*!< Slot of the sequence */
+            unsigned int generation; /*!< Generation of the slot when it started waiting */
+        };
+
+        std::vector<Slot> slots; /*!< Started sequences */
+        std::vector<int> freeSlots; /*!< Free slots, reused before adding new ones */
+        std::vector<Waiter> ticking; /*!< Sequences resumed on the next update */
+        std::vector<Waiter> resuming; /*!< Sequences resumed by this update, swapped with ticking */
+        std::vector<Waiter> polling; /*!< Sequences checking a condition on every update */
+        TimingWheel timers; /*!< Timers of the sequences waiting for a time */
+        Uint32 now = 0; /*!< Time of the current update */
+        int activeCount = 0; /*!< Started sequences that did not end */
+
+        bool isValid(const Waiter& waiter) const;
+        void resume(const Waiter& waiter);
+        bool checkCondition(int slot);
+        void release(int slot);
+        void addTimer(int slot, Uint32 delay);
+        void wake(const Waiter& waiter);
+
+        friend struct NextTickAwaiter;
+        friend struct DelayAwaiter;
+        friend struct WaitUntilAwaiter;
+
+    public:
+        Scheduler() = default;
+        ~Scheduler();
+        Scheduler(const Scheduler&) = delete;
+        Scheduler& operator=(const Scheduler&) = delete;
+
+        SequenceId start(Sequence sequence);
+        int cancel(SequenceId id);
+        void update(Uint32 milliseconds);
+        void clear();
+
+        /**
+         * @brief Time of the last update
+         *
+         * @return Uint32
+         */
+        Uint32 getTime() const {
+            return now;
+        }
+
+        /**
+         * @brief Sequences started that did not end
+         *
+         * @return int
+         */
+        int getActiveCount() const {
+            return activeCount;
+        }
+};
+
+std::pmr::memory_resource& coroutineFramePool();
+
+#endif
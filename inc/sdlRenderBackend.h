@@ -0,0 +1,69 @@
+/**
+ * @file sdlRenderBackend.h
+ * @author Iván
+ * @brief Render backend on top of the SDL renderer
+ * @version 0.1
+ * @date 2025-08-03
+ *
+ *
+ */
+#ifndef SDL_RENDER_BACKEND_H
+#define SDL_RENDER_BACKEND_H
+
+#include "renderBackend.h"
+
+/**
+ * @class SdlTexture
+ * @brief Texture of the SDL backend
+ */
+class SdlTexture : public RenderTexture {
+    public:
+        SDL_Texture* texture = nullptr; /*!< SDL texture */
+};
+
+/**
+ * @class SdlRenderBackend
+ * @brief Forwards every call to an SDL renderer. The logical size of the renderer is set by init_SDL
+ */
+class SdlRenderBackend : public RenderBackend {
+    private:
+        SDL_Renderer* renderer; /*!< SDL renderer */
+        RenderTexture* target = nullptr; /*!< Current target, nullptr for the screen */
+
+        void setDrawColor(SDL_Color color);
+
+    public:
+        SdlRenderBackend(SDL_Renderer* renderer);
+
+        /**
+         * @brief Name of the backend, for logs
+         *
+         * @return const char*
+         */
+        const char* getName() const override {
+            return "sdl";
+        }
+
+        RenderTexture* createTexture(int width, int height, bool target, Uint32 format = SDL_PIXELFORMAT_ARGB8888) override;
+        RenderTexture* createTextureFromSurface(SDL_Surface* surface) override;
+        int updateTexture(RenderTexture* texture, const SDL_Rect* rect, const void* pixels, int pitch) override;
+        void destroyTexture(RenderTexture* texture) override;
+        void setTextureBlend(RenderTexture* texture, RenderBlend blend) override;
+        void setTextureFilter(RenderTexture* texture, RenderFilter filter) override;
+
+        bool supportsTargets() const override;
+        int setTarget(RenderTexture* target) override;
+        RenderTexture* getTarget() const override;
+        void setScale(float scaleX, float scaleY) override;
+        void getScale(float* scaleX, float* scaleY) const override;
+        void setClip(const SDL_Rect* clip) override;
+        bool getClip(SDL_Rect* clip) const override;
+
+        void clear(SDL_Color color) override;
+        void fillRect(const SDL_Rect* rect, SDL_Color color) override;
+        void copy(RenderTexture* texture, const SDL_Rect* src, const SDL_Rect* dst) override;
+        void copyEx(RenderTexture* texture, const SDL_Rect* src, const SDL_Rect* dst, const RenderState& state) override;
+        void present() override;
+};
+
+#endif
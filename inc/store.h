@@ -12,63 +12,176 @@
 
 #include <functional>
 #include <cmath>
+#include <random>
 #include "objects.h"
 #include "player.h"
+#include "scheduler.h"
 
 class Store;
 
+/**
+ * Highest cost an item can reach, so the cost growth cannot overflow the points
+ */
+#define ITEM_MAX_COST 1000000000
+
+/**
+ * Default exponent of the cost growth: cost * pow(cost, level * ITEM_COST_GROWTH)
+ */
+#define ITEM_COST_GROWTH 0.5f
+
+/**
+ * Color multiplier of an item the player cannot afford (out of 255)
+ */
+#define ITEM_DISABLED_SHADE 110
+
+/**
+ * Alpha of an item the player cannot afford (out of 255)
+ */
+#define ITEM_DISABLED_ALPHA 200
+
+/**
+ * Items offered by randomizeAvailableItems() by default
+ */
+#define STORE_OFFER_COUNT 3
+
+/**
+ * Scrolling list of the store, relative to the store: position, height, height of a row and size of the item sprite
+ */
+#define STORE_LIST_X 70
+#define STORE_LIST_Y 130
+#define STORE_LIST_HEIGHT 260
+#define STORE_ROW_HEIGHT 85
+#define STORE_ROW_SIZE 80
+
+/**
+ * Rows in the pool: enough to cover the list with a row cut at both ends
+ */
+#define STORE_ROW_POOL (STORE_LIST_HEIGHT / STORE_ROW_HEIGHT + 2)
+
+/**
+ * Pixels scrolled by a notch of the mouse wheel
+ */
+#define STORE_SCROLL_STEP 60.0f
+
+/**
+ * Fraction of the scroll speed kept from one frame to the next, and speed (pixels per frame) it stops under
+ */
+#define STORE_SCROLL_FRICTION 0.85f
+#define STORE_SCROLL_MIN_SPEED 0.25f
+
+/**
+ * Milliseconds of game time between automatic refreshes of the offer
+ */
+#define STORE_REFRESH_INTERVAL (5 * 60 * 1000)
+
+/**
+ * @struct ItemEffect
+ * @brief Modifier added to a stat of the player every time an item is bought, for good or for a while
+ */
+struct ItemEffect {
+    std::string stat = STAT_MULTIPLIER; /*!< Stat the modifier applies to */
+    ModifierType type = MODIFIER_ADD; /*!< How it changes the stat */
+    double amount = 0.0; /*!< Amount of every purchase */
+    int priority = 0; /*!< Order of the modifier */
+    Uint32 duration = 0; /*!< Milliseconds of game time the modifier lasts, 0 (or a store without scheduler) for permanent */
+};
+
 /**
  * @class Item
- * @brief Represents an item in the store that can be purchased by the player
+ * @brief An item of the store catalog that can be purchased by the player. Items are not objects, the store shows
+ * the available ones through a pool of rows, so the catalog can be as big as needed
  */
-class Item : public Object {
+class Item {
 public:
+    std::string id; /*!< ID of the item */
+    std::string textureId; /*!< Texture shown in its row */
     Player* playerPtr = nullptr; /*!< Pointer to the player */
     Store* store = nullptr; /*!< Pointer to the store */
     int cost; /*!< Cost of the item */
     std::string description; /*!< Description of the item */
-    std::function<void(Player*)> onPurchase; /*!< Function to call when the item is purchased */
+    std::function<void(Player*)> onPurchase; /*!< Function to call when the item is purchased (optional) */
+    std::vector<ItemEffect> effects; /*!< Modifiers added to the player when the item is purchased, the item ID is their source */
     float prob; /*!< Probability of the item appearing in the store */
     int level; /*!< Level of the item */
+    float costGrowth = ITEM_COST_GROWTH; /*!< Exponent of the cost growth per level */
+    bool unlocked = true; /*!< Whether the store may offer the item, locked items wait for an unlock rule */
+    bool available = false; /*!< Whether the store offers the item now */
 
     Item(std::string id, std::string textureId, int cost, std::string description, std::function<void(Player*)> onPurchase, float prob, Store* store, Player* player);
+    Item(std::string id, std::string textureId, int cost, std::string description, ItemEffect effect, float prob, Store* store, Player* player);
 
+    int nextCost() const;
+    bool purchase();
+};
+
+/**
+ * @class StoreRow
+ * @brief A row of the store list showing an available item. The store keeps a few of them and binds them to the
+ * items scrolled into view, so only the visible items are objects
+ */
+class StoreRow : public Object {
+public:
+    Store* store = nullptr; /*!< Store of the row */
+    Item* item = nullptr; /*!< Item shown, nullptr while the row is hidden */
+    bool disabled = false; /*!< Whether the player cannot afford the item, it is drawn darkened and faded */
+
+    StoreRow(const std::string& id, Store* store);
+
+    void bind(Item* item);
+    void setDisabled(bool disabled);
     void onClick() override;
     void onRelease() override;
+    void onMouseOver() override;
+    void onMouseOut() override;
 };
 
 /**
  * @class Store
  * @brief Represents the store where items can be purchased. It manages the items
+ *
+ * The available items are shown in a list clipped to the store panel and scrolled with the mouse wheel. The
+ * list is virtualized: a pool of STORE_ROW_POOL rows is bound to the items in view, a row that scrolls out at one
+ * end is reused at the other. A frame costs the same with three items as with thousands.
  */
 class Store : public Object {
 public:
     ObjectManager* objManager = nullptr; /*!< Pointer to the object manager */
     std::map<std::string, Item*> items; /*!< Map of all items in the store */
-    std::vector<Item*> availableItems; /*!< List of available items in the store */
-
-    /**
-     * @brief Construct a new Store object
-     * 
-     * @param x 
-     * @param y 
-     * @param width 
-     * @param height 
-     * @param textureId 
-     * @param objManager 
-     */
-    Store(float x, float y, float width, float height, std::string textureId, ObjectManager* objManager)
-        : Object("Store", x, y, width, height, textureId), objManager(objManager) {
-        objManager->addObject(this);
-    }
+    std::vector<Item*> catalog; /*!< All items, in the order they were added */
+    std::vector<Item*> availableItems; /*!< List of available items in the store, in the order they are listed */
+    int offerCount = STORE_OFFER_COUNT; /*!< Items offered by randomizeAvailableItems(), 0 to list every unlocked item */
+    std::mt19937 rng; /*!< Random generator of the store, seeded so a recorded game can be replayed */
+    Item* hoveredItem = nullptr; /*!< Item under the mouse, its tooltip is shown */
+    StoreRow* hoveredRow = nullptr; /*!< Row of the hovered item */
+
+    std::vector<StoreRow*> rows; /*!< Pool of rows, registered in the object manager and destroyed with the store */
+    float scrollOffset = 0.0f; /*!< Pixels the list is scrolled down */
+    float scrollSpeed = 0.0f; /*!< Pixels the list scrolls in the next frame */
+    bool rowsDirty = true; /*!< Whether the rows must be bound again (the available items changed) */
+    Scheduler* scheduler = nullptr; /*!< Removes the modifiers of timed effects when they run out (optional) */
+
+    Store(float x, float y, float width, float height, std::string textureId, ObjectManager* objManager);
+    ~Store();
+    Store(const Store&) = delete;
+    Store& operator=(const Store&) = delete;
 
     void addItem(Item* item);
     void removeItem(const std::string& id);
     Item* getItemById(const std::string& id);
     void makeItemAvailable(const std::string& id);
     void makeItemUnavailable(const std::string& id);
+    void setSeed(unsigned int seed);
     void randomizeAvailableItems();
     void updateStore(Player* player);
+
+    void scroll(float pixels);
+    void updateScroll();
+    SDL_Rect getListRect() const;
+
+private:
+    std::string getRowId(int index) const;
+    float getMaxScroll() const;
+    void layoutRows();
 };
 
 #endif
\ No newline at end of file
@@ -12,6 +12,8 @@
 
 #include "objects.h"
 #include "textureManager.h"
+#include "numberFormat.h"
+#include "textLayout.h"
 
 extern const char* DEFAULT_FONT;
 
@@ -24,7 +26,12 @@ class Text : public Object {
         std::string content; /*!< Content */
         TTF_Font** font; /*!< Font */
         SDL_Color color; /*!< Color of the text */
-        SDL_Texture* texture = nullptr; /*!< Texture of the text */
+        RenderTexture* texture = nullptr; /*!< Texture of the text */
+        int textureWidth = 0; /*!< Width of the texture, it can be bigger than the text */
+        int textureHeight = 0; /*!< Height of the texture */
+        int wrapWidth = 0; /*!< Width the text is wrapped to, 0 for a single line sized to the text */
+        TextAlign align = TEXT_ALIGN_LEFT; /*!< Alignment of the lines inside the box when wrapping */
+        std::shared_ptr<TextLayout> layout; /*!< Cached layout shown while wrapping */
 
         ObjectManager* objManager = nullptr;
 
@@ -43,8 +50,15 @@ class Text : public Object {
          */
         Text(std::string id, float x, float y, float width, float height, std::string content, TTF_Font** font, SDL_Color color, ObjectManager* objManager);
 
-        void setContent(const std::string& newContent, SDL_Renderer* renderer);
-        void drawText(SDL_Renderer** renderer);
+        void setWrap(int width, TextAlign align = TEXT_ALIGN_LEFT);
+        void setContent(const std::string& newContent, RenderBackend* backend);
+        void setContent(const char* newContent, size_t length, RenderBackend* backend);
+        void setNumber(const char* prefix, long long value, const NumberFormat& format, RenderBackend* backend);
+        void setLayout(RenderBackend* backend);
+        void drawText(RenderBackend* backend);
+
+    private:
+        void drawTexture(RenderBackend* backend, RenderTexture* texture, const SDL_Rect* src, const SDL_Rect* dst);
 
 };
 
@@ -0,0 +1,146 @@
+/**
+ * @file textLayout.h
+ * @author Iván
+ * @brief Multi-line text layout with word wrapping and an LRU cache of laid out texts
+ * @version 0.1
+ * @date 2025-08-02
+ *
+ * A layout only measures the text (TTF_SizeUTF8), it does not render it. The texture is rendered the first
+ * time the layout is drawn and kept with it, so a cached layout is drawn again without touching SDL_ttf.
+ */
+#ifndef TEXT_LAYOUT_H
+#define TEXT_LAYOUT_H
+
+#include "config.h"
+#include "renderBackend.h"
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Maximum number of layouts kept by the cache
+ */
+#define TEXT_LAYOUT_CACHE_SIZE 256
+
+/**
+ * @brief Horizontal alignment of the lines of a layout
+ */
+enum TextAlign {
+    TEXT_ALIGN_LEFT,
+    TEXT_ALIGN_CENTER,
+    TEXT_ALIGN_RIGHT
+};
+
+/**
+ * @struct TextLine
+ * @brief A line of a layout, as a range of the laid out text
+ */
+struct TextLine {
+    size_t start; /*!< First byte of the line */
+    size_t length; /*!< Bytes of the line, without the trailing spaces */
+    int width; /*!< Width of the line in pixels */
+};
+
+/**
+ * @class TextLayout
+ * @brief Text broken into lines that fit a box width. Layouts are shared by the cache and the texts showing them
+ */
+class TextLayout {
+    public:
+        std::string text; /*!< Laid out text */
+        TTF_Font* font = nullptr; /*!< Font used to measure the text */
+        int maxWidth = 0; /*!< Box width the text was wrapped to, 0 for no wrapping */
+        TextAlign align = TEXT_ALIGN_LEFT; /*!< Alignment of the lines */
+        std::vector<TextLine> lines; /*!< Lines of the text */
+        int width = 0; /*!< Width of the widest line */
+        int height = 0; /*!< Height of all the lines */
+        int lineHeight = 0; /*!< Distance between the baselines of two lines */
+
+        RenderBackend* backend = nullptr; /*!< Backend the texture belongs to */
+        RenderTexture* texture = nullptr; /*!< Rendered layout, nullptr until it is drawn */
+        SDL_Color textureColor = {0, 0, 0, 0}; /*!< Color the texture was rendered with */
+
+        TextLayout() = default;
+        ~TextLayout();
+        TextLayout(const TextLayout&) = delete;
+        TextLayout& operator=(const TextLayout&) = delete;
+
+        int build(const std::string& text, TTF_Font* font, int maxWidth, TextAlign align);
+        RenderTexture* render(RenderBackend* backend, SDL_Color color);
+};
+
+/**
+ * @struct TextLayoutStats
+ * @brief Counters reported by the layout cache
+ */
+struct TextLayoutStats {
+    unsigned long long hits = 0; /*!< Layouts served from the cache */
+    unsigned long long misses = 0; /*!< Layouts that had to be built */
+    unsigned long long evictions = 0; /*!< Layouts dropped to stay within the cache size */
+};
+
+/**
+ * @class TextLayoutCache
+ * @brief Bounded LRU cache of layouts keyed by (text, font, width, alignment)
+ *
+ * Evicted layouts stay alive while a text still shows them, their texture is freed with the last reference.
+ */
+class TextLayoutCache {
+    private:
+        /**
+         * @brief Key of a cached layout
+         */
+        struct Key {
+            std::string text; /*!< Laid out text */
+            TTF_Font* font; /*!< Font */
+            int maxWidth; /*!< Box width */
+            TextAlign align; /*!< Alignment */
+
+            bool operator==(const Key& other) const {
+                return maxWidth == other.maxWidth && font == other.font && align == other.align && text == other.text;
+            }
+        };
+
+        /**
+         * @brief Hash of a key
+         */
+        struct KeyHash {
+            size_t operator()(const Key& key) const;
+        };
+
+        /**
+         * @brief A cached layout and its position in the LRU list
+         */
+        struct Entry {
+            std::shared_ptr<TextLayout> layout; /*!< Layout */
+            std::list<const Key*>::iterator lruPosition; /*!< Position in the LRU list */
+        };
+
+        std::unordered_map<Key, Entry, KeyHash> entries; /*!< Cached layouts */
+        std::list<const Key*> lru; /*!< Keys of the cached layouts, most recently used first */
+        size_t capacity; /*!< Maximum number of cached layouts */
+        TextLayoutStats stats; /*!< Counters of the cache */
+
+    public:
+        TextLayoutCache(size_t capacity = TEXT_LAYOUT_CACHE_SIZE);
+
+        std::shared_ptr<TextLayout> getLayout(const std::string& text, TTF_Font* font, int maxWidth, TextAlign align = TEXT_ALIGN_LEFT);
+        int measure(const std::string& text, TTF_Font* font, int maxWidth, int* width, int* height);
+        void clear();
+        void logStats() const;
+
+        /**
+         * @brief Counters of the cache
+         *
+         * @return const TextLayoutStats&
+         */
+        const TextLayoutStats& getStats() const {
+            return stats;
+        }
+};
+
+TextLayoutCache& textLayoutCache();
+
+#endif
@@ -11,38 +11,148 @@
 #define TEXTURE_MANAGER_H
 
 #include "config.h"
+#include <list>
+#include <vector>
+
+#include "assetArchive.h"
+#include "renderBackend.h"
 
 extern const char* TEXTURE_PATH; /*!< Path to the textures directory */
 extern const char* FONT_PATH; /*!< Path to the fonts directory */
+extern const char* ASSET_ARCHIVE_PATH; /*!< Path to the packed asset archive */
+
+/**
+ * Default memory budget for resident textures
+ */
+#define TEXTURE_MEMORY_BUDGET (64 * 1024 * 1024)
+
+/**
+ * Smallest side of a pre-scaled level, textures are not halved below it
+ */
+#define TEXTURE_MIN_LEVEL_SIZE 8
+
+/**
+ * Consecutive draws at the same on-screen size before a texture gets a variant scaled to exactly that size
+ */
+#define TEXTURE_EXACT_VARIANT_DRAWS 8
+
+/**
+ * @struct TextureVariant
+ * @brief A pre-scaled copy of a texture
+ */
+struct TextureVariant {
+    RenderTexture* texture = nullptr; /*!< Scaled texture, nullptr if not made */
+    int width = 0; /*!< Width in pixels */
+    int height = 0; /*!< Height in pixels */
+};
+
+/**
+ * @struct TextureEntry
+ * @brief A texture known by the TextureManager. It may or may not be resident in memory
+ */
+struct TextureEntry {
+    std::string path; /*!< File to load the texture from. Empty for textures added already loaded */
+    const ArchiveEntry* archiveEntry = nullptr; /*!< Entry of the asset archive to load the texture from, instead of path */
+    RenderTexture* texture = nullptr; /*!< Texture, nullptr while not resident */
+    size_t bytes = 0; /*!< Memory used by the texture while resident */
+    bool pinned = false; /*!< Pinned textures are never evicted */
+    std::list<std::string>::iterator lruPosition; /*!< Position in the LRU list while resident */
+    int width = 0; /*!< Width of the texture while resident */
+    int height = 0; /*!< Height of the texture while resident */
+    std::vector<TextureVariant> levels; /*!< Pre-scaled levels, each half the size of the previous one, made on demand */
+    TextureVariant exact; /*!< Variant scaled to the size the texture is usually drawn at */
+    int requestedWidth = 0; /*!< On-screen width of the last draws, for the exact variant */
+    int requestedHeight = 0; /*!< On-screen height of the last draws, for the exact variant */
+    int requestedDraws = 0; /*!< Consecutive draws at the requested size */
+};
+
+/**
+ * @struct TextureCacheStats
+ * @brief Counters reported by the texture cache
+ */
+struct TextureCacheStats {
+    unsigned long long hits = 0; /*!< Texture requests served from memory */
+    unsigned long long misses = 0; /*!< Texture requests that needed a load */
+    unsigned long long loadStalls = 0; /*!< Loads done while drawing (the frame waited for them) */
+    double stallMilliseconds = 0; /*!< Total time spent in load stalls */
+    unsigned long long prefetches = 0; /*!< Loads done from the prefetch queue */
+    unsigned long long evictions = 0; /*!< Textures evicted to stay within budget */
+    size_t residentBytes = 0; /*!< Memory used by resident textures */
+    int residentTextures = 0; /*!< Number of resident textures */
+    int knownTextures = 0; /*!< Number of registered textures */
+    unsigned long long variantsBuilt = 0; /*!< Pre-scaled variants made */
+    unsigned long long variantDraws = 0; /*!< Draws served by a pre-scaled variant instead of the full texture */
+};
 
 /**
  * @class TextureManager
- * @brief Manages textures and fonts in the game
+ * @brief Manages textures and fonts in the game. Textures are loaded lazily on first use and the least recently used ones are evicted when the memory budget is exceeded
+ *
+ * Sprites are usually drawn smaller than their source. Instead of scaling the full texture on every draw, the
+ * manager picks a pre-scaled variant by the size the sprite has on the screen (in pixels, after the logical
+ * resolution scaling): halved levels like mipmaps, and a copy at the exact size a texture keeps being drawn at.
+ * Variants are made on demand by the render backend and count towards the memory budget of their texture.
  */
 class TextureManager {
 
     private:
-        std::map<std::string, SDL_Texture*> textureMap; /*!< Map of textures, for searching by ID */
+        std::map<std::string, TextureEntry> textureMap; /*!< Map of textures, for searching by ID */
+        std::list<std::string> lruList; /*!< Resident evictable textures, most recently used first */
+        std::vector<std::string> prefetchQueue; /*!< Textures hinted to be needed soon */
+        size_t memoryBudget = TEXTURE_MEMORY_BUDGET; /*!< Maximum memory for resident textures */
+        TextureCacheStats stats; /*!< Cache counters */
         std::map<std::string, TTF_Font*> fontMap; /*!< Map of fonts, for searching by ID */
-        SDL_Renderer** rendererPtr; /*!< Pointer to the SDL renderer*/
+        AssetArchive archive; /*!< Packed assets, mapped while the manager lives */
+        RenderBackend* backend = nullptr; /*!< Backend the textures belong to */
+        bool variantsEnabled = true; /*!< Whether draws use pre-scaled variants */
+
+        int makeResident(const std::string& id, TextureEntry& entry);
+        void releaseTexture(TextureEntry& entry);
+        void releaseVariants(TextureEntry& entry);
+        int buildVariant(RenderTexture* source, TextureVariant& variant);
+        RenderTexture* selectVariant(TextureEntry& entry, int pixelWidth, int pixelHeight, TextureVariant** variant);
+        void evictToBudget(const TextureEntry* keep);
+        TextureEntry* acquireTexture(const std::string& id);
+        RenderTexture* createArchiveTexture(const ArchiveEntry& entry);
     
     public:
         TextureManager() = default;
         /**
          * @brief Construct a new Texture Manager object
          * 
-         * @param renderer 
+         * @param backend 
          */
-        TextureManager(SDL_Renderer** renderer){rendererPtr = renderer;}
+        TextureManager(RenderBackend* backend){this->backend = backend;}
 
-        int addTexture(const std::string& id, SDL_Texture* texture);
+        int addTexture(const std::string& id, RenderTexture* texture);
+        int registerTexture(const std::string& id, const std::string& path);
         int loadTexture(const std::string& id, const std::string& path);
         int searchTexture(const std::string& id);
-        void drawTexture(const std::string& id, float x, float y, float width, float height, SDL_Rect* clip = nullptr);
+        int requireTexture(const std::string& id);
+        void prefetchTexture(const std::string& id);
+        int processPrefetches(int maxLoads);
+        void drawTexture(const std::string& id, float x, float y, float width, float height, SDL_Rect* clip = nullptr, const RenderState* state = nullptr);
         void clearAllTextures();
         void loadAllTextures(std::string path);
+        int loadArchive(const std::string& path);
+
+        void setMemoryBudget(size_t bytes);
+        void setVariantsEnabled(bool enabled);
+        const TextureCacheStats& getCacheStats() const;
+
+        /**
+         * @brief Gets the backend the textures are drawn with
+         * 
+         * @return RenderBackend* 
+         */
+        RenderBackend* getBackend() const {
+            return backend;
+        }
+
+        void logCacheStats() const;
 
         int loadFont(const std::string& id, const std::string& path, int size);
+        int loadFontFromMemory(const std::string& id, const void* data, size_t size, int fontSize);
         TTF_Font** getFont(const std::string& id);
         void clearAllFonts();
         int loadAllFonts(std::string path);
@@ -0,0 +1,79 @@
+/**
+ * @file threadPool.h
+ * @author Iván
+ * @brief Work-stealing thread pool
+ * @version 0.1
+ * @date 2025-07-28
+ *
+ *
+ */
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Runs tasks on a fixed set of worker threads. Every worker has its own queue: it takes tasks from the
+ * back of its queue and, when it is empty, steals from the front of the queues of the others, so uneven tasks
+ * keep all cores busy without a single shared queue everybody contends on.
+ */
+class ThreadPool {
+    private:
+        /**
+         * @brief Task queue of a worker
+         */
+        struct WorkerQueue {
+            std::mutex mutex; /*!< Protects the tasks */
+            std::deque<std::function<void()>> tasks; /*!< Pending tasks */
+        };
+
+        std::vector<std::unique_ptr<WorkerQueue>> queues; /*!< One queue per worker */
+        std::vector<std::thread> workers; /*!< Worker threads */
+        std::atomic<size_t> nextQueue{0}; /*!< Queue the next task from outside the pool goes to */
+        std::atomic<size_t> pendingTasks{0}; /*!< Tasks submitted and not finished */
+        std::atomic<unsigned long long> steals{0}; /*!< Tasks run by a worker other than the one they were queued to */
+        std::mutex sleepMutex; /*!< Protects the sleep and finish conditions */
+        std::condition_variable workAvailable; /*!< Wakes sleeping workers */
+        std::condition_variable workFinished; /*!< Wakes wait() */
+        bool stopping = false; /*!< Set when the pool is destroyed */
+
+        bool takeTask(size_t worker, std::function<void()>& task);
+        void workerLoop(size_t worker);
+
+    public:
+        ThreadPool(size_t threadCount = 0);
+        ~ThreadPool();
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        void submit(std::function<void()> task);
+        void wait();
+
+        /**
+         * @brief Gets the number of worker threads
+         *
+         * @return size_t
+         */
+        size_t getThreadCount() const {
+            return workers.size();
+        }
+
+        /**
+         * @brief Gets how many tasks were stolen from the queue of another worker
+         *
+         * @return unsigned long long
+         */
+        unsigned long long getSteals() const {
+            return steals.load(std::memory_order_relaxed);
+        }
+};
+
+#endif
@@ -0,0 +1,174 @@
+/**
+ * @file timingWheel.h
+ * @author Iván
+ * @brief Hierarchical timing wheel for delayed and periodic effects
+ * @version 0.1
+ * @date 2025-08-03
+ *
+ *
+ */
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+#include "config.h"
+#include <functional>
+#include <vector>
+
+class Player;
+class Store;
+class Item;
+
+#define TIMING_WHEEL_BITS 6 /*!< Bits of the time covered by a level */
+#define TIMING_WHEEL_SLOTS (1 << TIMING_WHEEL_BITS) /*!< Slots of a level */
+#define TIMING_WHEEL_LEVELS 6 /*!< Levels of the wheel, enough for 2^36 milliseconds ahead */
+
+/**
+ * ID of a timer, 0 is never a valid ID
+ */
+typedef Uint64 TimerId;
+
+/**
+ * @enum TimerTargetType
+ * @brief Kind of object an event timer is about
+ */
+enum TimerTargetType {
+    TIMER_TARGET_NONE = 0, /*!< No target */
+    TIMER_TARGET_PLAYER, /*!< A Player */
+    TIMER_TARGET_STORE, /*!< A Store */
+    TIMER_TARGET_ITEM /*!< An Item */
+};
+
+/**
+ * @struct TimerTarget
+ * @brief Object an event timer is about. Built implicitly from a Player, Store or Item pointer
+ */
+struct TimerTarget {
+    TimerTargetType type = TIMER_TARGET_NONE; /*!< Kind of the object */
+    void* object = nullptr; /*!< The object */
+
+    TimerTarget() = default;
+    TimerTarget(Player* player) : type(TIMER_TARGET_PLAYER), object(player) {
+    }
+    TimerTarget(Store* store) : type(TIMER_TARGET_STORE), object(store) {
+    }
+    TimerTarget(Item* item) : type(TIMER_TARGET_ITEM), object(item) {
+    }
+
+    Player* player() const {
+        return type == TIMER_TARGET_PLAYER ? static_cast<Player*>(object) : nullptr;
+    }
+    Store* store() const {
+        return type == TIMER_TARGET_STORE ? static_cast<Store*>(object) : nullptr;
+    }
+    Item* item() const {
+        return type == TIMER_TARGET_ITEM ? static_cast<Item*>(object) : nullptr;
+    }
+};
+
+/**
+ * @struct TimerEvent
+ * @brief A timer that fired, given to its callback or returned by TimingWheel::update()
+ */
+struct TimerEvent {
+    TimerId id = 0; /*!< ID of the timer */
+    int event = 0; /*!< Event ID of an event timer, 0 for a callback */
+    TimerTarget target; /*!< Target of an event timer */
+    int value = 0; /*!< Value given to addEvent() */
+    Uint32 time = 0; /*!< Time the timer was due */
+    int count = 1; /*!< Periods that elapsed, more than 1 when a periodic timer fell behind the clock */
+};
+
+/**
+ * Function called when a timer fires
+ */
+typedef std::function<void(const TimerEvent&)> TimerCallback;
+
+/**
+ * @class TimingWheel
+ * @brief Timers of the game clock in a hierarchical timing wheel: TIMING_WHEEL_LEVELS levels of TIMING_WHEEL_SLOTS
+ * slots, a slot of level L spans 64^L milliseconds. A timer goes to the lowest level whose span reaches it and moves
+ * down a level every time the wheel below it turns, until it lands in a level 0 slot and fires.
+ *
+ * Adding and cancelling a timer are O(1): a slot is a linked list of timers. An update steps over empty slots with
+ * a bitmap per level and takes whole slots at once, so its cost depends on the timers that fire (and the ones moved
+ * down), not on how many are waiting. Timers of the same time fire in the order they were added.
+ *
+ * A timer either calls a callback or, when added with addEvent(), is returned by update() with its event ID and
+ * target, for the owner to handle them in a batch.
+ */
+class TimingWheel {
+    private:
+        /**
+         * @brief A timer, linked in a slot list or in the list of expired timers
+         */
+        struct Node {
+            Uint64 expires = 0; /*!< Time it is due */
+            Uint32 period = 0; /*!< Milliseconds between firings, 0 if it fires once */
+            TimerCallback callback; /*!< Function called, if it is a callback timer */
+            int event = 0; /*!< Event ID, if it is an event timer */
+            TimerTarget target; /*!< Target of the event */
+            int value = 0; /*!< Value of the event */
+            unsigned int generation = 1; /*!< Incremented when the node is freed, so old IDs are not valid */
+            int list = -1; /*!< List it is linked in, -1 if the node is free */
+            int prev = -1; /*!< Previous node of the list */
+            int next = -1; /*!< Next node of the list, or next free node */
+        };
+
+        /**
+         * @brief Ends of a doubly linked list of nodes
+         */
+        struct List {
+            int head = -1; /*!< First node */
+            int tail = -1; /*!< Last node */
+        };
+
+        std::vector<Node> nodes; /*!< Timers, free ones are reused */
+        int freeNode = -1; /*!< First free node */
+        List lists[TIMING_WHEEL_LEVELS * TIMING_WHEEL_SLOTS + 1]; /*!< Slot lists level by level, then the expired list */
+        Uint64 occupied[TIMING_WHEEL_LEVELS] = {}; /*!< Bit of every slot with timers, per level */
+        Uint64 current = 0; /*!< Time every timer up to has expired */
+        int count = 0; /*!< Pending timers */
+        std::vector<TimerEvent> events; /*!< Event timers fired by the last update */
+
+        TimerId add(Uint32 delay, Uint32 period);
+        void insert(int node, Uint64 time);
+        void link(int node, int list);
+        void unlink(int node);
+        void expireSlot(int slot);
+        void cascade();
+        Uint64 nextStop() const;
+        void release(int node);
+        int findNode(TimerId id) const;
+
+    public:
+        TimingWheel() = default;
+        TimingWheel(const TimingWheel&) = delete;
+        TimingWheel& operator=(const TimingWheel&) = delete;
+
+        TimerId addTimer(Uint32 delay, TimerCallback callback, Uint32 period = 0);
+        TimerId addEvent(Uint32 delay, int event, TimerTarget target, int value = 0, Uint32 period = 0);
+        int cancel(TimerId id);
+        bool isPending(TimerId id) const;
+        const std::vector<TimerEvent>& update(Uint32 milliseconds);
+        void clear();
+
+        /**
+         * @brief Time of the last update
+         *
+         * @return Uint32
+         */
+        Uint32 getTime() const {
+            return static_cast<Uint32>(current);
+        }
+
+        /**
+         * @brief Timers waiting to fire
+         *
+         * @return int
+         */
+        int getCount() const {
+            return count;
+        }
+};
+
+#endif
@@ -0,0 +1,159 @@
+/**
+ * @file allocTracker.cpp
+ * @author Iván Mansilla
+ * @brief Heap allocation accounting per frame and per subsystem.
+ * @version 0.1
+ * @date 2025-07-26
+ *
+ *
+ */
+
+#include "../inc/allocTracker.h"
+
+#ifdef TRACK_ALLOCATIONS
+
+#include "../inc/config.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+/**
+ * @brief Frames at startup that are not counted as steady state
+ *
+ */
+static const unsigned long long WARMUP_FRAMES = 60;
+
+static const char* SUBSYSTEM_NAMES[ALLOC_SUBSYSTEM_COUNT] = {"other", "input", "store", "text", "render"};
+
+static thread_local AllocSubsystem currentSubsystem = ALLOC_OTHER; /*!< Subsystem of the running scope */
+
+static std::atomic<unsigned long long> frameAllocations[ALLOC_SUBSYSTEM_COUNT]; /*!< Allocations of the running frame */
+static std::atomic<unsigned long long> frameBytes[ALLOC_SUBSYSTEM_COUNT]; /*!< Bytes of the running frame */
+
+static AllocCounters lastFrame[ALLOC_SUBSYSTEM_COUNT]; /*!< Counters of the last finished frame */
+static AllocCounters totals[ALLOC_SUBSYSTEM_COUNT]; /*!< Counters of all steady state frames */
+static unsigned long long frames = 0; /*!< Finished frames */
+static unsigned long long allocatingFrames = 0; /*!< Steady state frames that allocated */
+static unsigned long long maxFrameAllocations = 0; /*!< Most allocations in a steady state frame */
+
+/**
+ * @brief Counts an allocation for the subsystem of the calling thread
+ *
+ * @param size
+ */
+static void countAllocation(size_t size){
+    frameAllocations[currentSubsystem].fetch_add(1, std::memory_order_relaxed);
+    frameBytes[currentSubsystem].fetch_add(size, std::memory_order_relaxed);
+}
+
+void* operator new(size_t size){
+    countAllocation(size);
+    void* ptr = malloc(size ? size : 1);
+    if(!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](size_t size){
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    countAllocation(size);
+    return malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return operator new(size, std::nothrow);
+}
+
+void operator delete(void* ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+    free(ptr);
+}
+
+/**
+ * @brief Construct a new Alloc Scope object
+ *
+ * @param subsystem Subsystem the allocations are attributed to
+ */
+AllocScope::AllocScope(AllocSubsystem subsystem){
+    previous = currentSubsystem;
+    currentSubsystem = subsystem;
+}
+
+/**
+ * @brief Destroy the Alloc Scope object, restoring the enclosing subsystem
+ *
+ */
+AllocScope::~AllocScope(){
+    currentSubsystem = previous;
+}
+
+/**
+ * @brief Closes the counters of the running frame. Call it once at the end of every frame
+ *
+ */
+void allocTrackerEndFrame(){
+    unsigned long long allocations = 0;
+    for(int i = 0; i < ALLOC_SUBSYSTEM_COUNT; i++) {
+        lastFrame[i].allocations = frameAllocations[i].exchange(0, std::memory_order_relaxed);
+        lastFrame[i].bytes = frameBytes[i].exchange(0, std::memory_order_relaxed);
+        allocations += lastFrame[i].allocations;
+    }
+
+    frames++;
+    if(frames <= WARMUP_FRAMES) {
+        return;
+    }
+
+    for(int i = 0; i < ALLOC_SUBSYSTEM_COUNT; i++) {
+        totals[i].allocations += lastFrame[i].allocations;
+        totals[i].bytes += lastFrame[i].bytes;
+    }
+    if(allocations > 0) {
+        allocatingFrames++;
+    }
+    if(allocations > maxFrameAllocations) {
+        maxFrameAllocations = allocations;
+    }
+}
+
+/**
+ * @brief Gets the counters of the last finished frame for a subsystem
+ *
+ * @param subsystem
+ * @return AllocCounters
+ */
+AllocCounters getFrameAllocations(AllocSubsystem subsystem){
+    return lastFrame[subsystem];
+}
+
+/**
+ * @brief Logs the allocations of the steady state frames (after the warmup)
+ *
+ */
+void logAllocationReport(){
+    unsigned long long steadyFrames = frames > WARMUP_FRAMES ? frames - WARMUP_FRAMES : 0;
+    SDL_Log("Allocation report: %llu steady state frames, %llu with heap allocations, at most %llu allocations in a frame\n",
+        steadyFrames, allocatingFrames, maxFrameAllocations);
+    for(int i = 0; i < ALLOC_SUBSYSTEM_COUNT; i++) {
+        double perFrame = steadyFrames ? static_cast<double>(totals[i].allocations) / steadyFrames : 0.0;
+        SDL_Log("  %-8s %10llu allocations %12llu bytes (%.3f allocations/frame)\n",
+            SUBSYSTEM_NAMES[i], totals[i].allocations, totals[i].bytes, perFrame);
+    }
+}
+
+#endif
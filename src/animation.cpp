@@ -0,0 +1,403 @@
+/**
+ * @file animation.cpp
+ * @author Iván Mansilla
+ * @brief Sprite-sheet frame animations.
+ * @version 0.1
+ * @date 2025-08-03
+ *
+ *
+ */
+
+#include "../inc/animation.h"
+#include "../inc/objects.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+/**
+ * @brief Defines a clip with the frames of a grid in a sprite sheet. Frames are numbered left to right, top to bottom
+ *
+ * @param id ID of the clip
+ * @param textureId Sprite sheet
+ * @param frameWidth Width of a frame of the grid
+ * @param frameHeight Height of a frame of the grid
+ * @param columns Frames per row of the sheet
+ * @param frameCount Frames of the clip
+ * @param frameDuration Milliseconds every frame is shown (see setFrameDurations)
+ * @param loop What happens after the last frame
+ * @param firstFrame Frame of the grid the clip starts at, so a sheet can hold several clips
+ * @return int 0 on success, -1 if the clip exists or the grid is not valid
+ */
+int AnimationSystem::defineClip(const std::string& id, const std::string& textureId, int frameWidth, int frameHeight, int columns,
+    int frameCount, float frameDuration, AnimationLoop loop, int firstFrame) {
+    if(clipIds.find(id) != clipIds.end()) {
+        SDL_Log("ERROR: Animation clip '%s' already exists.\n", id.c_str());
+        return -1;
+    }
+    if(frameWidth <= 0 || frameHeight <= 0 || columns <= 0 || frameCount <= 0 || firstFrame < 0 || frameDuration <= 0.0f) {
+        SDL_Log("ERROR: Animation clip '%s' has no frames.\n", id.c_str());
+        return -1;
+    }
+
+    AnimationClip clip;
+    clip.id = id;
+    clip.textureId = textureId;
+    clip.loop = loop;
+    for(int i = 0; i < frameCount; i++) {
+        int cell = firstFrame + i;
+        clip.frames.push_back({(cell % columns) * frameWidth, (cell / columns) * frameHeight, frameWidth, frameHeight});
+    }
+    clip.durations.assign(frameCount, frameDuration);
+    clip.events.resize(frameCount);
+    rebuildSteps(clip);
+
+    clipIds[id] = static_cast<int>(clips.size());
+    clips.push_back(clip);
+    return 0;
+}
+
+/**
+ * @brief Gives every frame of a clip its own duration. Animations already playing the clip keep their time
+ *
+ * @param id
+ * @param durations Milliseconds of every frame, as many as frames
+ * @return int 0 on success, -1 if the clip does not exist or the durations do not match the frames
+ */
+int AnimationSystem::setFrameDurations(const std::string& id, const std::vector<float>& durations) {
+    auto found = clipIds.find(id);
+    if(found == clipIds.end()) {
+        SDL_Log("ERROR: Animation clip '%s' does not exist.\n", id.c_str());
+        return -1;
+    }
+    AnimationClip& clip = clips[found->second];
+    if(durations.size() != clip.frames.size()) {
+        SDL_Log("ERROR: Animation clip '%s' has %d frames, got %d durations.\n", id.c_str(),
+            static_cast<int>(clip.frames.size()), static_cast<int>(durations.size()));
+        return -1;
+    }
+    for(float duration : durations) {
+        if(duration <= 0.0f) {
+            SDL_Log("ERROR: Frames of animation clip '%s' must last more than 0 ms.\n", id.c_str());
+            return -1;
+        }
+    }
+    clip.durations = durations;
+    rebuildSteps(clip);
+
+    // the end of the current step moved
+    for(size_t i = 0; i < times.size(); i++) {
+        if(clipIndices[i] == found->second && stepEnds[i] != FLT_MAX) {
+            stepEnds[i] = clip.stepEnds[steps[i]];
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Adds an event fired every time a frame of a clip is shown (a sound, a particle, the end of a hit...)
+ *
+ * @param id
+ * @param frame
+ * @param name Name passed to the event handler
+ * @return int 0 on success, -1 if the clip or the frame do not exist
+ */
+int AnimationSystem::addEvent(const std::string& id, int frame, const std::string& name) {
+    auto found = clipIds.find(id);
+    if(found == clipIds.end()) {
+        SDL_Log("ERROR: Animation clip '%s' does not exist.\n", id.c_str());
+        return -1;
+    }
+    AnimationClip& clip = clips[found->second];
+    if(frame < 0 || frame >= static_cast<int>(clip.frames.size())) {
+        SDL_Log("ERROR: Animation clip '%s' has no frame %d.\n", id.c_str(), frame);
+        return -1;
+    }
+    clip.events[frame].push_back(name);
+    return 0;
+}
+
+/**
+ * @brief Gets a clip by its ID
+ *
+ * @param id
+ * @return const AnimationClip* nullptr if it does not exist
+ */
+const AnimationClip* AnimationSystem::getClip(const std::string& id) const {
+    auto found = clipIds.find(id);
+    return found == clipIds.end() ? nullptr : &clips[found->second];
+}
+
+/**
+ * @brief Builds the sequence of steps of a clip and the time every step ends
+ *
+ * @param clip
+ */
+void AnimationSystem::rebuildSteps(AnimationClip& clip) {
+    int frameCount = static_cast<int>(clip.frames.size());
+    clip.steps.clear();
+    for(int i = 0; i < frameCount; i++) {
+        clip.steps.push_back(i);
+    }
+    if(clip.loop == ANIMATION_PING_PONG) {
+        // the ends are not repeated: 0 1 2 3 2 1, 0 1 2 3 2 1...
+        for(int i = frameCount - 2; i > 0; i--) {
+            clip.steps.push_back(i);
+        }
+    }
+
+    clip.stepEnds.clear();
+    clip.duration = 0.0f;
+    for(int frame : clip.steps) {
+        clip.duration += clip.durations[frame];
+        clip.stepEnds.push_back(clip.duration);
+    }
+}
+
+/**
+ * @brief Calls the event handler with the events of a frame
+ *
+ * @param owner
+ * @param clip
+ * @param frame Frame of the clip, -1 for ANIMATION_EVENT_END
+ */
+void AnimationSystem::fireEvents(Object* owner, int clip, int frame) {
+    if(!eventHandler) {
+        return;
+    }
+    if(frame < 0) {
+        eventHandler(owner, ANIMATION_EVENT_END);
+        return;
+    }
+    // by index, the handler may define clips and move them
+    for(size_t i = 0; i < clips[clip].events[frame].size(); i++) {
+        eventHandler(owner, clips[clip].events[frame][i]);
+    }
+}
+
+/**
+ * @brief Shows a step of the clip of an animation on its object and fires the events of its frame, or queues them
+ * while update() advances the animations
+ *
+ * @param index Animation
+ * @param step
+ */
+void AnimationSystem::showStep(size_t index, int step) {
+    const AnimationClip& clip = clips[clipIndices[index]];
+    Object* owner = owners[index];
+    steps[index] = step;
+    const SDL_Rect& frame = clip.frames[clip.steps[step]];
+    if(frame.x != owner->frameClip.x || frame.y != owner->frameClip.y || frame.w != owner->frameClip.w || frame.h != owner->frameClip.h) {
+        owner->frameClip = frame;
+        owner->markDirty();
+    }
+    int frameIndex = clip.steps[step];
+    if(!eventHandler || clip.events[frameIndex].empty()) {
+        return;
+    }
+    if(updating) {
+        pendingEvents.push_back({owner, index, clipIndices[index], frameIndex});
+        return;
+    }
+    fireEvents(owner, clipIndices[index], frameIndex);
+}
+
+/**
+ * @brief Moves an animation to the step its time is in. Every step passed is shown, so its events are fired,
+ * but at most one cycle of the clip: whole cycles are dropped, so a long pause does not fire the same events many times
+ *
+ * @param index Animation
+ */
+void AnimationSystem::advance(size_t index) {
+    const AnimationClip& clip = clips[clipIndices[index]];
+    int stepCount = static_cast<int>(clip.steps.size());
+    float time = times[index];
+
+    if(time >= clip.duration) {
+        if(clip.loop == ANIMATION_ONCE) {
+            for(int step = steps[index] + 1; step < stepCount; step++) {
+                showStep(index, step);
+            }
+            times[index] = clip.duration;
+            speeds[index] = 0.0f;
+            stepEnds[index] = FLT_MAX;
+            if(eventHandler) {
+                pendingEvents.push_back({owners[index], index, clipIndices[index], -1});
+            }
+            return;
+        }
+        time = std::fmod(time, clip.duration);
+        times[index] = time;
+    }
+
+    int step = steps[index];
+    for(int passed = 0; passed < stepCount; passed++) {
+        step = step + 1 < stepCount ? step + 1 : 0;
+        showStep(index, step);
+        float start = step > 0 ? clip.stepEnds[step - 1] : 0.0f;
+        if(time >= start && time < clip.stepEnds[step]) {
+            break;
+        }
+    }
+    stepEnds[index] = clip.stepEnds[steps[index]];
+}
+
+/**
+ * @brief Plays a clip on an object from its first frame. The object shows the sprite sheet of the clip from now on
+ *
+ * @param object
+ * @param clipId
+ * @param speed Playback speed, 1 for the durations of the clip
+ * @return int 0 on success, -1 if the clip does not exist
+ */
+int AnimationSystem::play(Object* object, const std::string& clipId, float speed) {
+    auto found = clipIds.find(clipId);
+    if(found == clipIds.end()) {
+        SDL_Log("ERROR: Animation clip '%s' does not exist.\n", clipId.c_str());
+        return -1;
+    }
+    const AnimationClip& clip = clips[found->second];
+
+    size_t index;
+    if(object->animation >= 0) {
+        index = static_cast<size_t>(object->animation);
+    }
+    else {
+        index = times.size();
+        times.push_back(0.0f);
+        speeds.push_back(0.0f);
+        stepEnds.push_back(0.0f);
+        steps.push_back(0);
+        clipIndices.push_back(0);
+        owners.push_back(object);
+        object->animation = static_cast<int>(index);
+    }
+    times[index] = 0.0f;
+    speeds[index] = speed;
+    clipIndices[index] = found->second;
+    stepEnds[index] = clip.stepEnds[0];
+
+    object->textureId = clip.textureId;
+    object->frameClip = {0, 0, 0, 0};
+    showStep(index, 0);
+    object->markDirty();
+    return 0;
+}
+
+/**
+ * @brief Removes an animation, moving the last one into its place so the arrays stay contiguous
+ *
+ * @param index
+ */
+void AnimationSystem::remove(size_t index) {
+    owners[index]->animation = -1;
+    size_t last = times.size() - 1;
+    if(index != last) {
+        times[index] = times[last];
+        speeds[index] = speeds[last];
+        stepEnds[index] = stepEnds[last];
+        steps[index] = steps[last];
+        clipIndices[index] = clipIndices[last];
+        owners[index] = owners[last];
+        owners[index]->animation = static_cast<int>(index);
+    }
+    times.pop_back();
+    speeds.pop_back();
+    stepEnds.pop_back();
+    steps.pop_back();
+    clipIndices.pop_back();
+    owners.pop_back();
+}
+
+/**
+ * @brief Stops the animation of an object. It keeps showing its current frame
+ *
+ * @param object
+ */
+void AnimationSystem::stop(Object* object) {
+    if(object->animation < 0 || static_cast<size_t>(object->animation) >= owners.size() || owners[object->animation] != object) {
+        return;
+    }
+    remove(static_cast<size_t>(object->animation));
+}
+
+/**
+ * @brief Changes the playback speed of the animation of an object, 0 pauses it
+ *
+ * @param object
+ * @param speed
+ */
+void AnimationSystem::setSpeed(Object* object, float speed) {
+    if(object->animation < 0 || static_cast<size_t>(object->animation) >= owners.size() || owners[object->animation] != object) {
+        return;
+    }
+    // finished clips stay finished
+    if(stepEnds[object->animation] != FLT_MAX) {
+        speeds[object->animation] = speed;
+    }
+}
+
+/**
+ * @brief Stops all the animations
+ *
+ */
+void AnimationSystem::clear() {
+    for(Object* owner : owners) {
+        owner->animation = -1;
+    }
+    times.clear();
+    speeds.clear();
+    stepEnds.clear();
+    steps.clear();
+    clipIndices.clear();
+    owners.clear();
+    pendingEvents.clear();
+}
+
+/**
+ * @brief Fires the events queued by update(). An object whose animation was stopped by an earlier handler may be
+ * deleted already, its events are dropped
+ *
+ */
+void AnimationSystem::firePendingEvents() {
+    // swapped, the handlers may update the animations again
+    firingEvents.swap(pendingEvents);
+    for(const PendingEvent& event : firingEvents) {
+        bool playing = event.index < owners.size() && owners[event.index] == event.owner;
+        if(!playing) {
+            // other animations may have been removed and moved it
+            playing = std::find(owners.begin(), owners.end(), event.owner) != owners.end();
+        }
+        if(playing) {
+            fireEvents(event.owner, event.clip, event.frame);
+        }
+    }
+    firingEvents.clear();
+}
+
+/**
+ * @brief Advances every animation. The clocks are advanced in one pass over contiguous arrays, then only the
+ * animations whose step ended are moved to their next frame. The events of the frames shown are fired at the end
+ *
+ * @param deltaMilliseconds Time since the last update
+ */
+void AnimationSystem::update(float deltaMilliseconds) {
+    updating = true;
+    size_t count = times.size();
+    float* time = times.data();
+    const float* speed = speeds.data();
+    for(size_t i = 0; i < count; i++) {
+        time[i] += deltaMilliseconds * speed[i];
+    }
+
+    const float* end = stepEnds.data();
+    for(size_t i = 0; i < count; i++) {
+        if(time[i] >= end[i]) {
+            advance(i);
+        }
+    }
+    updating = false;
+
+    if(!pendingEvents.empty()) {
+        firePendingEvents();
+    }
+}
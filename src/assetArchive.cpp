@@ -0,0 +1,182 @@
+/**
+ * @file assetArchive.cpp
+ * @author Iván Mansilla
+ * @brief Memory-mapped packed asset archive.
+ * @version 0.1
+ * @date 2025-07-22
+ *
+ *
+ */
+
+#include "../inc/assetArchive.h"
+#include <cstring>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#ifdef USE_LZ4
+    #include <lz4.h>
+#endif
+
+/**
+ * @brief Destroy the Asset Archive object, unmapping the file
+ *
+ */
+AssetArchive::~AssetArchive(){
+    close();
+}
+
+/**
+ * @brief Maps an archive file in memory and validates its index.
+ *
+ * @param path Path to the archive.
+ * @return int 0 on success, -1 on failure.
+ */
+int AssetArchive::open(const std::string& path){
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(file == INVALID_HANDLE_VALUE) {
+        SDL_Log("ERROR: Could not open archive '%s'.\n", path.c_str());
+        return -1;
+    }
+    LARGE_INTEGER size;
+    GetFileSizeEx(file, &size);
+    HANDLE map = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(!map) {
+        SDL_Log("ERROR: Could not map archive '%s'.\n", path.c_str());
+        CloseHandle(file);
+        return -1;
+    }
+    mapping = static_cast<const uint8_t*>(MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0));
+    if(!mapping) {
+        SDL_Log("ERROR: Could not map archive '%s'.\n", path.c_str());
+        CloseHandle(map);
+        CloseHandle(file);
+        return -1;
+    }
+    fileHandle = file;
+    mappingHandle = map;
+    mappingSize = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0) {
+        SDL_Log("ERROR: Could not open archive '%s'.\n", path.c_str());
+        return -1;
+    }
+    struct stat info;
+    if(fstat(fd, &info) != 0 || info.st_size == 0) {
+        SDL_Log("ERROR: Could not read archive '%s'.\n", path.c_str());
+        ::close(fd);
+        return -1;
+    }
+    void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(data == MAP_FAILED) {
+        SDL_Log("ERROR: Could not map archive '%s'.\n", path.c_str());
+        return -1;
+    }
+    mapping = static_cast<const uint8_t*>(data);
+    mappingSize = static_cast<size_t>(info.st_size);
+#endif
+
+    // Validate the header and the index
+    const ArchiveHeader* header = reinterpret_cast<const ArchiveHeader*>(mapping);
+    if(mappingSize < sizeof(ArchiveHeader) || memcmp(header->magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0 || header->version != ARCHIVE_VERSION) {
+        SDL_Log("ERROR: '%s' is not a valid archive.\n", path.c_str());
+        close();
+        return -1;
+    }
+    if(mappingSize < sizeof(ArchiveHeader) + header->entryCount * sizeof(ArchiveEntry)) {
+        SDL_Log("ERROR: Archive '%s' is truncated.\n", path.c_str());
+        close();
+        return -1;
+    }
+    entries = reinterpret_cast<const ArchiveEntry*>(mapping + sizeof(ArchiveHeader));
+    entryCount = header->entryCount;
+    for(uint32_t i = 0; i < entryCount; i++) {
+        if(entries[i].offset + entries[i].storedSize > mappingSize) {
+            SDL_Log("ERROR: Archive '%s' is truncated.\n", path.c_str());
+            close();
+            return -1;
+        }
+    }
+
+    SDL_Log("Archive '%s' mapped, %u entries\n", path.c_str(), entryCount);
+    return 0;
+}
+
+/**
+ * @brief Unmaps the archive. Data returned by getData is no longer valid
+ *
+ */
+void AssetArchive::close(){
+    if(!mapping) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(mapping);
+    CloseHandle(static_cast<HANDLE>(mappingHandle));
+    CloseHandle(static_cast<HANDLE>(fileHandle));
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+#else
+    munmap(const_cast<uint8_t*>(mapping), mappingSize);
+#endif
+    mapping = nullptr;
+    mappingSize = 0;
+    entries = nullptr;
+    entryCount = 0;
+}
+
+/**
+ * @brief Finds an entry by its name
+ *
+ * @param name
+ * @return const ArchiveEntry* The entry, or nullptr if it does not exist
+ */
+const ArchiveEntry* AssetArchive::findEntry(const std::string& name) const {
+    for(uint32_t i = 0; i < entryCount; i++) {
+        if(strncmp(entries[i].name, name.c_str(), ARCHIVE_NAME_LENGTH) == 0) {
+            return &entries[i];
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Gets the data of an entry. Raw entries point straight into the mapped file; compressed ones are decompressed into a buffer that is reused by the next call.
+ *
+ * @param entry
+ * @return const void* The data (rawSize bytes), or nullptr on failure
+ */
+const void* AssetArchive::getData(const ArchiveEntry& entry){
+    const uint8_t* stored = mapping + entry.offset;
+
+    if(entry.compression == ARCHIVE_RAW) {
+        return stored;
+    }
+
+#ifdef USE_LZ4
+    if(entry.compression == ARCHIVE_LZ4) {
+        scratch.resize(entry.rawSize);
+        int size = LZ4_decompress_safe(reinterpret_cast<const char*>(stored), reinterpret_cast<char*>(scratch.data()),
+            static_cast<int>(entry.storedSize), static_cast<int>(entry.rawSize));
+        if(size < 0 || static_cast<uint64_t>(size) != entry.rawSize) {
+            SDL_Log("ERROR: Could not decompress '%s'.\n", entry.name);
+            return nullptr;
+        }
+        return scratch.data();
+    }
+#endif
+
+    SDL_Log("ERROR: Unsupported compression for '%s'.\n", entry.name);
+    return nullptr;
+}
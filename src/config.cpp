@@ -16,9 +16,10 @@ const char* GAME_TITLE = "SDL2 CLICKER ALPHA";
  * 
  * @param window 
  * @param renderer 
+ * @param createRenderer false to only create the window (the renderer is set to NULL)
  * @return int 0 on success, -1 on failure.
  */
-int init_SDL(SDL_Window** window, SDL_Renderer** renderer) {
+int init_SDL(SDL_Window** window, SDL_Renderer** renderer, bool createRenderer) {
 
     // try to init SDL
     if(SDL_Init(SDL_INIT_VIDEO) < 0 ){
@@ -44,7 +45,7 @@ int init_SDL(SDL_Window** window, SDL_Renderer** renderer) {
         SDL_WINDOWPOS_CENTERED,
         SDL_WINDOWPOS_CENTERED,
         SCREEN_WIDTH, SCREEN_HEIGHT,
-        SDL_WINDOW_SHOWN
+        SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI
     );
         
     // verify that the window was created
@@ -53,11 +54,27 @@ int init_SDL(SDL_Window** window, SDL_Renderer** renderer) {
         return -1;
     }
 
-    *renderer = SDL_CreateRenderer(*window, -1, SDL_RENDERER_ACCELERATED);
-    if(!renderer){
+    // the CPU backend draws to the window surface, it does not need a renderer
+    if(!createRenderer){
+        *renderer = NULL;
+        return 0;
+    }
+
+    *renderer = SDL_CreateRenderer(*window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE);
+    if(*renderer == NULL){
+        // hosts without a GPU only have the software renderer
+        *renderer = SDL_CreateRenderer(*window, -1, SDL_RENDERER_SOFTWARE | SDL_RENDERER_TARGETTEXTURE);
+    }
+    if(*renderer == NULL){
         SDL_Log("ERROR: Failed to create renderer\nSDL Error: '%s'\n", SDL_GetError());
         return -1;
     }
+
+    // the game is laid out in SCREEN_WIDTH x SCREEN_HEIGHT units, scaled to the window (and its pixel density)
+    if(SDL_RenderSetLogicalSize(*renderer, SCREEN_WIDTH, SCREEN_HEIGHT) != 0){
+        SDL_Log("ERROR: Could not set the logical size. %s\n", SDL_GetError());
+        return -1;
+    }
         
     return 0;
 }
\ No newline at end of file
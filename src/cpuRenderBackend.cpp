@@ -0,0 +1,1000 @@
+/**
+ * @file cpuRenderBackend.cpp
+ * @author Iván Mansilla
+ * @brief CPU rasterizer: SIMD blending, scaled blits and tiled multithreaded composition.
+ * @version 0.1
+ * @date 2025-08-03
+ *
+ *
+ */
+
+#include "../inc/cpuRenderBackend.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CPU_BACKEND_X86
+#include <immintrin.h>
+#if defined(__GNUC__)
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE2
+#define TARGET_AVX2
+#endif
+#endif
+
+/**
+ * @brief Divides by 255 with rounding, for values up to 255 * 255
+ *
+ * @param x
+ * @return Uint32
+ */
+static inline Uint32 div255(Uint32 x){
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+/**
+ * @brief Converts a straight alpha ARGB pixel to premultiplied alpha
+ *
+ * @param pixel
+ * @return Uint32
+ */
+static inline Uint32 premultiply(Uint32 pixel){
+    Uint32 a = pixel >> 24;
+    if(a == 255) {
+        return pixel;
+    }
+    if(a == 0) {
+        return 0;
+    }
+    Uint32 r = div255(((pixel >> 16) & 0xFF) * a);
+    Uint32 g = div255(((pixel >> 8) & 0xFF) * a);
+    Uint32 b = div255((pixel & 0xFF) * a);
+    return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+/**
+ * @brief Interpolates two premultiplied pixels, two channels per multiply
+ *
+ * @param a
+ * @param b
+ * @param weight Weight of b, 0-256
+ * @return Uint32
+ */
+static inline Uint32 lerpPixel(Uint32 a, Uint32 b, Uint32 weight){
+    Uint32 rb = (((a & 0x00FF00FF) * (256 - weight) + (b & 0x00FF00FF) * weight) >> 8) & 0x00FF00FF;
+    Uint32 ag = (((a >> 8) & 0x00FF00FF) * (256 - weight) + ((b >> 8) & 0x00FF00FF) * weight) & 0xFF00FF00;
+    return rb | ag;
+}
+
+/**
+ * @brief Blends premultiplied pixels over a row: dst = src + dst * (1 - srcAlpha)
+ *
+ * @param dst
+ * @param src
+ * @param count
+ */
+static void blendRowScalar(Uint32* dst, const Uint32* src, int count){
+    for(int i = 0; i < count; i++) {
+        Uint32 s = src[i];
+        Uint32 a = s >> 24;
+        if(a == 255) {
+            dst[i] = s;
+        }
+        else if(s != 0) {
+            Uint32 d = dst[i];
+            Uint32 inv = 255 - a;
+            Uint32 rb = (d & 0x00FF00FF) * inv + 0x00800080;
+            rb = ((rb + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+            Uint32 ag = ((d >> 8) & 0x00FF00FF) * inv + 0x00800080;
+            ag = (ag + ((ag >> 8) & 0x00FF00FF)) & 0xFF00FF00;
+            dst[i] = s + (rb | ag);
+        }
+    }
+}
+
+#ifdef CPU_BACKEND_X86
+
+/**
+ * @brief Multiplies the 16 bit channels of d by 255 - alpha of the pixel and divides by 255
+ *
+ * @param d Channels widened to 16 bits
+ * @param inverseAlpha 255 - alpha, repeated in the 4 channels of every pixel
+ * @return __m128i
+ */
+TARGET_SSE2 static inline __m128i scaleChannelsSse2(__m128i d, __m128i inverseAlpha){
+    __m128i x = _mm_add_epi16(_mm_mullo_epi16(d, inverseAlpha), _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+/**
+ * @brief Blends premultiplied pixels over a row, 4 pixels at a time. Fully opaque and fully transparent groups skip the math
+ *
+ * @param dst
+ * @param src
+ * @param count
+ */
+TARGET_SSE2 static void blendRowSse2(Uint32* dst, const Uint32* src, int count){
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+    const __m128i full = _mm_set1_epi16(255);
+    int i = 0;
+    for(; i + 4 <= count; i += 4) {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i alpha = _mm_and_si128(s, alphaMask);
+        if(_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, alphaMask)) == 0xFFFF) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), s);
+            continue;
+        }
+        if(_mm_movemask_epi8(_mm_cmpeq_epi32(s, zero)) == 0xFFFF) {
+            continue;
+        }
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+
+        __m128i sLow = _mm_unpacklo_epi8(s, zero);
+        __m128i sHigh = _mm_unpackhi_epi8(s, zero);
+        __m128i aLow = _mm_shufflehi_epi16(_mm_shufflelo_epi16(sLow, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        __m128i aHigh = _mm_shufflehi_epi16(_mm_shufflelo_epi16(sHigh, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+
+        __m128i dLow = scaleChannelsSse2(_mm_unpacklo_epi8(d, zero), _mm_sub_epi16(full, aLow));
+        __m128i dHigh = scaleChannelsSse2(_mm_unpackhi_epi8(d, zero), _mm_sub_epi16(full, aHigh));
+        __m128i result = _mm_adds_epu8(s, _mm_packus_epi16(dLow, dHigh));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), result);
+    }
+    blendRowScalar(dst + i, src + i, count - i);
+}
+
+/**
+ * @brief Multiplies the 16 bit channels of d by 255 - alpha of the pixel and divides by 255
+ *
+ * @param d Channels widened to 16 bits
+ * @param inverseAlpha 255 - alpha, repeated in the 4 channels of every pixel
+ * @return __m256i
+ */
+TARGET_AVX2 static inline __m256i scaleChannelsAvx2(__m256i d, __m256i inverseAlpha){
+    __m256i x = _mm256_add_epi16(_mm256_mullo_epi16(d, inverseAlpha), _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+}
+
+/**
+ * @brief Blends premultiplied pixels over a row, 8 pixels at a time. Fully opaque and fully transparent groups skip the math
+ *
+ * @param dst
+ * @param src
+ * @param count
+ */
+TARGET_AVX2 static void blendRowAvx2(Uint32* dst, const Uint32* src, int count){
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i alphaMask = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+    const __m256i full = _mm256_set1_epi16(255);
+    int i = 0;
+    for(; i + 8 <= count; i += 8) {
+        __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i alpha = _mm256_and_si256(s, alphaMask);
+        if(_mm256_movemask_epi8(_mm256_cmpeq_epi32(alpha, alphaMask)) == -1) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), s);
+            continue;
+        }
+        if(_mm256_movemask_epi8(_mm256_cmpeq_epi32(s, zero)) == -1) {
+            continue;
+        }
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+
+        // unpack and pack work inside each 128 bit lane, so the pixel order is kept
+        __m256i sLow = _mm256_unpacklo_epi8(s, zero);
+        __m256i sHigh = _mm256_unpackhi_epi8(s, zero);
+        __m256i aLow = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(sLow, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        __m256i aHigh = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(sHigh, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+
+        __m256i dLow = scaleChannelsAvx2(_mm256_unpacklo_epi8(d, zero), _mm256_sub_epi16(full, aLow));
+        __m256i dHigh = scaleChannelsAvx2(_mm256_unpackhi_epi8(d, zero), _mm256_sub_epi16(full, aHigh));
+        __m256i result = _mm256_adds_epu8(s, _mm256_packus_epi16(dLow, dHigh));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), result);
+    }
+    blendRowScalar(dst + i, src + i, count - i);
+}
+
+#endif
+
+/**
+ * @brief Row blending function picked for the CPU at startup
+ */
+static void (*blendRow)(Uint32* dst, const Uint32* src, int count) = blendRowScalar;
+
+/**
+ * @brief Samples a row of a texture with nearest filtering
+ *
+ * @param out count pixels
+ * @param texture
+ * @param command Copy being drawn
+ * @param x First pixel of the target to sample for
+ * @param y Row of the target
+ * @param count
+ */
+static void sampleNearest(Uint32* out, const CpuTexture* texture, const CpuCommand& command, int x, int y, int count){
+    const SDL_Rect& src = command.src;
+    const SDL_Rect& dst = command.dst;
+    long long sy = src.y + (static_cast<long long>(2 * (y - dst.y) + 1) * src.h) / (2 * dst.h);
+    const Uint32* row = texture->pixels.data() + sy * texture->width;
+
+    // 16.16 fixed point position in the texture, at the center of each target pixel
+    long long step = (static_cast<long long>(src.w) << 16) / dst.w;
+    long long sx = (static_cast<long long>(src.x) << 16) + (x - dst.x) * step + step / 2;
+    for(int i = 0; i < count; i++) {
+        out[i] = row[sx >> 16];
+        sx += step;
+    }
+}
+
+/**
+ * @brief Samples a row of a texture with bilinear filtering. Taps outside the source area are clamped to its edge
+ *
+ * @param out count pixels
+ * @param texture
+ * @param command Copy being drawn
+ * @param x First pixel of the target to sample for
+ * @param y Row of the target
+ * @param count
+ */
+static void sampleLinear(Uint32* out, const CpuTexture* texture, const CpuCommand& command, int x, int y, int count){
+    const SDL_Rect& src = command.src;
+    const SDL_Rect& dst = command.dst;
+
+    // 16.16 fixed point, pixel centers of the target mapped to the texture
+    long long fy = (static_cast<long long>(2 * (y - dst.y) + 1) * src.h << 16) / (2 * dst.h) - 32768;
+    if(fy < 0) {
+        fy = 0;
+    }
+    int y0 = static_cast<int>(fy >> 16);
+    int y1 = y0 + 1 < src.h ? y0 + 1 : src.h - 1;
+    Uint32 wy = static_cast<Uint32>((fy >> 8) & 0xFF);
+    const Uint32* row0 = texture->pixels.data() + (src.y + y0) * texture->width + src.x;
+    const Uint32* row1 = texture->pixels.data() + (src.y + y1) * texture->width + src.x;
+
+    long long step = (static_cast<long long>(src.w) << 16) / dst.w;
+    long long fx = (static_cast<long long>(2 * (x - dst.x) + 1) * src.w << 16) / (2 * dst.w) - 32768;
+
+    // interpolate the two rows once over the columns the span reads, then each pixel is one horizontal lerp
+    int first = fx < 0 ? 0 : static_cast<int>(fx >> 16);
+    long long lastFx = fx + (count - 1) * step;
+    int last = lastFx < 0 ? 0 : static_cast<int>(lastFx >> 16) + 1;
+    if(first >= src.w) {
+        first = src.w - 1;
+    }
+    if(last >= src.w) {
+        last = src.w - 1;
+    }
+    thread_local std::vector<Uint32> columns;
+    if(columns.size() < static_cast<size_t>(last - first + 1)) {
+        columns.resize(last - first + 1);
+    }
+    for(int i = first; i <= last; i++) {
+        columns[i - first] = lerpPixel(row0[i], row1[i], wy);
+    }
+
+    const Uint32* column = columns.data() - first;
+    for(int i = 0; i < count; i++) {
+        long long clamped = fx < 0 ? 0 : fx;
+        int x0 = static_cast<int>(clamped >> 16);
+        if(x0 >= src.w) {
+            x0 = src.w - 1;
+        }
+        int x1 = x0 + 1 < src.w ? x0 + 1 : src.w - 1;
+        Uint32 wx = static_cast<Uint32>((clamped >> 8) & 0xFF);
+        out[i] = lerpPixel(column[x0], column[x1], wx);
+        fx += step;
+    }
+}
+
+/**
+ * @brief Samples a row of a rotated copy with nearest filtering. Pixels outside the rotated rectangle are transparent
+ *
+ * @param out count pixels
+ * @param texture
+ * @param command Copy being drawn
+ * @param x First pixel of the target to sample for
+ * @param y Row of the target
+ * @param count
+ */
+static void sampleRotated(Uint32* out, const CpuTexture* texture, const CpuCommand& command, int x, int y, int count){
+    const SDL_Rect& src = command.src;
+    const SDL_Rect& dst = command.dst;
+    float centerX = dst.x + dst.w * 0.5f;
+    float centerY = dst.y + dst.h * 0.5f;
+    float scaleX = static_cast<float>(src.w) / dst.w;
+    float scaleY = static_cast<float>(src.h) / dst.h;
+    float dy = y + 0.5f - centerY;
+
+    for(int i = 0; i < count; i++) {
+        // undo the clockwise rotation to get the position inside dst
+        float dx = x + i + 0.5f - centerX;
+        float u = dx * command.cosAngle + dy * command.sinAngle + dst.w * 0.5f;
+        float v = dy * command.cosAngle - dx * command.sinAngle + dst.h * 0.5f;
+        if(u < 0.0f || v < 0.0f || u >= dst.w || v >= dst.h) {
+            out[i] = 0;
+            continue;
+        }
+        if(command.flip & RENDER_FLIP_HORIZONTAL) {
+            u = dst.w - u;
+        }
+        if(command.flip & RENDER_FLIP_VERTICAL) {
+            v = dst.h - v;
+        }
+        int tx = std::min(static_cast<int>(u * scaleX), src.w - 1);
+        int ty = std::min(static_cast<int>(v * scaleY), src.h - 1);
+        out[i] = texture->pixels[static_cast<size_t>(src.y + ty) * texture->width + src.x + tx];
+    }
+}
+
+/**
+ * @brief Multiplies a row of premultiplied pixels by a tint. The color channels are also multiplied by the tint alpha, so they stay premultiplied
+ *
+ * @param pixels
+ * @param count
+ * @param tint
+ */
+static void modulateRow(Uint32* pixels, int count, SDL_Color tint){
+    // factors out of 256
+    Uint32 a = (tint.a * 256 + 127) / 255;
+    Uint32 r = (tint.r * tint.a * 256 + 32512) / 65025;
+    Uint32 g = (tint.g * tint.a * 256 + 32512) / 65025;
+    Uint32 b = (tint.b * tint.a * 256 + 32512) / 65025;
+    for(int i = 0; i < count; i++) {
+        Uint32 p = pixels[i];
+        if(p == 0) {
+            continue;
+        }
+        pixels[i] = ((((p >> 24) * a) >> 8) << 24) | (((((p >> 16) & 0xFF) * r) >> 8) << 16)
+            | (((((p >> 8) & 0xFF) * g) >> 8) << 8) | (((p & 0xFF) * b) >> 8);
+    }
+}
+
+/**
+ * @brief Construct a new Cpu Render Backend object
+ *
+ * @param window Window to show the frames in, nullptr to render offscreen
+ * @param width Width of the offscreen framebuffer, ignored with a window
+ * @param height Height of the offscreen framebuffer, ignored with a window
+ * @param logicalWidth Logical width of the screen
+ * @param logicalHeight Logical height of the screen
+ * @param threads Threads for the tiles, 0 for one per core
+ */
+CpuRenderBackend::CpuRenderBackend(SDL_Window* window, int width, int height, int logicalWidth, int logicalHeight, size_t threads)
+    : window(window), logicalWidth(logicalWidth), logicalHeight(logicalHeight), pool(threads) {
+#ifdef CPU_BACKEND_X86
+    if(SDL_HasAVX2()) {
+        blendRow = blendRowAvx2;
+        blendPath = "avx2";
+    }
+    else if(SDL_HasSSE2()) {
+        blendRow = blendRowSse2;
+        blendPath = "sse2";
+    }
+#endif
+
+    if(window) {
+        SDL_Surface* surface = SDL_GetWindowSurface(window);
+        if(surface) {
+            width = surface->w;
+            height = surface->h;
+        }
+        else {
+            SDL_Log("ERROR: Could not get the window surface. %s\n", SDL_GetError());
+        }
+    }
+    resizeScreen(width, height);
+    SDL_Log("CPU renderer: %dx%d, %zu threads, %s blending\n", width, height, pool.getThreadCount(), blendPath);
+}
+
+/**
+ * @brief Destroy the Cpu Render Backend object, waiting for the draws in flight
+ *
+ */
+CpuRenderBackend::~CpuRenderBackend(){
+    pool.wait();
+}
+
+/**
+ * @brief Resizes the framebuffer of the screen and fits the logical resolution in it, keeping the aspect ratio
+ *
+ * @param width
+ * @param height
+ */
+void CpuRenderBackend::resizeScreen(int width, int height){
+    flush();
+    screen.width = width > 0 ? width : 1;
+    screen.height = height > 0 ? height : 1;
+    screen.pixels.assign(static_cast<size_t>(screen.width) * screen.height, 0xFF000000);
+
+    screenScale = std::min(static_cast<float>(screen.width) / logicalWidth, static_cast<float>(screen.height) / logicalHeight);
+    viewport.w = static_cast<int>(logicalWidth * screenScale + 0.5f);
+    viewport.h = static_cast<int>(logicalHeight * screenScale + 0.5f);
+    viewport.x = (screen.width - viewport.w) / 2;
+    viewport.y = (screen.height - viewport.h) / 2;
+    if(!target) {
+        scaleX = screenScale;
+        scaleY = screenScale;
+    }
+}
+
+/**
+ * @brief Gets the texture draws go to
+ *
+ * @return CpuTexture*
+ */
+CpuTexture* CpuRenderBackend::currentTarget(){
+    return target ? target : &screen;
+}
+
+/**
+ * @brief Pixels of the current target logical coordinates map to (the viewport on the screen)
+ *
+ * @return SDL_Rect
+ */
+SDL_Rect CpuRenderBackend::targetBounds(){
+    if(target) {
+        return {0, 0, target->width, target->height};
+    }
+    return viewport;
+}
+
+/**
+ * @brief Converts a rectangle in logical units to pixels of the current target. Edges are rounded, so rectangles that touch keep touching
+ *
+ * @param rect
+ * @return SDL_Rect
+ */
+SDL_Rect CpuRenderBackend::toPixels(const SDL_Rect& rect){
+    SDL_Rect bounds = targetBounds();
+    int x0 = bounds.x + static_cast<int>(std::lround(rect.x * scaleX));
+    int y0 = bounds.y + static_cast<int>(std::lround(rect.y * scaleY));
+    int x1 = bounds.x + static_cast<int>(std::lround((rect.x + rect.w) * scaleX));
+    int y1 = bounds.y + static_cast<int>(std::lround((rect.y + rect.h) * scaleY));
+    return {x0, y0, x1 - x0, y1 - y0};
+}
+
+/**
+ * @brief Clips a rectangle in pixels to the current target and clip rectangle
+ *
+ * @param rect
+ * @param clipped
+ * @return true if something is left
+ * @return false
+ */
+bool CpuRenderBackend::clipToTarget(const SDL_Rect& rect, SDL_Rect* clipped){
+    CpuTexture* output = currentTarget();
+    SDL_Rect bounds = {0, 0, output->width, output->height};
+    if(!SDL_IntersectRect(&rect, &bounds, clipped)) {
+        return false;
+    }
+    if(clipEnabled) {
+        SDL_Rect clipPixels = toPixels(clip);
+        if(!SDL_IntersectRect(clipped, &clipPixels, clipped)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Creates an empty (transparent) texture. Every CPU texture can be drawn into
+ *
+ * @param width
+ * @param height
+ * @param target
+ * @param format Pixel format of the data that will be uploaded to it
+ * @return RenderTexture* nullptr on failure
+ */
+RenderTexture* CpuRenderBackend::createTexture(int width, int height, bool target, Uint32 format){
+    if(width <= 0 || height <= 0) {
+        SDL_Log("ERROR: Could not create a %dx%d texture\n", width, height);
+        return nullptr;
+    }
+    CpuTexture* texture = new CpuTexture();
+    texture->width = width;
+    texture->height = height;
+    texture->format = format;
+    texture->target = target;
+    texture->pixels.assign(static_cast<size_t>(width) * height, 0);
+    return texture;
+}
+
+/**
+ * @brief Creates a texture with the pixels of a surface
+ *
+ * @param surface
+ * @return RenderTexture* nullptr on failure
+ */
+RenderTexture* CpuRenderBackend::createTextureFromSurface(SDL_Surface* surface){
+    SDL_Surface* converted = surface;
+    if(surface->format->format != SDL_PIXELFORMAT_ARGB8888) {
+        converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+        if(!converted) {
+            SDL_Log("ERROR: Could not convert surface. %s\n", SDL_GetError());
+            return nullptr;
+        }
+    }
+
+    RenderTexture* texture = createTexture(converted->w, converted->h, false);
+    if(texture) {
+        updateTexture(texture, nullptr, converted->pixels, converted->pitch);
+    }
+    if(converted != surface) {
+        SDL_FreeSurface(converted);
+    }
+    return texture;
+}
+
+/**
+ * @brief Uploads pixels to a texture, converting them to premultiplied ARGB
+ *
+ * @param texture
+ * @param rect Area to update, nullptr for the whole texture
+ * @param pixels Pixels in the format of the texture
+ * @param pitch Bytes per row of pixels
+ * @return int 0 on success, -1 on failure
+ */
+int CpuRenderBackend::updateTexture(RenderTexture* texture, const SDL_Rect* rect, const void* pixels, int pitch){
+    // pending draws may read the old pixels
+    flush();
+
+    CpuTexture* cpuTexture = static_cast<CpuTexture*>(texture);
+    SDL_Rect area = rect ? *rect : SDL_Rect{0, 0, texture->width, texture->height};
+    SDL_Rect bounds = {0, 0, texture->width, texture->height};
+    if(!SDL_IntersectRect(&area, &bounds, &area)) {
+        return 0;
+    }
+
+    std::vector<Uint32> converted;
+    const Uint8* rows = static_cast<const Uint8*>(pixels);
+    if(texture->format != SDL_PIXELFORMAT_ARGB8888) {
+        converted.resize(static_cast<size_t>(area.w) * area.h);
+        if(SDL_ConvertPixels(area.w, area.h, texture->format, pixels, pitch, SDL_PIXELFORMAT_ARGB8888, converted.data(), area.w * 4) != 0) {
+            SDL_Log("ERROR: Could not convert texture pixels. %s\n", SDL_GetError());
+            return -1;
+        }
+        rows = reinterpret_cast<const Uint8*>(converted.data());
+        pitch = area.w * 4;
+    }
+
+    for(int y = 0; y < area.h; y++) {
+        const Uint32* in = reinterpret_cast<const Uint32*>(rows + static_cast<size_t>(y) * pitch);
+        Uint32* out = cpuTexture->pixels.data() + static_cast<size_t>(area.y + y) * texture->width + area.x;
+        for(int x = 0; x < area.w; x++) {
+            out[x] = premultiply(in[x]);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Destroys a texture
+ *
+ * @param texture
+ */
+void CpuRenderBackend::destroyTexture(RenderTexture* texture){
+    if(!texture) {
+        return;
+    }
+    flush();
+    if(target == texture) {
+        setTarget(nullptr);
+    }
+    delete static_cast<CpuTexture*>(texture);
+}
+
+/**
+ * @brief Sets how a texture is blended when it is drawn. Draws already recorded keep the old blending
+ *
+ * @param texture
+ * @param blend
+ */
+void CpuRenderBackend::setTextureBlend(RenderTexture* texture, RenderBlend blend){
+    texture->blend = blend;
+}
+
+/**
+ * @brief Sets how a texture is sampled when it is drawn scaled. Draws already recorded keep the old filter
+ *
+ * @param texture
+ * @param filter
+ */
+void CpuRenderBackend::setTextureFilter(RenderTexture* texture, RenderFilter filter){
+    texture->filter = filter;
+}
+
+/**
+ * @brief Every CPU texture can be drawn into
+ *
+ * @return true
+ */
+bool CpuRenderBackend::supportsTargets() const {
+    return true;
+}
+
+/**
+ * @brief Sets where the next draws go. The draws recorded for the previous target are executed first
+ *
+ * @param target Target texture, nullptr for the screen
+ * @return int 0
+ */
+int CpuRenderBackend::setTarget(RenderTexture* target){
+    flush();
+    this->target = static_cast<CpuTexture*>(target);
+    clipEnabled = false;
+    scaleX = target ? 1.0f : screenScale;
+    scaleY = target ? 1.0f : screenScale;
+    return 0;
+}
+
+/**
+ * @brief Gets the current target
+ *
+ * @return RenderTexture* nullptr for the screen
+ */
+RenderTexture* CpuRenderBackend::getTarget() const {
+    return target;
+}
+
+/**
+ * @brief Sets the scale from logical units to pixels of the current target
+ *
+ * @param scaleX
+ * @param scaleY
+ */
+void CpuRenderBackend::setScale(float scaleX, float scaleY){
+    this->scaleX = scaleX;
+    this->scaleY = scaleY;
+}
+
+/**
+ * @brief Gets the scale from logical units to pixels of the current target
+ *
+ * @param scaleX
+ * @param scaleY
+ */
+void CpuRenderBackend::getScale(float* scaleX, float* scaleY) const {
+    *scaleX = this->scaleX;
+    *scaleY = this->scaleY;
+}
+
+/**
+ * @brief Restricts the draws to a rectangle
+ *
+ * @param clip Rectangle in logical units, nullptr to draw everywhere
+ */
+void CpuRenderBackend::setClip(const SDL_Rect* clip){
+    clipEnabled = clip != nullptr;
+    if(clip) {
+        this->clip = *clip;
+    }
+}
+
+/**
+ * @brief Gets the clip rectangle
+ *
+ * @param clip
+ * @return true if clipping is enabled
+ * @return false
+ */
+bool CpuRenderBackend::getClip(SDL_Rect* clip) const {
+    *clip = clipEnabled ? this->clip : SDL_Rect{0, 0, 0, 0};
+    return clipEnabled;
+}
+
+/**
+ * @brief Fills the whole target with a color, ignoring the clip rectangle
+ *
+ * @param color
+ */
+void CpuRenderBackend::clear(SDL_Color color){
+    counters.fills++;
+    CpuTexture* output = currentTarget();
+    SDL_Rect bounds = {0, 0, output->width, output->height};
+    Uint32 pixel = premultiply((static_cast<Uint32>(color.a) << 24) | (color.r << 16) | (color.g << 8) | color.b);
+    commands.push_back({CPU_COMMAND_FILL, nullptr, bounds, bounds, bounds, pixel, RENDER_BLEND_NONE, RENDER_FILTER_NEAREST});
+    commandPixels += static_cast<size_t>(bounds.w) * bounds.h;
+    stats.commands++;
+}
+
+/**
+ * @brief Fills a rectangle with a color, overwriting the target
+ *
+ * @param rect Rectangle in logical units, nullptr for the whole target
+ * @param color
+ */
+void CpuRenderBackend::fillRect(const SDL_Rect* rect, SDL_Color color){
+    counters.fills++;
+    SDL_Rect area = rect ? toPixels(*rect) : targetBounds();
+    SDL_Rect clipped;
+    if(!clipToTarget(area, &clipped)) {
+        return;
+    }
+    Uint32 pixel = premultiply((static_cast<Uint32>(color.a) << 24) | (color.r << 16) | (color.g << 8) | color.b);
+    commands.push_back({CPU_COMMAND_FILL, nullptr, clipped, clipped, clipped, pixel, RENDER_BLEND_NONE, RENDER_FILTER_NEAREST});
+    commandPixels += static_cast<size_t>(clipped.w) * clipped.h;
+    stats.commands++;
+}
+
+/**
+ * @brief Draws a texture. The draw is recorded and executed on the next flush
+ *
+ * @param texture
+ * @param src Area of the texture, nullptr for all of it
+ * @param dst Area of the target in logical units, nullptr for all of it
+ */
+void CpuRenderBackend::copy(RenderTexture* texture, const SDL_Rect* src, const SDL_Rect* dst){
+    countDraw(texture);
+    if(!texture || texture == target) {
+        return;
+    }
+    SDL_Rect source = {0, 0, texture->width, texture->height};
+    if(src) {
+        SDL_Rect bounds = source;
+        if(!SDL_IntersectRect(src, &bounds, &source)) {
+            return;
+        }
+    }
+    SDL_Rect area = dst ? toPixels(*dst) : targetBounds();
+    SDL_Rect clipped;
+    if(area.w <= 0 || area.h <= 0 || !clipToTarget(area, &clipped)) {
+        return;
+    }
+
+    commands.push_back({CPU_COMMAND_COPY, static_cast<CpuTexture*>(texture), source, area, clipped, 0, texture->blend, texture->filter});
+    commandPixels += static_cast<size_t>(clipped.w) * clipped.h;
+    stats.commands++;
+}
+
+/**
+ * @brief Draws a texture tinted, faded, mirrored or rotated. The draw is recorded and executed on the next flush
+ *
+ * @param texture
+ * @param src Area of the texture, nullptr for all of it
+ * @param dst Area of the target in logical units, nullptr for all of it
+ * @param state
+ */
+void CpuRenderBackend::copyEx(RenderTexture* texture, const SDL_Rect* src, const SDL_Rect* dst, const RenderState& state){
+    if(state.isDefault()) {
+        copy(texture, src, dst);
+        return;
+    }
+    countDraw(texture);
+    if(!texture || texture == target || state.tint.a == 0) {
+        return;
+    }
+    SDL_Rect source = {0, 0, texture->width, texture->height};
+    if(src) {
+        SDL_Rect bounds = source;
+        if(!SDL_IntersectRect(src, &bounds, &source)) {
+            return;
+        }
+    }
+    SDL_Rect area = dst ? toPixels(*dst) : targetBounds();
+    SDL_Rect clipped;
+    if(area.w <= 0 || area.h <= 0 || !clipToTarget(rotatedBounds(area, state.angle), &clipped)) {
+        return;
+    }
+
+    CpuCommand command = {CPU_COMMAND_COPY, static_cast<CpuTexture*>(texture), source, area, clipped, 0, texture->blend, texture->filter};
+    command.tint = state.tint;
+    command.flip = state.flip;
+    if(state.angle != 0.0f) {
+        float radians = state.angle * static_cast<float>(M_PI) / 180.0f;
+        command.rotated = true;
+        command.cosAngle = std::cos(radians);
+        command.sinAngle = std::sin(radians);
+        command.blend = RENDER_BLEND_ALPHA;
+    }
+    commands.push_back(command);
+    commandPixels += static_cast<size_t>(clipped.w) * clipped.h;
+    stats.commands++;
+}
+
+/**
+ * @brief Executes the draws recorded for one tile of the target, in the order they were recorded
+ *
+ * @param output Target
+ * @param tile Pixels of the tile
+ */
+void CpuRenderBackend::runTile(CpuTexture* output, const SDL_Rect& tile){
+    thread_local std::vector<Uint32> rowBuffer;
+
+    for(const CpuCommand& command : commands) {
+        SDL_Rect area;
+        if(!SDL_IntersectRect(&command.clip, &tile, &area)) {
+            continue;
+        }
+
+        if(command.type == CPU_COMMAND_FILL) {
+            for(int y = area.y; y < area.y + area.h; y++) {
+                Uint32* out = output->pixels.data() + static_cast<size_t>(y) * output->width + area.x;
+                std::fill(out, out + area.w, command.color);
+            }
+            continue;
+        }
+
+        const CpuTexture* texture = command.texture;
+        const SDL_Rect& dst = command.dst;
+        bool unscaled = command.src.w == dst.w && command.src.h == dst.h;
+        bool modulated = command.tint.r != 255 || command.tint.g != 255 || command.tint.b != 255 || command.tint.a != 255;
+        bool direct = unscaled && !modulated && !command.rotated && command.flip == RENDER_FLIP_NONE;
+        if(!direct && rowBuffer.size() < static_cast<size_t>(area.w)) {
+            rowBuffer.resize(area.w);
+        }
+        for(int y = area.y; y < area.y + area.h; y++) {
+            Uint32* out = output->pixels.data() + static_cast<size_t>(y) * output->width + area.x;
+            const Uint32* in;
+            if(direct) {
+                in = texture->pixels.data() + static_cast<size_t>(command.src.y + y - dst.y) * texture->width
+                    + command.src.x + area.x - dst.x;
+            }
+            else {
+                if(command.rotated) {
+                    sampleRotated(rowBuffer.data(), texture, command, area.x, y, area.w);
+                }
+                else {
+                    // a mirrored row is the row on the other side of dst, sampled and reversed
+                    int sampleY = command.flip & RENDER_FLIP_VERTICAL ? 2 * dst.y + dst.h - 1 - y : y;
+                    int sampleX = command.flip & RENDER_FLIP_HORIZONTAL ? 2 * dst.x + dst.w - area.x - area.w : area.x;
+                    if(!unscaled && command.filter == RENDER_FILTER_LINEAR) {
+                        sampleLinear(rowBuffer.data(), texture, command, sampleX, sampleY, area.w);
+                    }
+                    else {
+                        sampleNearest(rowBuffer.data(), texture, command, sampleX, sampleY, area.w);
+                    }
+                    if(command.flip & RENDER_FLIP_HORIZONTAL) {
+                        std::reverse(rowBuffer.begin(), rowBuffer.begin() + area.w);
+                    }
+                }
+                if(modulated) {
+                    modulateRow(rowBuffer.data(), area.w, command.tint);
+                }
+                in = rowBuffer.data();
+            }
+
+            if(command.blend == RENDER_BLEND_NONE) {
+                memcpy(out, in, static_cast<size_t>(area.w) * sizeof(Uint32));
+            }
+            else {
+                blendRow(out, in, area.w);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Executes the recorded draws. Big flushes are split into tiles that run in parallel
+ *
+ */
+void CpuRenderBackend::flush(){
+    if(commands.empty()) {
+        return;
+    }
+    CpuTexture* output = currentTarget();
+    stats.flushes++;
+    stats.pixels += commandPixels;
+
+    int tiles = (output->height + CPU_TILE_HEIGHT - 1) / CPU_TILE_HEIGHT;
+    if(commandPixels < CPU_PARALLEL_MIN_PIXELS || pool.getThreadCount() < 2 || tiles < 2) {
+        runTile(output, {0, 0, output->width, output->height});
+    }
+    else {
+        stats.parallelFlushes++;
+        for(int i = 0; i < tiles; i++) {
+            SDL_Rect tile = {0, i * CPU_TILE_HEIGHT, output->width, std::min(CPU_TILE_HEIGHT, output->height - i * CPU_TILE_HEIGHT)};
+            pool.submit([this, output, tile]{
+                runTile(output, tile);
+            });
+        }
+        pool.wait();
+    }
+
+    commands.clear();
+    commandPixels = 0;
+}
+
+/**
+ * @brief Executes every recorded draw, so the framebuffers are up to date
+ *
+ */
+void CpuRenderBackend::finish(){
+    flush();
+}
+
+/**
+ * @brief Executes the draws of the frame and copies the screen framebuffer to the window surface
+ *
+ */
+void CpuRenderBackend::present(){
+    if(target) {
+        setTarget(nullptr);
+    }
+    flush();
+    if(!window) {
+        return;
+    }
+
+    SDL_Surface* surface = SDL_GetWindowSurface(window);
+    if(!surface) {
+        return;
+    }
+    if(surface->w != screen.width || surface->h != screen.height) {
+        // the window changed size and the event did not arrive yet
+        resizeScreen(surface->w, surface->h);
+        return;
+    }
+
+    if(SDL_MUSTLOCK(surface)) {
+        SDL_LockSurface(surface);
+    }
+    Uint32 format = surface->format->format;
+    if(format == SDL_PIXELFORMAT_ARGB8888 || format == SDL_PIXELFORMAT_RGB888) {
+        // the screen is opaque, so its premultiplied pixels are the straight ones
+        for(int y = 0; y < screen.height; y++) {
+            memcpy(static_cast<Uint8*>(surface->pixels) + static_cast<size_t>(y) * surface->pitch,
+                screen.pixels.data() + static_cast<size_t>(y) * screen.width, static_cast<size_t>(screen.width) * sizeof(Uint32));
+        }
+    }
+    else {
+        SDL_ConvertPixels(screen.width, screen.height, SDL_PIXELFORMAT_ARGB8888, screen.pixels.data(), screen.width * 4,
+            format, surface->pixels, surface->pitch);
+    }
+    if(SDL_MUSTLOCK(surface)) {
+        SDL_UnlockSurface(surface);
+    }
+    SDL_UpdateWindowSurface(window);
+}
+
+/**
+ * @brief Resizes the framebuffer with the window and maps mouse coordinates from window pixels to logical units
+ *
+ * @param e
+ */
+void CpuRenderBackend::handleEvent(SDL_Event& e){
+    if(!window) {
+        return;
+    }
+
+    if(e.type == SDL_WINDOWEVENT && e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED) {
+        SDL_Surface* surface = SDL_GetWindowSurface(window);
+        if(surface) {
+            resizeScreen(surface->w, surface->h);
+        }
+        return;
+    }
+
+    int* x = nullptr;
+    int* y = nullptr;
+    if(e.type == SDL_MOUSEBUTTONDOWN || e.type == SDL_MOUSEBUTTONUP) {
+        x = &e.button.x;
+        y = &e.button.y;
+    }
+    else if(e.type == SDL_MOUSEMOTION) {
+        x = &e.motion.x;
+        y = &e.motion.y;
+    }
+    if(!x) {
+        return;
+    }
+
+    // window coordinates can be smaller than pixels on high-DPI displays
+    int windowWidth, windowHeight;
+    SDL_GetWindowSize(window, &windowWidth, &windowHeight);
+    float pixelsX = windowWidth > 0 ? static_cast<float>(screen.width) / windowWidth : 1.0f;
+    float pixelsY = windowHeight > 0 ? static_cast<float>(screen.height) / windowHeight : 1.0f;
+    *x = static_cast<int>((*x * pixelsX - viewport.x) / screenScale);
+    *y = static_cast<int>((*y * pixelsY - viewport.y) / screenScale);
+}
+
+/**
+ * @brief Logs the counters of the backend
+ *
+ */
+void CpuRenderBackend::logStats() const {
+    SDL_Log("CPU renderer: %llu draws, %llu flushes (%llu in parallel), %llu pixels written, %s blending on %zu threads\n",
+        stats.commands, stats.flushes, stats.parallelFlushes, stats.pixels, blendPath, pool.getThreadCount());
+}
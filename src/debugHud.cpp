@@ -0,0 +1,246 @@
+/**
+ * @file debugHud.cpp
+ * @author Iván Mansilla
+ * @brief On-screen performance overlay and overdraw heatmap.
+ * @version 0.1
+ * @date 2025-08-03
+ *
+ *
+ */
+
+#include "../inc/debugHud.h"
+#include "../inc/objects.h"
+#include "../inc/textureManager.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+
+/**
+ * Heatmap colors by number of writes: 1 blue, 2 green, 3 yellow, 4 orange, 5 or more red (ARGB, without alpha)
+ */
+static const Uint32 HEATMAP_COLORS[] = {0x000000, 0x2040FF, 0x20C040, 0xE0E020, 0xFF8020, 0xFF2020};
+static const int HEATMAP_LEVELS = sizeof(HEATMAP_COLORS) / sizeof(HEATMAP_COLORS[0]);
+
+/**
+ * @brief Construct a new Overdraw Map object
+ *
+ * @param width
+ * @param height
+ */
+OverdrawMap::OverdrawMap(int width, int height) : counts(static_cast<size_t>(width) * height, 0), width(width), height(height) {
+}
+
+/**
+ * @brief Sets every count to 0
+ *
+ */
+void OverdrawMap::clear(){
+    std::fill(counts.begin(), counts.end(), 0);
+}
+
+/**
+ * @brief Counts a write of every pixel of a rectangle
+ *
+ * @param rect Area drawn
+ * @param region Clip the area was drawn with (optional)
+ */
+void OverdrawMap::add(const SDL_Rect& rect, const SDL_Rect* region){
+    SDL_Rect area = {0, 0, width, height};
+    if(region && !SDL_IntersectRect(&area, region, &area)) {
+        return;
+    }
+    SDL_Rect drawn;
+    if(!SDL_IntersectRect(&rect, &area, &drawn)) {
+        return;
+    }
+    for(int y = drawn.y; y < drawn.y + drawn.h; y++) {
+        Uint16* row = &counts[static_cast<size_t>(y) * width + drawn.x];
+        for(int x = 0; x < drawn.w; x++) {
+            if(row[x] < UINT16_MAX) {
+                row[x]++;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Construct a new Debug Hud object
+ *
+ * @param backend
+ * @param font
+ */
+DebugHud::DebugHud(RenderBackend* backend, TTF_Font** font) : backend(backend), font(font), overdraw(SCREEN_WIDTH, SCREEN_HEIGHT) {
+}
+
+/**
+ * @brief Destroy the Debug Hud object
+ *
+ */
+DebugHud::~DebugHud(){
+    release();
+}
+
+/**
+ * @brief Destroys the heatmap and the counters text. Called before the renderer they belong to is destroyed
+ *
+ */
+void DebugHud::release(){
+    if(heatmap) {
+        backend->destroyTexture(heatmap);
+        heatmap = nullptr;
+    }
+    heatmapPixels.clear();
+    text.reset();
+    framesSinceText = DEBUG_HUD_TEXT_INTERVAL;
+}
+
+/**
+ * @brief Adds the time of a frame to the graph
+ *
+ * @param milliseconds
+ */
+void DebugHud::addFrameTime(float milliseconds){
+    frameTimes[nextFrame] = milliseconds;
+    nextFrame = (nextFrame + 1) % DEBUG_HUD_GRAPH_SIZE;
+}
+
+/**
+ * @brief Starts counting the work of a frame. Call it right before the scene is rendered
+ *
+ * @param objManager The overdraw of its draws is counted while the heatmap is shown
+ */
+void DebugHud::beginFrame(ObjectManager& objManager){
+    backend->resetCounters();
+    if(showHeatmap) {
+        overdraw.clear();
+        objManager.overdraw = &overdraw;
+    }
+    else {
+        objManager.overdraw = nullptr;
+    }
+}
+
+/**
+ * @brief Draws the overlay on the screen. Call it after the scene is rendered and before the frame is presented
+ *
+ * @param objManager
+ * @param textureManager
+ */
+void DebugHud::draw(ObjectManager& objManager, TextureManager& textureManager){
+    // the overlay's own draws are not part of the frame it reports
+    frameCounters = backend->getCounters();
+
+    if(showHeatmap) {
+        drawHeatmap();
+    }
+    if(!visible) {
+        return;
+    }
+
+    if(++framesSinceText >= DEBUG_HUD_TEXT_INTERVAL) {
+        refreshText(objManager, textureManager);
+        framesSinceText = 0;
+    }
+
+    int textWidth = text ? text->width : 0;
+    int textHeight = text ? text->height : 0;
+    int panelWidth = std::max(DEBUG_HUD_GRAPH_SIZE * 2, textWidth) + 8;
+    SDL_Rect panel = {SCREEN_WIDTH - panelWidth - 10, 10, panelWidth, textHeight + DEBUG_HUD_GRAPH_HEIGHT + 12};
+    backend->fillRect(&panel, {0, 0, 0, 255});
+
+    if(text) {
+        RenderTexture* texture = text->render(backend, {255, 255, 255, 255});
+        if(texture) {
+            SDL_Rect dst = {panel.x + 4, panel.y + 4, text->width, text->height};
+            backend->copy(texture, nullptr, &dst);
+        }
+    }
+    drawGraph(panel.x + 4, panel.y + textHeight + 8);
+}
+
+/**
+ * @brief Rebuilds the counters text
+ *
+ * @param objManager
+ * @param textureManager
+ */
+void DebugHud::refreshText(ObjectManager& objManager, TextureManager& textureManager){
+    float average = 0.0f;
+    float worst = 0.0f;
+    for(float time : frameTimes) {
+        average += time;
+        worst = std::max(worst, time);
+    }
+    average /= DEBUG_HUD_GRAPH_SIZE;
+
+    const TextureCacheStats& cache = textureManager.getCacheStats();
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer),
+        "frame %.1f ms (max %.1f)\ndraws %llu, texture switches %llu, fills %llu\nobjects %d, active %d, clickable %d\ntextures %d/%d, %.1f MB",
+        average, worst, frameCounters.draws, frameCounters.textureSwitches, frameCounters.fills,
+        static_cast<int>(objManager.allObjects.size()), static_cast<int>(objManager.activeObjects.size()),
+        static_cast<int>(objManager.clickActiveObjects.size()), cache.residentTextures, cache.knownTextures,
+        cache.residentBytes / (1024.0 * 1024.0));
+
+    // a new layout, the old one destroys its texture
+    text = std::make_unique<TextLayout>();
+    if(!font || text->build(buffer, *font, 0, TEXT_ALIGN_LEFT) != 0) {
+        text.reset();
+    }
+}
+
+/**
+ * @brief Draws the frame time graph, oldest frame on the left. A line marks 60 fps
+ *
+ * @param x
+ * @param y
+ */
+void DebugHud::drawGraph(int x, int y){
+    SDL_Rect background = {x, y, DEBUG_HUD_GRAPH_SIZE * 2, DEBUG_HUD_GRAPH_HEIGHT};
+    backend->fillRect(&background, {40, 40, 40, 255});
+
+    for(int i = 0; i < DEBUG_HUD_GRAPH_SIZE; i++) {
+        float time = frameTimes[(nextFrame + i) % DEBUG_HUD_GRAPH_SIZE];
+        int height = static_cast<int>(std::min(time / DEBUG_HUD_GRAPH_MAX_MS, 1.0f) * DEBUG_HUD_GRAPH_HEIGHT);
+        if(height <= 0) {
+            continue;
+        }
+        SDL_Color color = time <= 1000.0f / 60.0f ? SDL_Color{60, 200, 60, 255}
+            : time <= 1000.0f / 30.0f ? SDL_Color{220, 200, 40, 255} : SDL_Color{230, 50, 50, 255};
+        SDL_Rect bar = {x + i * 2, y + DEBUG_HUD_GRAPH_HEIGHT - height, 2, height};
+        backend->fillRect(&bar, color);
+    }
+
+    int target = static_cast<int>((1000.0f / 60.0f) / DEBUG_HUD_GRAPH_MAX_MS * DEBUG_HUD_GRAPH_HEIGHT);
+    SDL_Rect line = {x, y + DEBUG_HUD_GRAPH_HEIGHT - target, DEBUG_HUD_GRAPH_SIZE * 2, 1};
+    backend->fillRect(&line, {200, 200, 200, 255});
+}
+
+/**
+ * @brief Draws the overdraw of the last scene over it. Pixels written once are blue, the more writes the redder
+ *
+ */
+void DebugHud::drawHeatmap(){
+    int width = overdraw.getWidth();
+    int height = overdraw.getHeight();
+    if(!heatmap) {
+        heatmap = backend->createTexture(width, height, false);
+        if(!heatmap) {
+            SDL_Log("ERROR: Could not create the overdraw heatmap texture.\n");
+            showHeatmap = false;
+            return;
+        }
+        backend->setTextureBlend(heatmap, RENDER_BLEND_ALPHA);
+        heatmapPixels.resize(static_cast<size_t>(width) * height);
+    }
+
+    for(int y = 0; y < height; y++) {
+        Uint32* row = &heatmapPixels[static_cast<size_t>(y) * width];
+        for(int x = 0; x < width; x++) {
+            int writes = std::min(overdraw.get(x, y), HEATMAP_LEVELS - 1);
+            row[x] = writes == 0 ? 0 : (static_cast<Uint32>(DEBUG_HUD_HEATMAP_ALPHA) << 24) | HEATMAP_COLORS[writes];
+        }
+    }
+    backend->updateTexture(heatmap, nullptr, heatmapPixels.data(), width * static_cast<int>(sizeof(Uint32)));
+    backend->copy(heatmap, nullptr, nullptr);
+}
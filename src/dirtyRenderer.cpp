@@ -0,0 +1,276 @@
+/**
+ * @file dirtyRenderer.cpp
+ * @author Iván Mansilla
+ * @brief Dirty-rectangle rendering with a cached scene layer.
+ * @version 0.1
+ * @date 2025-07-20
+ *
+ *
+ */
+
+#include "../inc/dirtyRenderer.h"
+#include "../inc/text.h"
+
+/**
+ * @brief If the dirty areas cover more than this fraction of the screen a full redraw is cheaper
+ *
+ */
+static const float FULL_REDRAW_THRESHOLD = 0.6f;
+
+/**
+ * @brief Construct a new Dirty Rect Renderer object
+ *
+ * @param backend Render backend to draw with
+ * @param width Width of the scene
+ * @param height Height of the scene
+ */
+DirtyRectRenderer::DirtyRectRenderer(RenderBackend* backend, int width, int height){
+    this->backend = backend;
+    this->width = width;
+    this->height = height;
+}
+
+/**
+ * @brief Destroy the Dirty Rect Renderer object and its cached layer
+ *
+ */
+DirtyRectRenderer::~DirtyRectRenderer(){
+    release();
+}
+
+/**
+ * @brief Destroys the cached layer. Called before the renderer it belongs to is destroyed, later frames are fully
+ * redrawn until init() creates it again
+ *
+ */
+void DirtyRectRenderer::release(){
+    if(sceneLayer) {
+        backend->destroyTexture(sceneLayer);
+        sceneLayer = nullptr;
+    }
+    layerWidth = 0;
+    layerHeight = 0;
+    fullRedraw = true;
+}
+
+/**
+ * @brief Creates the render target that caches the scene. If render targets are not supported the renderer falls back to full redraws.
+ *
+ * @return int 0 on success, -1 if the cached layer could not be created.
+ */
+int DirtyRectRenderer::init(){
+    if(!backend->supportsTargets()) {
+        SDL_Log("ERROR: Render targets not supported, dirty-rect rendering disabled.\n");
+        enabled = false;
+        return -1;
+    }
+    return createLayer();
+}
+
+/**
+ * @brief (Re)creates the cached layer with the size the scene has on the screen. The scale comes from the logical size of the renderer, so it must be called with the screen as the target
+ *
+ * @return int 0 on success, -1 if the cached layer could not be created.
+ */
+int DirtyRectRenderer::createLayer(){
+    backend->getScale(&scaleX, &scaleY);
+    if(scaleX <= 0.0f || scaleY <= 0.0f) {
+        scaleX = 1.0f;
+        scaleY = 1.0f;
+    }
+    int newWidth = static_cast<int>(width * scaleX + 0.5f);
+    int newHeight = static_cast<int>(height * scaleY + 0.5f);
+    fullRedraw = true;
+    if(sceneLayer && newWidth == layerWidth && newHeight == layerHeight) {
+        return 0;
+    }
+
+    if(sceneLayer) {
+        backend->destroyTexture(sceneLayer);
+    }
+    layerWidth = newWidth;
+    layerHeight = newHeight;
+    sceneLayer = backend->createTexture(layerWidth, layerHeight, true);
+    if(!sceneLayer) {
+        SDL_Log("ERROR: Could not create scene layer.\n");
+        enabled = false;
+        return -1;
+    }
+    // The layer is opaque, copying it to the screen does not need blending
+    backend->setTextureBlend(sceneLayer, RENDER_BLEND_NONE);
+    SDL_Log("Scene layer %dx%d (scale %.2fx%.2f)\n", layerWidth, layerHeight, scaleX, scaleY);
+    return 0;
+}
+
+/**
+ * @brief Forces the whole scene to be recomposited on the next frame
+ *
+ */
+void DirtyRectRenderer::invalidate(){
+    fullRedraw = true;
+}
+
+/**
+ * @brief Handles events that make the cached layer invalid (e.g. the graphics device was reset or the window was resized)
+ *
+ * @param e
+ */
+void DirtyRectRenderer::handleEvent(SDL_Event& e){
+    if(e.type == SDL_RENDER_TARGETS_RESET || e.type == SDL_RENDER_DEVICE_RESET) {
+        invalidate();
+    }
+    else if(e.type == SDL_WINDOWEVENT && e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED && sceneLayer) {
+        // the scale of the logical size already follows the new window size
+        createLayer();
+    }
+}
+
+/**
+ * @brief Collects the areas changed since the last frame: the old and new rectangles of every dirty object and the areas left by destroyed ones.
+ *
+ * @param objManager
+ */
+void DirtyRectRenderer::collectDirtyRects(ObjectManager& objManager){
+    dirtyRects.clear();
+    objManager.updateTransforms();
+
+    for(auto& rect : objManager.damagedRects) {
+        dirtyRects.push_back(rect);
+    }
+    objManager.damagedRects.clear();
+
+    for(auto& root : objManager.rootObjects) {
+        collectSubtree(root, true);
+    }
+}
+
+/**
+ * @brief Collects the dirty rectangles of an object and of its dirty descendants. Clean subtrees are not visited.
+ *
+ * @param obj
+ * @param parentVisible Whether all the ancestors of the object are active
+ */
+void DirtyRectRenderer::collectSubtree(Object* obj, bool parentVisible){
+    if(!obj->isDirty && !obj->hasDirtyChildren) {
+        return;
+    }
+
+    bool visible = parentVisible && obj->isActive;
+    if(obj->isDirty) {
+        if(obj->wasDrawn) {
+            dirtyRects.push_back(obj->lastDrawnRect);
+        }
+        obj->lastDrawnRect = obj->getDrawnRect();
+        obj->wasDrawn = visible;
+        if(obj->wasDrawn) {
+            dirtyRects.push_back(obj->lastDrawnRect);
+        }
+        obj->isDirty = false;
+    }
+
+    if(obj->hasDirtyChildren) {
+        for(auto& child : obj->children) {
+            collectSubtree(child, visible);
+        }
+        obj->hasDirtyChildren = false;
+    }
+}
+
+/**
+ * @brief Clips the dirty rectangles to the screen and merges the overlapping ones, so no pixel is recomposited twice.
+ *
+ */
+void DirtyRectRenderer::mergeDirtyRects(){
+    SDL_Rect screen = {0, 0, width, height};
+
+    std::vector<SDL_Rect> merged;
+    for(auto& rect : dirtyRects) {
+        SDL_Rect clipped;
+        if(SDL_IntersectRect(&rect, &screen, &clipped)) {
+            merged.push_back(clipped);
+        }
+    }
+
+    // Keep merging until no two rectangles overlap
+    bool changed = true;
+    while(changed) {
+        changed = false;
+        for(size_t i = 0; i < merged.size() && !changed; i++) {
+            for(size_t j = i + 1; j < merged.size(); j++) {
+                if(SDL_HasIntersection(&merged[i], &merged[j])) {
+                    SDL_UnionRect(&merged[i], &merged[j], &merged[i]);
+                    merged.erase(merged.begin() + j);
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    int area = 0;
+    for(auto& rect : merged) {
+        area += rect.w * rect.h;
+    }
+    if(area > FULL_REDRAW_THRESHOLD * width * height) {
+        fullRedraw = true;
+    }
+
+    dirtyRects.swap(merged);
+}
+
+/**
+ * @brief Clears a region of the current target and redraws every visible object and text that intersects it.
+ *
+ * @param objManager
+ * @param textureManager
+ * @param region Region to redraw
+ */
+void DirtyRectRenderer::drawRegion(ObjectManager& objManager, TextureManager& textureManager, const SDL_Rect* region){
+    backend->setClip(region);
+    backend->fillRect(region, {0, 0, 0, 255});
+
+    objManager.drawActiveObjects(textureManager, region);
+    objManager.drawAllTexts(backend, region);
+}
+
+/**
+ * @brief Renders a frame. Only the dirty areas of the cached scene are recomposited, then the scene is copied to the screen. The caller presents the frame.
+ *
+ * @param objManager
+ * @param textureManager
+ */
+void DirtyRectRenderer::renderFrame(ObjectManager& objManager, TextureManager& textureManager){
+    collectDirtyRects(objManager);
+
+    if(!enabled || !sceneLayer) {
+        backend->clear({0, 0, 0, 255});
+        objManager.drawActiveObjects(textureManager);
+        objManager.drawAllTexts(backend);
+        lastDirtyArea = width * height;
+        fullRedraw = true;
+        return;
+    }
+
+    mergeDirtyRects();
+
+    // the layer is in pixels, objects are drawn in logical coordinates scaled to it
+    backend->setTarget(sceneLayer);
+    backend->setScale(scaleX, scaleY);
+    if(fullRedraw) {
+        SDL_Rect screen = {0, 0, width, height};
+        drawRegion(objManager, textureManager, &screen);
+        lastDirtyArea = width * height;
+        fullRedraw = false;
+    }
+    else {
+        lastDirtyArea = 0;
+        for(auto& rect : dirtyRects) {
+            drawRegion(objManager, textureManager, &rect);
+            lastDirtyArea += rect.w * rect.h;
+        }
+    }
+    backend->setClip(nullptr);
+    backend->setTarget(nullptr);
+
+    backend->copy(sceneLayer, nullptr, nullptr);
+}
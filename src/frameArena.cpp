@@ -0,0 +1,129 @@
+/**
+ * @file frameArena.cpp
+ * @author Iván Mansilla
+ * @brief Frame-scoped bump allocator.
+ * @version 0.1
+ * @date 2025-07-26
+ *
+ *
+ */
+
+#include "../inc/frameArena.h"
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+/**
+ * @brief Construct a new Frame Arena object
+ *
+ * @param initialSize Capacity of the first block
+ */
+FrameArena::FrameArena(size_t initialSize){
+    blocks.reserve(8);
+    addBlock(initialSize);
+}
+
+/**
+ * @brief Destroy the Frame Arena object, freeing its blocks
+ *
+ */
+FrameArena::~FrameArena(){
+    for(auto& block : blocks) {
+        free(block.data);
+    }
+}
+
+/**
+ * @brief Adds a block to the arena
+ *
+ * @param size
+ */
+void FrameArena::addBlock(size_t size){
+    char* data = static_cast<char*>(malloc(size));
+    if(!data) {
+        throw std::bad_alloc();
+    }
+    blocks.push_back({data, size});
+}
+
+/**
+ * @brief Takes memory from the current block, chaining a new block if it does not fit
+ *
+ * @param bytes
+ * @param alignment
+ * @return void*
+ */
+void* FrameArena::do_allocate(size_t bytes, size_t alignment){
+    size_t padding = (alignment - reinterpret_cast<uintptr_t>(blocks[currentBlock].data + offset) % alignment) % alignment;
+
+    if(offset + padding + bytes > blocks[currentBlock].size) {
+        currentBlock++;
+        if(currentBlock == blocks.size()) {
+            size_t size = blocks.back().size * 2;
+            while(size < bytes + alignment) {
+                size *= 2;
+            }
+            addBlock(size);
+            growths++;
+        }
+        offset = 0;
+        padding = (alignment - reinterpret_cast<uintptr_t>(blocks[currentBlock].data) % alignment) % alignment;
+    }
+
+    void* ptr = blocks[currentBlock].data + offset + padding;
+    offset += padding + bytes;
+    usedBytes += bytes;
+    return ptr;
+}
+
+/**
+ * @brief Does nothing, memory is reclaimed by reset()
+ *
+ */
+void FrameArena::do_deallocate(void*, size_t, size_t){
+}
+
+/**
+ * @brief Memory of an arena can only be released by the same arena
+ *
+ * @param other
+ * @return true
+ * @return false
+ */
+bool FrameArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+/**
+ * @brief Releases everything allocated since the last reset. If extra blocks were needed they are merged into one, so next frames fit in a single block.
+ *
+ */
+void FrameArena::reset(){
+    if(usedBytes > highWater) {
+        highWater = usedBytes;
+    }
+
+    if(blocks.size() > 1) {
+        size_t total = 0;
+        for(auto& block : blocks) {
+            total += block.size;
+            free(block.data);
+        }
+        blocks.clear();
+        addBlock(total);
+    }
+
+    currentBlock = 0;
+    offset = 0;
+    usedBytes = 0;
+}
+
+/**
+ * @brief Gets the frame arena of the calling thread. The thread that owns the frame loop resets it at the end of each frame
+ *
+ * @return FrameArena&
+ */
+FrameArena& frameArena(){
+    thread_local FrameArena arena;
+    return arena;
+}
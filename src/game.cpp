@@ -0,0 +1,240 @@
+/**
+ * @file game.cpp
+ * @author Iván Mansilla
+ * @brief Game state and rules.
+ * @version 0.1
+ * @date 2025-07-27
+ *
+ *
+ */
+
+#include "../inc/game.h"
+#include <cstdio>
+
+/**
+ * @brief Construct a new Game object, creating the store and its items
+ *
+ */
+Game::Game()
+: player(), objectManager(), clicky(&player, &objectManager), store(310, 10, 300, 400, "store", &objectManager) {
+    objectManager.activateObject("Store");
+    store.scheduler = &scheduler;
+
+    // every purchase adds 1 to the points per click
+    ItemEffect plusOne;
+    plusOne.stat = STAT_MULTIPLIER;
+    plusOne.type = MODIFIER_ADD;
+    plusOne.amount = 1.0;
+
+    const char* itemIds[] = {"example_item", "example_item2", "example_item3"};
+    for(const char* itemId : itemIds) {
+        items.push_back(new Item(
+            itemId,
+            "upgrade_example",
+            100,
+            "An example item for the store.",
+            plusOne,
+            1,//0-1
+            &store,
+            &player
+        ));
+    }
+
+    setupRules();
+}
+
+/**
+ * @brief Destroy the Game object
+ *
+ */
+Game::~Game(){
+    for(Item* item : items) {
+        delete item;
+    }
+}
+
+/**
+ * @brief Registers the stats of the game in the rules engine and adds the achievements and item unlocks
+ *
+ */
+void Game::setupRules(){
+    pointsStat = rules.addStat("points", player.getPoints());
+    multiplierStat = rules.addStat("multiplier", player.getMultiplier());
+    std::vector<int> firstUpgrade;
+    for(Item* item : items) {
+        int levelStat = rules.addStat("level:" + item->id, item->level);
+        levelStats.push_back(levelStat);
+        firstUpgrade.push_back(rules.addThreshold(levelStat, 2));
+    }
+
+    // achievements
+    rules.addRule("first_upgrade", rules.addAny(firstUpgrade), nullptr);
+    rules.addRule("thousand_points", rules.addThreshold(pointsStat, 1000), nullptr);
+    rules.addRule("million_points", rules.addThreshold(pointsStat, 1000000), nullptr);
+    rules.addRule("ten_per_click", rules.addThreshold(multiplierStat, 10), nullptr);
+
+    // the third item is offered after 1000 points or after upgrading the first item twice
+    Item* lockedItem = items.back();
+    lockedItem->unlocked = false;
+    int unlock = rules.addAny({
+        rules.addThreshold(pointsStat, 1000),
+        rules.addThreshold(levelStats.front(), 3)
+    });
+    rules.addRule("unlock:" + lockedItem->id, unlock, [lockedItem]{
+        lockedItem->unlocked = true;
+    });
+}
+
+/**
+ * @brief Sends the current stats to the rules engine. Stats that did not change cost a comparison
+ *
+ */
+void Game::updateRules(){
+    rules.setStat(pointsStat, player.getPoints());
+    rules.setStat(multiplierStat, player.getMultiplier());
+    // catalog items have no rules
+    for(size_t i = 0; i < levelStats.size(); i++) {
+        rules.setStat(levelStats[i], items[i]->level);
+    }
+}
+
+/**
+ * @brief Adds generated items to the store and lists every unlocked item instead of a random offer, to try the
+ * store with a big catalog. Call it before start()
+ *
+ * @param count Items to add
+ */
+void Game::addCatalog(int count){
+    ItemEffect plusOne;
+    plusOne.amount = 1.0;
+    for(int i = 0; i < count; i++) {
+        char itemId[32];
+        snprintf(itemId, sizeof(itemId), "catalog_item%d", i);
+        items.push_back(new Item(itemId, "upgrade_example", 100 + i * 10, "A generated item of the catalog.", plusOne, 1, &store, &player));
+    }
+    store.offerCount = 0;
+}
+
+/**
+ * @brief Seeds the game and fills the store. A recorded game stores the seed so the replay gets the same store.
+ *
+ * @param seed
+ */
+void Game::start(unsigned int seed){
+    store.setSeed(seed);
+    store.randomizeAvailableItems();
+    timers.addEvent(STORE_REFRESH_INTERVAL, GAME_EVENT_STORE_RESTOCK, &store, 0, STORE_REFRESH_INTERVAL);
+}
+
+/**
+ * @brief Handles an input event
+ *
+ * @param e
+ */
+void Game::handleEvent(SDL_Event& e){
+    if(e.type == SDL_MOUSEBUTTONDOWN){
+        objectManager.handleMouseClick(e);
+    }
+    else if(e.type == SDL_MOUSEBUTTONUP){
+        objectManager.handleMouseRelease(e);
+    }
+    else if(e.type == SDL_MOUSEMOTION){
+        objectManager.queueMouseMotion(e);
+    }
+    else if(e.type == SDL_MOUSEWHEEL){
+        int notches = e.wheel.direction == SDL_MOUSEWHEEL_FLIPPED ? -e.wheel.y : e.wheel.y;
+        // wheel up scrolls the list up
+        store.scroll(-notches * STORE_SCROLL_STEP);
+    }
+    else if(e.type == SDL_WINDOWEVENT && e.window.event == SDL_WINDOWEVENT_LEAVE){
+        objectManager.mouseLeft();
+    }
+}
+
+/**
+ * @brief Updates the game once per frame, after the events of the frame
+ *
+ * @param milliseconds Time of the frame since the game started, the clock of the scheduler
+ */
+void Game::update(Uint32 milliseconds){
+    // mutations recorded by the clicks of this frame (and by other threads)
+    objectManager.applyCommands();
+    // timers and sequences that are due, before the rules and the store see the state
+    for(const TimerEvent& event : timers.update(milliseconds)) {
+        handleTimerEvent(event);
+    }
+    scheduler.update(milliseconds);
+    // one hit test per frame, however many motion events there were
+    objectManager.updateHover();
+    updateRules();
+    store.updateScroll();
+    store.updateStore(&player);
+}
+
+/**
+ * @brief Applies an event of the timers of the game
+ *
+ * @param event
+ */
+void Game::handleTimerEvent(const TimerEvent& event){
+    switch(event.event) {
+        case GAME_EVENT_STORE_RESTOCK:
+            // however many restocks were missed, one new offer is enough
+            if(event.target.store()) {
+                event.target.store()->randomizeAvailableItems();
+            }
+            break;
+        default:
+            SDL_Log("ERROR: Unknown timer event %d.\n", event.event);
+            break;
+    }
+}
+
+/**
+ * @brief Mixes a value into a FNV-1a hash
+ *
+ * @param hash
+ * @param value
+ */
+static void hashValue(uint64_t& hash, uint64_t value){
+    for(int i = 0; i < 8; i++) {
+        hash ^= (value >> (i * 8)) & 0xFF;
+        hash *= 1099511628211ULL;
+    }
+}
+
+/**
+ * @brief Hash of the player and store state, equal hashes mean a replay reproduced the recorded game
+ *
+ * @return uint64_t
+ */
+uint64_t Game::stateHash(){
+    uint64_t hash = 14695981039346656037ULL;
+    hashValue(hash, static_cast<uint64_t>(player.getPoints()));
+    hashValue(hash, static_cast<uint64_t>(player.getMultiplier()));
+    for(auto& pair : store.items) {
+        hashValue(hash, static_cast<uint64_t>(pair.second->cost));
+        hashValue(hash, static_cast<uint64_t>(pair.second->level));
+        hashValue(hash, pair.second->available);
+        hashValue(hash, pair.second->unlocked);
+    }
+    for(Item* item : store.availableItems) {
+        for(char c : item->id) {
+            hashValue(hash, static_cast<unsigned char>(c));
+        }
+    }
+    return hash;
+}
+
+/**
+ * @brief Logs the player and store state
+ *
+ */
+void Game::logState(){
+    SDL_Log("Player: %d points, multiplier %d\n", player.getPoints(), player.getMultiplier());
+    for(auto& pair : store.items) {
+        SDL_Log("  %-16s level %d cost %d%s%s\n", pair.first.c_str(), pair.second->level, pair.second->cost,
+            pair.second->available ? " (available)" : "", pair.second->unlocked ? "" : " (locked)");
+    }
+    SDL_Log("State hash: %016llx\n", static_cast<unsigned long long>(stateHash()));
+}
@@ -0,0 +1,184 @@
+/**
+ * @file hdrHistogram.cpp
+ * @author Iván Mansilla
+ * @brief High dynamic range histogram.
+ * @version 0.1
+ * @date 2025-07-30
+ *
+ *
+ */
+
+#include "../inc/hdrHistogram.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Number of leading zero bits of a value
+ *
+ * @param value Not zero
+ * @return int
+ */
+static int leadingZeros(uint64_t value){
+#if defined(__GNUC__)
+    return __builtin_clzll(value);
+#else
+    int zeros = 0;
+    for(uint64_t bit = 1ULL << 63; !(value & bit); bit >>= 1) {
+        zeros++;
+    }
+    return zeros;
+#endif
+}
+
+/**
+ * @brief Construct a new Hdr Histogram object
+ *
+ * @param lowestDiscernible Lowest value that can be told apart from 0, at least 1
+ * @param highestTrackable Highest value that can be recorded
+ * @param significantFigures Precision of the values, between 1 and 5
+ */
+HdrHistogram::HdrHistogram(int64_t lowestDiscernible, int64_t highestTrackable, int significantFigures){
+    if(lowestDiscernible < 1) {
+        lowestDiscernible = 1;
+    }
+    if(significantFigures < 1) {
+        significantFigures = 1;
+    }
+    if(significantFigures > 5) {
+        significantFigures = 5;
+    }
+    if(highestTrackable < 2 * lowestDiscernible) {
+        highestTrackable = 2 * lowestDiscernible;
+    }
+    this->highestTrackable = highestTrackable;
+
+    // enough sub-buckets to tell apart values that differ in the last significant figure
+    int64_t largestSingleUnitResolution = 2 * static_cast<int64_t>(std::pow(10, significantFigures));
+    int subBucketCountMagnitude = static_cast<int>(std::ceil(std::log2(static_cast<double>(largestSingleUnitResolution))));
+    subBucketHalfCountMagnitude = (subBucketCountMagnitude > 1 ? subBucketCountMagnitude : 1) - 1;
+    unitMagnitude = static_cast<int>(std::floor(std::log2(static_cast<double>(lowestDiscernible))));
+    subBucketCount = 1LL << (subBucketHalfCountMagnitude + 1);
+    subBucketHalfCount = subBucketCount / 2;
+    subBucketMask = (subBucketCount - 1) << unitMagnitude;
+
+    int bucketCount = 1;
+    int64_t smallestUntrackable = subBucketCount << unitMagnitude;
+    while(smallestUntrackable <= highestTrackable) {
+        if(smallestUntrackable > INT64_MAX / 2) {
+            bucketCount++;
+            break;
+        }
+        smallestUntrackable <<= 1;
+        bucketCount++;
+    }
+    counts.assign(static_cast<size_t>((bucketCount + 1) * subBucketHalfCount), 0);
+}
+
+/**
+ * @brief Index of the sub-bucket a value falls in
+ *
+ * @param value
+ * @return size_t
+ */
+size_t HdrHistogram::countsIndexFor(int64_t value) const {
+    int pow2Ceiling = 64 - leadingZeros(static_cast<uint64_t>(value | subBucketMask));
+    int bucketIndex = pow2Ceiling - unitMagnitude - (subBucketHalfCountMagnitude + 1);
+    int64_t subBucketIndex = value >> (bucketIndex + unitMagnitude);
+    return static_cast<size_t>(((static_cast<int64_t>(bucketIndex) + 1) << subBucketHalfCountMagnitude) + (subBucketIndex - subBucketHalfCount));
+}
+
+/**
+ * @brief Lowest value of a sub-bucket
+ *
+ * @param index
+ * @return int64_t
+ */
+int64_t HdrHistogram::valueFromIndex(size_t index) const {
+    int bucketIndex = static_cast<int>(index >> subBucketHalfCountMagnitude) - 1;
+    int64_t subBucketIndex = static_cast<int64_t>(index & (subBucketHalfCount - 1)) + subBucketHalfCount;
+    if(bucketIndex < 0) {
+        subBucketIndex -= subBucketHalfCount;
+        bucketIndex = 0;
+    }
+    return subBucketIndex << (bucketIndex + unitMagnitude);
+}
+
+/**
+ * @brief Highest value that falls in the same sub-bucket as a value
+ *
+ * @param value
+ * @return int64_t
+ */
+int64_t HdrHistogram::highestEquivalentValue(int64_t value) const {
+    size_t index = countsIndexFor(value);
+    if(index + 1 < counts.size()) {
+        return valueFromIndex(index + 1) - 1;
+    }
+    return value;
+}
+
+/**
+ * @brief Records a value. Negative values are recorded as 0 and values above the trackable range as the highest trackable value
+ *
+ * @param value
+ */
+void HdrHistogram::record(int64_t value){
+    if(value < 0) {
+        value = 0;
+    }
+    if(value > highestTrackable) {
+        value = highestTrackable;
+    }
+
+    counts[countsIndexFor(value)]++;
+    totalCount++;
+    sum += static_cast<double>(value);
+    if(value < minValue) {
+        minValue = value;
+    }
+    if(value > maxValue) {
+        maxValue = value;
+    }
+}
+
+/**
+ * @brief Forgets every value recorded
+ *
+ */
+void HdrHistogram::reset(){
+    std::fill(counts.begin(), counts.end(), 0);
+    totalCount = 0;
+    minValue = INT64_MAX;
+    maxValue = 0;
+    sum = 0.0;
+}
+
+/**
+ * @brief Gets the value below which a percentage of the recorded values fall
+ *
+ * @param percentile 0-100
+ * @return int64_t 0 if nothing was recorded
+ */
+int64_t HdrHistogram::valueAtPercentile(double percentile) const {
+    if(totalCount == 0) {
+        return 0;
+    }
+    if(percentile > 100.0) {
+        percentile = 100.0;
+    }
+
+    uint64_t wanted = static_cast<uint64_t>(std::ceil(percentile / 100.0 * totalCount));
+    if(wanted < 1) {
+        wanted = 1;
+    }
+
+    uint64_t seen = 0;
+    for(size_t i = 0; i < counts.size(); i++) {
+        seen += counts[i];
+        if(seen >= wanted) {
+            int64_t value = highestEquivalentValue(valueFromIndex(i));
+            return value < maxValue ? value : maxValue;
+        }
+    }
+    return maxValue;
+}
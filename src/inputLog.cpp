@@ -0,0 +1,281 @@
+/**
+ * @file inputLog.cpp
+ * @author Iván Mansilla
+ * @brief Recording and replay of the input of a game.
+ * @version 0.1
+ * @date 2025-07-27
+ *
+ *
+ */
+
+#include "../inc/inputLog.h"
+#include <cstring>
+
+static const size_t HEADER_SIZE = 16; /*!< Magic, version and seed */
+static const size_t RECORD_START_SIZE = 3; /*!< Type and time delta */
+static const size_t BUTTON_PAYLOAD_SIZE = 5; /*!< Button, x and y */
+static const size_t WHEEL_PAYLOAD_SIZE = 2; /*!< Notches */
+static const size_t TIME_SKIP_PAYLOAD_SIZE = 4; /*!< Milliseconds skipped */
+
+/**
+ * @brief Appends a little endian value to a buffer
+ *
+ * @param buffer
+ * @param value
+ * @param bytes
+ */
+static void putValue(std::vector<unsigned char>& buffer, uint32_t value, int bytes){
+    for(int i = 0; i < bytes; i++) {
+        buffer.push_back(static_cast<unsigned char>(value >> (i * 8)));
+    }
+}
+
+/**
+ * @brief Reads a little endian value
+ *
+ * @param data
+ * @param bytes
+ * @return uint32_t
+ */
+static uint32_t getValue(const unsigned char* data, int bytes){
+    uint32_t value = 0;
+    for(int i = 0; i < bytes; i++) {
+        value |= static_cast<uint32_t>(data[i]) << (i * 8);
+    }
+    return value;
+}
+
+/**
+ * @brief Destroy the Input Recorder object, closing the log
+ *
+ */
+InputRecorder::~InputRecorder(){
+    close();
+}
+
+/**
+ * @brief Creates a log and writes its header
+ *
+ * @param path
+ * @param seed Seed of the recorded game
+ * @param startTimestamp Ticks at the start of the recording, timestamps are stored relative to it
+ * @return int 0 on success, -1 if the file could not be created
+ */
+int InputRecorder::open(const std::string& path, unsigned int seed, Uint32 startTimestamp){
+    close();
+
+    file = fopen(path.c_str(), "wb");
+    if(!file) {
+        SDL_Log("ERROR: Could not create input log %s\n", path.c_str());
+        return -1;
+    }
+
+    buffer.clear();
+    buffer.reserve(INPUT_LOG_BUFFER_SIZE);
+    const char magic[8] = INPUT_LOG_MAGIC;
+    buffer.insert(buffer.end(), magic, magic + sizeof(magic));
+    putValue(buffer, INPUT_LOG_VERSION, 4);
+    putValue(buffer, seed, 4);
+
+    lastTimestamp = startTimestamp;
+    records = 0;
+    SDL_Log("Recording input to %s (seed %u)\n", path.c_str(), seed);
+    return 0;
+}
+
+/**
+ * @brief Appends the type of a record and the time since the previous one. A delta that does not fit in the
+ * record goes in a time skip record before it, so the replayed clock never falls behind the recorded one
+ *
+ * @param type
+ * @param timestamp
+ */
+void InputRecorder::writeRecordStart(InputRecordType type, Uint32 timestamp){
+    // events can carry a timestamp slightly older than the previous frame record
+    Uint32 delta = timestamp > lastTimestamp ? timestamp - lastTimestamp : 0;
+    lastTimestamp += delta;
+    if(delta > 0xFFFF) {
+        buffer.push_back(INPUT_TIME_SKIP);
+        putValue(buffer, 0, 2);
+        putValue(buffer, delta, 4);
+        delta = 0;
+    }
+
+    buffer.push_back(type);
+    putValue(buffer, delta, 2);
+    records++;
+}
+
+/**
+ * @brief Records an event. Only mouse button and wheel events change the game, anything else is ignored
+ *
+ * @param e
+ */
+void InputRecorder::recordEvent(const SDL_Event& e){
+    if(!file || (e.type != SDL_MOUSEBUTTONDOWN && e.type != SDL_MOUSEBUTTONUP && e.type != SDL_MOUSEWHEEL)) {
+        return;
+    }
+
+    if(e.type == SDL_MOUSEWHEEL) {
+        // stored as if the wheel was not flipped
+        int notches = e.wheel.direction == SDL_MOUSEWHEEL_FLIPPED ? -e.wheel.y : e.wheel.y;
+        writeRecordStart(INPUT_WHEEL, e.wheel.timestamp);
+        putValue(buffer, static_cast<uint16_t>(static_cast<int16_t>(notches)), 2);
+        if(buffer.size() >= INPUT_LOG_BUFFER_SIZE) {
+            flush();
+        }
+        return;
+    }
+
+    writeRecordStart(e.type == SDL_MOUSEBUTTONDOWN ? INPUT_BUTTON_DOWN : INPUT_BUTTON_UP, e.button.timestamp);
+    buffer.push_back(e.button.button);
+    putValue(buffer, static_cast<uint16_t>(static_cast<int16_t>(e.button.x)), 2);
+    putValue(buffer, static_cast<uint16_t>(static_cast<int16_t>(e.button.y)), 2);
+
+    if(buffer.size() >= INPUT_LOG_BUFFER_SIZE) {
+        flush();
+    }
+}
+
+/**
+ * @brief Records the end of the events of a frame. Call it right before the game is updated
+ *
+ * @param timestamp Ticks of the frame
+ */
+void InputRecorder::recordFrame(Uint32 timestamp){
+    if(!file) {
+        return;
+    }
+
+    writeRecordStart(INPUT_FRAME, timestamp);
+    if(buffer.size() >= INPUT_LOG_BUFFER_SIZE) {
+        flush();
+    }
+}
+
+/**
+ * @brief Writes the buffered records to the file
+ *
+ * @return int 0 on success, -1 if the write failed
+ */
+int InputRecorder::flush(){
+    if(buffer.empty()) {
+        return 0;
+    }
+    size_t written = fwrite(buffer.data(), 1, buffer.size(), file);
+    buffer.clear();
+    if(written == 0) {
+        SDL_Log("ERROR: Could not write the input log\n");
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Writes the remaining records and closes the log
+ *
+ * @return int 0 on success, -1 if the write failed
+ */
+int InputRecorder::close(){
+    if(!file) {
+        return 0;
+    }
+
+    int result = flush();
+    fclose(file);
+    file = nullptr;
+    SDL_Log("Input log closed, %llu records\n", records);
+    return result;
+}
+
+/**
+ * @brief Loads a log
+ *
+ * @param path
+ * @return int 0 on success, -1 if the file could not be read or is not an input log
+ */
+int InputReplay::open(const std::string& path){
+    FILE* file = fopen(path.c_str(), "rb");
+    if(!file) {
+        SDL_Log("ERROR: Could not open input log %s\n", path.c_str());
+        return -1;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    data.resize(size > 0 ? static_cast<size_t>(size) : 0);
+    size_t read = data.empty() ? 0 : fread(data.data(), 1, data.size(), file);
+    fclose(file);
+    data.resize(read);
+
+    if(data.size() < HEADER_SIZE || memcmp(data.data(), INPUT_LOG_MAGIC, 8) != 0) {
+        SDL_Log("ERROR: %s is not an input log\n", path.c_str());
+        return -1;
+    }
+    uint32_t version = getValue(&data[8], 4);
+    if(version < 1 || version > INPUT_LOG_VERSION) {
+        SDL_Log("ERROR: Input log %s has an unsupported version\n", path.c_str());
+        return -1;
+    }
+
+    seed = getValue(&data[12], 4);
+    position = HEADER_SIZE;
+    timestamp = 0;
+    return 0;
+}
+
+/**
+ * @brief Reads the next record
+ *
+ * @param record
+ * @return true if a record was read
+ * @return false at the end of the log (or if it is truncated)
+ */
+bool InputReplay::next(InputRecord& record){
+    if(position + RECORD_START_SIZE > data.size()) {
+        return false;
+    }
+
+    const unsigned char* start = &data[position];
+    InputRecordType type = static_cast<InputRecordType>(start[0]);
+    timestamp += getValue(start + 1, 2);
+    record.type = type;
+    record.timestamp = timestamp;
+    position += RECORD_START_SIZE;
+
+    if(type == INPUT_FRAME) {
+        return true;
+    }
+    if(type == INPUT_TIME_SKIP && position + TIME_SKIP_PAYLOAD_SIZE <= data.size()) {
+        timestamp += getValue(&data[position], 4);
+        position += TIME_SKIP_PAYLOAD_SIZE;
+        return next(record);
+    }
+    if(type == INPUT_WHEEL && position + WHEEL_PAYLOAD_SIZE <= data.size()) {
+        memset(&record.event, 0, sizeof(record.event));
+        record.event.type = SDL_MOUSEWHEEL;
+        record.event.wheel.timestamp = timestamp;
+        record.event.wheel.direction = SDL_MOUSEWHEEL_NORMAL;
+        record.event.wheel.y = static_cast<int16_t>(getValue(&data[position], 2));
+        position += WHEEL_PAYLOAD_SIZE;
+        return true;
+    }
+    if((type != INPUT_BUTTON_DOWN && type != INPUT_BUTTON_UP) || position + BUTTON_PAYLOAD_SIZE > data.size()) {
+        SDL_Log("ERROR: Input log is corrupted at offset %zu\n", position - RECORD_START_SIZE);
+        position = data.size();
+        return false;
+    }
+
+    const unsigned char* payload = &data[position];
+    memset(&record.event, 0, sizeof(record.event));
+    record.event.type = type == INPUT_BUTTON_DOWN ? SDL_MOUSEBUTTONDOWN : SDL_MOUSEBUTTONUP;
+    record.event.button.timestamp = timestamp;
+    record.event.button.button = payload[0];
+    record.event.button.state = type == INPUT_BUTTON_DOWN ? SDL_PRESSED : SDL_RELEASED;
+    record.event.button.clicks = 1;
+    record.event.button.x = static_cast<int16_t>(getValue(payload + 1, 2));
+    record.event.button.y = static_cast<int16_t>(getValue(payload + 3, 2));
+    position += BUTTON_PAYLOAD_SIZE;
+    return true;
+}
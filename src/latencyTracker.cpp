@@ -0,0 +1,121 @@
+/**
+ * @file latencyTracker.cpp
+ * @author Iván Mansilla
+ * @brief Input-to-present latency and frame time measurement.
+ * @version 0.1
+ * @date 2025-07-30
+ *
+ *
+ */
+
+#include "../inc/latencyTracker.h"
+
+/**
+ * @brief Construct a new Latency Tracker object
+ *
+ */
+LatencyTracker::LatencyTracker()
+: inputLatency(1, LATENCY_MAX_MICROSECONDS, 3), frameTime(1, LATENCY_MAX_MICROSECONDS, 3) {
+}
+
+/**
+ * @brief Reports that an event reached its handler. Call it right after the handler ran
+ *
+ * @param eventTimestamp SDL timestamp of the event
+ */
+void LatencyTracker::inputHandled(Uint32 eventTimestamp){
+    if(!enabled) {
+        return;
+    }
+    if(pendingCount == LATENCY_MAX_PENDING) {
+        droppedInputs++;
+        return;
+    }
+    pending[pendingCount++] = {eventTimestamp, SDL_GetTicks(), SDL_GetPerformanceCounter()};
+}
+
+/**
+ * @brief Reports a present. Call it right after SDL_RenderPresent
+ *
+ * @return long long Microseconds since the previous present, -1 on the first one
+ */
+long long LatencyTracker::framePresented(){
+    if(!enabled) {
+        return -1;
+    }
+
+    Uint64 now = SDL_GetPerformanceCounter();
+    double microsecondsPerCount = 1000000.0 / SDL_GetPerformanceFrequency();
+
+    // SDL timestamps only have millisecond resolution, so the time before the handler is taken from the
+    // ticks and the time after it from the performance counter
+    for(int i = 0; i < pendingCount; i++) {
+        const PendingInput& input = pending[i];
+        long long queued = input.handledTicks >= input.eventTicks ? (input.handledTicks - input.eventTicks) * 1000LL : 0;
+        long long handled = static_cast<long long>((now - input.handledCounter) * microsecondsPerCount);
+        inputLatency.record(queued + handled);
+    }
+    pendingCount = 0;
+
+    long long frameMicroseconds = -1;
+    if(lastPresent != 0) {
+        frameMicroseconds = static_cast<long long>((now - lastPresent) * microsecondsPerCount);
+        frameTime.record(frameMicroseconds);
+    }
+    lastPresent = now;
+    return frameMicroseconds;
+}
+
+/**
+ * @brief Writes a one line summary of the percentiles, for in-game display
+ *
+ * @param buffer
+ * @param size
+ * @return int Length of the summary
+ */
+int LatencyTracker::formatSummary(char* buffer, size_t size) const {
+    int length = snprintf(buffer, size, "input p50 %.1f p99 %.1f ms | frame p50 %.1f p99 %.1f ms",
+        inputLatency.valueAtPercentile(50) / 1000.0, inputLatency.valueAtPercentile(99) / 1000.0,
+        frameTime.valueAtPercentile(50) / 1000.0, frameTime.valueAtPercentile(99) / 1000.0);
+    if(length < 0) {
+        return 0;
+    }
+    return static_cast<size_t>(length) < size ? length : static_cast<int>(size) - 1;
+}
+
+/**
+ * @brief Logs a percentile table of a histogram of microseconds
+ *
+ * @param name
+ * @param histogram
+ */
+static void logPercentiles(const char* name, const HdrHistogram& histogram){
+    SDL_Log("  %-14s %8llu samples  mean %7.2f  p50 %7.2f  p90 %7.2f  p99 %7.2f  p99.9 %7.2f  max %7.2f ms\n",
+        name, static_cast<unsigned long long>(histogram.getTotalCount()), histogram.getMean() / 1000.0,
+        histogram.valueAtPercentile(50) / 1000.0, histogram.valueAtPercentile(90) / 1000.0,
+        histogram.valueAtPercentile(99) / 1000.0, histogram.valueAtPercentile(99.9) / 1000.0,
+        histogram.getMax() / 1000.0);
+}
+
+/**
+ * @brief Logs the percentiles of the latencies and frame times
+ *
+ */
+void LatencyTracker::logReport() const {
+    SDL_Log("Latency report:\n");
+    logPercentiles("input->present", inputLatency);
+    logPercentiles("frame time", frameTime);
+    if(droppedInputs > 0) {
+        SDL_Log("  %llu inputs were not measured (more than %d in a frame)\n", droppedInputs, LATENCY_MAX_PENDING);
+    }
+}
+
+/**
+ * @brief Gets the latency tracker of the game
+ *
+ * @return LatencyTracker&
+ */
+LatencyTracker& latencyTracker(){
+    static LatencyTracker tracker;
+    return tracker;
+}
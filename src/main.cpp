@@ -9,41 +9,199 @@
  * 
  */
 #include "../inc/textureManager.h"
-#include "../inc/objects.h"
-#include "../inc/player.h"
-#include "../inc/clickthing.h"
 #include "../inc/config.h"
 #include "../inc/text.h"
-#include "../inc/store.h"
+#include "../inc/game.h"
+#include "../inc/inputLog.h"
+#include "../inc/dirtyRenderer.h"
+#include "../inc/frameArena.h"
+#include "../inc/allocTracker.h"
+#include "../inc/metrics.h"
+#include "../inc/latencyTracker.h"
+#include "../inc/sdlRenderBackend.h"
+#include "../inc/cpuRenderBackend.h"
+#include "../inc/debugHud.h"
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <memory>
+
+
+/**
+ * @brief Replays a recorded input log without a window, as fast as possible, and logs the resulting state
+ * 
+ * @param path Input log recorded with --record
+ * @param catalogSize Items added with --catalog when it was recorded, 0 for none
+ * @return int 0 on success, -1 if the log could not be read
+ */
+static int replayInput(const std::string& path, int catalogSize)
+{
+	InputReplay replay;
+	if(replay.open(path) != 0){
+		return -1;
+	}
+
+	// every click is logged, that would take most of the replay time
+	SDL_LogSetAllPriority(SDL_LOG_PRIORITY_WARN);
+
+	Game game;
+	if(catalogSize > 0){
+		game.addCatalog(catalogSize);
+	}
+	game.start(replay.getSeed());
+
+	unsigned long long events = 0;
+	unsigned long long frames = 0;
+	Uint32 recordedMilliseconds = 0;
+	InputRecord record;
+	auto start = std::chrono::steady_clock::now();
+	while(replay.next(record)){
+		if(record.type == INPUT_FRAME){
+			game.update(record.timestamp);
+			frameArena().reset();
+			frames++;
+		}
+		else{
+			game.handleEvent(record.event);
+			events++;
+		}
+		recordedMilliseconds = record.timestamp;
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	SDL_LogSetAllPriority(SDL_LOG_PRIORITY_INFO);
+	SDL_Log("Replayed %llu events and %llu frames (%.1f s of play) in %.3f s: %.0f events/s, %.0fx real time\n",
+		events, frames, recordedMilliseconds / 1000.0, seconds,
+		seconds > 0 ? events / seconds : 0.0,
+		seconds > 0 ? recordedMilliseconds / 1000.0 / seconds : 0.0);
+	game.logState();
+	return 0;
+}
+
+
+/**
+ * @brief Samples the gauges of the game metrics, once per frame
+ * 
+ * @param game 
+ * @param textureManager 
+ */
+static void sampleMetrics(Game& game, TextureManager& textureManager)
+{
+	const TextureCacheStats& cache = textureManager.getCacheStats();
+	gameMetrics.residentTextures.set(cache.residentTextures);
+	gameMetrics.textureBytes.set(static_cast<long long>(cache.residentBytes));
+	gameMetrics.objects.set(static_cast<long long>(game.objectManager.allObjects.size()));
+	gameMetrics.activeObjects.set(static_cast<long long>(game.objectManager.activeObjects.size()));
+	gameMetrics.availableItems.set(static_cast<long long>(game.store.availableItems.size()));
+	gameMetrics.points.set(game.player.getPoints());
+	gameMetrics.multiplier.set(game.player.getMultiplier());
+}
 
 
 int main( int argc, char* args[] )
 {
-	srand(time(NULL));
+	// Command line options
+	bool fullRedraw = false;
+	bool textureVariants = true;
+	std::string rendererName = "auto";
+	size_t textureBudget = TEXTURE_MEMORY_BUDGET;
+	std::string recordPath;
+	std::string replayPath;
+	std::string metricsFile;
+	std::string metricsSocket;
+	int catalogSize = 0;
+	for(int i = 1; i < argc; i++){
+		std::string arg = args[i];
+		if(arg == "--full-redraw"){
+			fullRedraw = true;
+		}
+		else if(arg == "--no-texture-variants"){
+			textureVariants = false;
+		}
+		else if(arg == "--renderer" && i + 1 < argc){
+			rendererName = args[++i];
+		}
+		else if(arg == "--texture-budget" && i + 1 < argc){
+			textureBudget = static_cast<size_t>(atoi(args[++i])) * 1024 * 1024;
+		}
+		else if(arg == "--record" && i + 1 < argc){
+			recordPath = args[++i];
+		}
+		else if(arg == "--replay" && i + 1 < argc){
+			replayPath = args[++i];
+		}
+		else if(arg == "--metrics-file" && i + 1 < argc){
+			metricsFile = args[++i];
+		}
+		else if(arg == "--catalog" && i + 1 < argc){
+			catalogSize = atoi(args[++i]);
+		}
+		else if(arg == "--metrics-socket" && i + 1 < argc){
+			metricsSocket = args[++i];
+		}
+	}
+
+	// the replay runs headless, before SDL is initialized
+	if(!replayPath.empty()){
+		return replayInput(replayPath, catalogSize) == 0 ? 0 : -1;
+	}
 
 	SDL_Window* window = NULL;
 	SDL_Renderer* renderer = NULL;
 
-	// Init SDL and create a window
-	if(init_SDL(&window, &renderer) < 0){
+	// Init SDL and create a window. "--renderer cpu" draws with the CPU rasterizer instead of the SDL renderer
+	bool cpuRenderer = rendererName == "cpu";
+	if(init_SDL(&window, &renderer, !cpuRenderer) < 0){
 		SDL_DestroyWindow(window);
 		SDL_Quit();
 		return -1;
 	}
+
+	// without a GPU SDL falls back to its generic software renderer, the CPU rasterizer is faster there
+	SDL_RendererInfo rendererInfo;
+	if(rendererName == "auto" && SDL_GetRendererInfo(renderer, &rendererInfo) == 0 && (rendererInfo.flags & SDL_RENDERER_SOFTWARE)){
+		SDL_Log("No accelerated renderer, using the CPU renderer\n");
+		SDL_DestroyRenderer(renderer);
+		renderer = NULL;
+		cpuRenderer = true;
+	}
+
+	std::unique_ptr<RenderBackend> backend;
+	CpuRenderBackend* cpuBackend = nullptr;
+	if(cpuRenderer){
+		cpuBackend = new CpuRenderBackend(window, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+		backend.reset(cpuBackend);
+	}
+	else{
+		backend = std::make_unique<SdlRenderBackend>(renderer);
+	}
 	
 	// Initialize texture manager
-	TextureManager textureManager(&renderer);
-	textureManager.loadAllTextures(TEXTURE_PATH);
-	textureManager.loadAllFonts(FONT_PATH);
+	TextureManager textureManager(backend.get());
+	textureManager.setMemoryBudget(textureBudget);
+	// sprites are drawn from pre-scaled copies, "--no-texture-variants" scales the full textures on every draw
+	textureManager.setVariantsEnabled(textureVariants);
+	// the packed archive (built with "make pack") is much faster to load than the asset directories
+	if(!std::filesystem::exists(ASSET_ARCHIVE_PATH) || textureManager.loadArchive(ASSET_ARCHIVE_PATH) != 0){
+		textureManager.loadAllTextures(TEXTURE_PATH);
+		textureManager.loadAllFonts(FONT_PATH);
+	}
 
-	// Create the object manager
-	ObjectManager objectManager;
+	// textures of the first screen are loaded now instead of stalling the first frame
+	textureManager.prefetchTexture("example_texture");
+	textureManager.prefetchTexture("store");
+	textureManager.prefetchTexture("upgrade_example");
+	textureManager.processPrefetches(3);
 
-	// create the player object
-	Player player = Player();
+	// Renderer that only recomposites the areas that changed. "--full-redraw" redraws everything every frame
+	DirtyRectRenderer sceneRenderer(backend.get(), SCREEN_WIDTH, SCREEN_HEIGHT);
+	sceneRenderer.init();
+	if(fullRedraw){
+		sceneRenderer.enabled = false;
+	}
 
-	// Create the clickable thing
-	ClickThing clicky = ClickThing(&player,&objectManager);
+	// player, clickable thing and store
+	Game game;
 
 	// add points text
 	Text pointsText = Text(
@@ -52,9 +210,9 @@ int main( int argc, char* args[] )
 		"points: 0",
 		textureManager.getFont(DEFAULT_FONT),
 		{255, 255, 255, 255},
-		&objectManager
+		&game.objectManager
 	);
-	objectManager.activateObject("points");
+	game.objectManager.activateObject("points");
 	
 
 	// add points per click text
@@ -64,107 +222,214 @@ int main( int argc, char* args[] )
 		"Points per click: 1",
 		textureManager.getFont(DEFAULT_FONT),
 		{255, 255, 255, 255},
-		&objectManager
-	);
-	objectManager.activateObject("points_per_click");
-
-
-	// make a store
-	Store store = Store(
-		310,
-		10,
-		300,
-		400,
-		"store",
-		&objectManager);
-	objectManager.activateObject("Store");
-
-	// make an item
-	Item exampleItem = Item(
-		"example_item",
-		"upgrade_example",
-		100,
-		"An example item for the store.",
-		[](Player* player){
-			player->addMultiplier(1.0f);
-		},
-		1,//0-1
-		&store, 
-		&player
+		&game.objectManager
 	);
+	game.objectManager.activateObject("points_per_click");
 
-	// make an item
-	Item exampleItem2 = Item(
-		"example_item2",
-		"upgrade_example",
-		100,
-		"An example item for the store.",
-		[](Player* player){
-			player->addMultiplier(1.0f);
-		},
-		1,//0-1
-		&store, 
-		&player
-	);
 
-	// make an item
-	Item exampleItem3 = Item(
-		"example_item3",
-		"upgrade_example",
-		100,
-		"An example item for the store.",
-		[](Player* player){
-			player->addMultiplier(1.0f);
-		},
-		1,//0-1
-		&store, 
-		&player
+	// "--catalog <n>" lists n more items in the store, to try the scrolling list with a big catalog.
+	// It is not saved in the input log, a replay needs the same option
+	if(catalogSize > 0){
+		game.addCatalog(catalogSize);
+	}
+
+	// the seed is saved in the input log, a replay with it gets the same store
+	unsigned int seed = static_cast<unsigned int>(time(NULL));
+	game.start(seed);
+
+	// "--record <file>" saves the input of the game, "--replay <file>" plays it back.
+	// The game clock starts here, a replay gets the same frame times from the log
+	Uint32 startTicks = SDL_GetTicks();
+	InputRecorder recorder;
+	if(!recordPath.empty()){
+		recorder.open(recordPath, seed, startTicks);
+	}
+
+	// labels show big numbers with suffixes (1.5K, 2.3M...)
+	NumberFormat labelFormat;
+
+	// "--metrics-file <file>" and "--metrics-socket <path>" export the metrics in Prometheus text format
+	MetricsExporter metricsExporter;
+	metricsExporter.start(metricsFile, metricsSocket);
+
+	// input-to-present latency and frame time percentiles, shown with F2
+	latencyTracker().setEnabled(true);
+	Text latencyText = Text(
+		"latency",
+		10, 455, 420, 24,
+		"latency",
+		textureManager.getFont(DEFAULT_FONT),
+		{255, 255, 0, 255},
+		&game.objectManager
 	);
+	bool showLatency = false;
+	int frameCount = 0;
+	char latencySummary[128];
 
-	store.randomizeAvailableItems();
-	
+	// performance overlay shown with F3, overdraw heatmap shown with F4
+	DebugHud debugHud(backend.get(), textureManager.getFont(DEFAULT_FONT));
 
+	// tooltip of the item under the mouse. Its text is wrapped by the layout cache, so hovering an item again redraws it for free
+	const int tooltipWidth = 150;
+	Text tooltipText = Text(
+		"tooltip",
+		0, 0, tooltipWidth, 24,
+		"",
+		textureManager.getFont(DEFAULT_FONT),
+		{255, 255, 255, 255},
+		&game.objectManager
+	);
+	tooltipText.setWrap(tooltipWidth);
+	Item* tooltipItem = nullptr;
+	int tooltipCost = 0;
+	char tooltip[256];
 
 	// Basic game loop
 	bool running = true;
 	SDL_Event e;
+	Uint32 lastTicks = SDL_GetTicks();
 	while (running){
 
 		// Poll of events
-		while(SDL_PollEvent(&e)){
-			// Handle quit event
-			if(e.type == SDL_QUIT){
-				SDL_Log("Quitting the game...");
-				running = false;
-				break;
+		{
+			AllocScope scope(ALLOC_INPUT);
+			while(SDL_PollEvent(&e)){
+				// Handle quit event
+				if(e.type == SDL_QUIT){
+					SDL_Log("Quitting the game...");
+					running = false;
+					break;
+				}
+
+				if(e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_F2){
+					showLatency = !showLatency;
+					if(showLatency){
+						game.objectManager.activateObject("latency");
+					}
+					else{
+						game.objectManager.deactivateObject("latency");
+					}
+				}
+
+				if(e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_F3){
+					debugHud.visible = !debugHud.visible;
+				}
+				if(e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_F4){
+					debugHud.showHeatmap = !debugHud.showHeatmap;
+				}
+
+				backend->handleEvent(e);
+				sceneRenderer.handleEvent(e);
+				recorder.recordEvent(e);
+				game.handleEvent(e);
+			}
+		}
+
+		{
+			AllocScope scope(ALLOC_STORE);
+			Uint32 frameTicks = SDL_GetTicks();
+			recorder.recordFrame(frameTicks);
+			game.update(frameTicks - startTicks);
+		}
+
+		// animations are only visual, they run on the wall clock and stay out of the recorded game state
+		Uint32 ticks = SDL_GetTicks();
+		game.objectManager.animations.update(static_cast<float>(ticks - lastTicks));
+		lastTicks = ticks;
+
+		{
+			AllocScope scope(ALLOC_TEXT);
+			pointsText.setNumber("Points: ", game.player.getPoints(), labelFormat, backend.get());
+			pointsPerClickText.setNumber("Points per click: ", game.player.getMultiplier(), labelFormat, backend.get());
+			// refreshed a few times per second, so the numbers can be read
+			if(showLatency && frameCount % 30 == 0){
+				int length = latencyTracker().formatSummary(latencySummary, sizeof(latencySummary));
+				latencyText.setContent(latencySummary, length, backend.get());
 			}
 
-			if(e.type == SDL_MOUSEBUTTONDOWN){
-				objectManager.handleMouseClick(e);
+			// the tooltip changes when another item is hovered or the hovered one is bought
+			Item* hoveredItem = game.store.hoveredItem;
+			if(hoveredItem != tooltipItem || (hoveredItem && hoveredItem->cost != tooltipCost)){
+				// only activated when it is shown, activating it again would add it to the active objects twice
+				bool hidden = tooltipItem == nullptr;
+				tooltipItem = hoveredItem;
+				if(hoveredItem){
+					char cost[NUMBER_BUFFER_SIZE];
+					formatNumber(cost, sizeof(cost), static_cast<long long>(hoveredItem->cost), labelFormat);
+					int length = snprintf(tooltip, sizeof(tooltip), "%s\nCost: %s\nLevel: %d",
+						hoveredItem->description.c_str(), cost, hoveredItem->level);
+					tooltipText.setContent(tooltip, std::min(static_cast<size_t>(length), sizeof(tooltip) - 1), backend.get());
+					tooltipCost = hoveredItem->cost;
+					if(hidden){
+						game.objectManager.activateObject("tooltip");
+					}
+				}
+				else{
+					game.objectManager.deactivateObject("tooltip");
+				}
 			}
-			else if(e.type == SDL_MOUSEBUTTONUP){
-				objectManager.handleMouseRelease(e);
+			// next to the row of the item, which moves while the list scrolls
+			if(tooltipItem && game.store.hoveredRow){
+				SDL_Rect itemRect = game.store.hoveredRow->getRect();
+				float tooltipX = static_cast<float>(itemRect.x + itemRect.w + 10);
+				float tooltipY = static_cast<float>(itemRect.y);
+				if(tooltipText.x != tooltipX || tooltipText.y != tooltipY){
+					tooltipText.setPosition(tooltipX, tooltipY);
+				}
 			}
 		}
-		SDL_RenderClear(renderer);
 
-		store.updateStore(&player);
+		{
+			AllocScope scope(ALLOC_RENDER);
+			debugHud.beginFrame(game.objectManager);
+			if(debugHud.needsFullRedraw()){
+				sceneRenderer.invalidate();
+			}
+			sceneRenderer.renderFrame(game.objectManager, textureManager);
+			debugHud.draw(game.objectManager, textureManager);
+			backend->present();
+		}
 
-		pointsText.setContent("Points: " + std::to_string(player.getPoints()), renderer);
-		pointsPerClickText.setContent("Points per click: " + std::to_string(player.getMultiplier()), renderer);
+		long long frameMicroseconds = latencyTracker().framePresented();
+		if(frameMicroseconds >= 0){
+			gameMetrics.frameTime.observe(frameMicroseconds / 1000000.0);
+			debugHud.addFrameTime(frameMicroseconds / 1000.0f);
+		}
+		gameMetrics.frames.add();
+		frameCount++;
+		sampleMetrics(game, textureManager);
+
+		// use the idle time of the frame for hinted texture loads
+		textureManager.processPrefetches(1);
 
-		objectManager.drawActiveObjects(textureManager);
-		objectManager.drawAllTexts(&renderer);
-		
-		SDL_RenderPresent(renderer);
+		// transient memory of the frame is released all at once
+		frameArena().reset();
+		allocTrackerEndFrame();
         SDL_Delay(16);
 	}
 
 
 	
 	
+	metricsExporter.stop();
+	recorder.close();
+	game.logState();
+	textureManager.logCacheStats();
+	textLayoutCache().logStats();
+	if(cpuBackend){
+		cpuBackend->logStats();
+	}
+	latencyTracker().logReport();
+	logAllocationReport();
+	// textures of the renderer go before it
+	sceneRenderer.release();
+	debugHud.release();
+	tooltipText.layout.reset();
+	textLayoutCache().clear();
 	textureManager.clearAllTextures();
-	SDL_DestroyRenderer(renderer);
+	if(renderer){
+		SDL_DestroyRenderer(renderer);
+	}
 	SDL_DestroyWindow(window);
 	SDL_Quit();
 
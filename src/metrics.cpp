@@ -0,0 +1,345 @@
+/**
+ * @file metrics.cpp
+ * @author Iván Mansilla
+ * @brief In-process metrics and their Prometheus text export.
+ * @version 0.1
+ * @date 2025-07-29
+ *
+ *
+ */
+
+#include "../inc/metrics.h"
+#include "../inc/config.h"
+#include <chrono>
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+
+#ifndef _WIN32
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+#endif
+
+GameMetrics gameMetrics;
+
+/**
+ * @brief Gets the registry of the process
+ *
+ * @return MetricsRegistry&
+ */
+MetricsRegistry& metricsRegistry(){
+    static MetricsRegistry registry;
+    return registry;
+}
+
+/**
+ * @brief Adds a metric to the registry
+ *
+ * @param metric
+ */
+void MetricsRegistry::add(Metric* metric){
+    std::lock_guard<std::mutex> lock(mutex);
+    metrics.push_back(metric);
+}
+
+/**
+ * @brief Appends every metric in Prometheus text format
+ *
+ * @param out
+ */
+void MetricsRegistry::writePrometheus(std::string& out){
+    std::lock_guard<std::mutex> lock(mutex);
+    for(Metric* metric : metrics) {
+        metric->write(out);
+    }
+}
+
+/**
+ * @brief Appends a formatted line
+ *
+ * @param out
+ * @param format
+ * @param ...
+ */
+static void appendLine(std::string& out, const char* format, ...){
+    char line[256];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if(length > 0) {
+        out.append(line, std::min(static_cast<size_t>(length), sizeof(line) - 1));
+    }
+}
+
+/**
+ * @brief Construct a new Metric object and registers it
+ *
+ * @param name
+ * @param help
+ */
+Metric::Metric(const char* name, const char* help) : name(name), help(help) {
+    metricsRegistry().add(this);
+}
+
+void Counter::write(std::string& out) const {
+    appendLine(out, "# HELP %s %s\n# TYPE %s counter\n%s %llu\n", name, help, name, name,
+        static_cast<unsigned long long>(get()));
+}
+
+void Gauge::write(std::string& out) const {
+    appendLine(out, "# HELP %s %s\n# TYPE %s gauge\n%s %lld\n", name, help, name, name, get());
+}
+
+/**
+ * @brief Construct a new Histogram object
+ *
+ * @param name
+ * @param help
+ * @param upperBounds Upper bound of every bucket, ascending. At most HISTOGRAM_MAX_BUCKETS are used
+ */
+Histogram::Histogram(const char* name, const char* help, std::initializer_list<double> upperBounds)
+: Metric(name, help), bucketCount(0) {
+    for(double bound : upperBounds) {
+        if(bucketCount == HISTOGRAM_MAX_BUCKETS) {
+            break;
+        }
+        bounds[bucketCount++] = bound;
+    }
+    for(auto& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Records a value
+ *
+ * @param value
+ */
+void Histogram::observe(double value){
+    int bucket = 0;
+    while(bucket < bucketCount && value > bounds[bucket]) {
+        bucket++;
+    }
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+
+    // normally only the main thread observes, so this does not loop
+    double current = sum.load(std::memory_order_relaxed);
+    while(!sum.compare_exchange_weak(current, current + value, std::memory_order_relaxed)) {
+    }
+}
+
+void Histogram::write(std::string& out) const {
+    appendLine(out, "# HELP %s %s\n# TYPE %s histogram\n", name, help, name);
+    unsigned long long cumulative = 0;
+    for(int i = 0; i < bucketCount; i++) {
+        cumulative += buckets[i].load(std::memory_order_relaxed);
+        appendLine(out, "%s_bucket{le=\"%g\"} %llu\n", name, bounds[i], cumulative);
+    }
+    cumulative += buckets[bucketCount].load(std::memory_order_relaxed);
+    appendLine(out, "%s_bucket{le=\"+Inf\"} %llu\n", name, cumulative);
+    appendLine(out, "%s_sum %.6f\n%s_count %llu\n", name, sum.load(std::memory_order_relaxed), name,
+        static_cast<unsigned long long>(count.load(std::memory_order_relaxed)));
+}
+
+/**
+ * @brief Destroy the Metrics Exporter object, stopping the thread
+ *
+ */
+MetricsExporter::~MetricsExporter(){
+    stop();
+}
+
+/**
+ * @brief Starts exporting
+ *
+ * @param filePath File rewritten every interval, empty for none
+ * @param socketPath Unix domain socket to serve the metrics on, empty for none
+ * @param interval Milliseconds between exports to the file
+ * @return int 0 on success, -1 if the socket could not be opened
+ */
+int MetricsExporter::start(const std::string& filePath, const std::string& socketPath, int interval){
+    stop();
+    if(filePath.empty() && socketPath.empty()) {
+        return 0;
+    }
+    this->filePath = filePath;
+    this->socketPath = socketPath;
+    this->interval = interval > 0 ? interval : METRICS_EXPORT_INTERVAL;
+
+    if(!socketPath.empty() && openSocket() != 0) {
+        return -1;
+    }
+
+    running = true;
+    thread = std::thread(&MetricsExporter::exportLoop, this);
+    SDL_Log("Exporting metrics%s%s%s%s\n",
+        filePath.empty() ? "" : " to ", filePath.c_str(),
+        socketPath.empty() ? "" : " on socket ", socketPath.c_str());
+    return 0;
+}
+
+/**
+ * @brief Stops the export thread, writing the file one last time
+ *
+ */
+void MetricsExporter::stop(){
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(!running) {
+            return;
+        }
+        running = false;
+    }
+    stopRequested.notify_all();
+    thread.join();
+
+#ifndef _WIN32
+    if(listenSocket >= 0) {
+        close(listenSocket);
+        unlink(socketPath.c_str());
+        listenSocket = -1;
+    }
+#endif
+}
+
+/**
+ * @brief Creates the listening socket
+ *
+ * @return int 0 on success, -1 on failure
+ */
+int MetricsExporter::openSocket(){
+#ifdef _WIN32
+    SDL_Log("ERROR: Metrics sockets are not supported on this platform\n");
+    return -1;
+#else
+    sockaddr_un address = {};
+    if(socketPath.size() >= sizeof(address.sun_path)) {
+        SDL_Log("ERROR: Metrics socket path %s is too long\n", socketPath.c_str());
+        return -1;
+    }
+    address.sun_family = AF_UNIX;
+    snprintf(address.sun_path, sizeof(address.sun_path), "%s", socketPath.c_str());
+
+    listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(listenSocket < 0) {
+        SDL_Log("ERROR: Could not create the metrics socket\n");
+        return -1;
+    }
+    unlink(socketPath.c_str());
+    if(bind(listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listenSocket, 4) != 0) {
+        SDL_Log("ERROR: Could not listen on metrics socket %s\n", socketPath.c_str());
+        close(listenSocket);
+        listenSocket = -1;
+        return -1;
+    }
+    return 0;
+#endif
+}
+
+/**
+ * @brief Writes the metrics to the file. A temporary file is renamed over it, so readers never see half an export
+ *
+ * @param text
+ */
+void MetricsExporter::writeFile(const std::string& text){
+    std::string temporaryPath = filePath + ".tmp";
+    FILE* file = fopen(temporaryPath.c_str(), "wb");
+    if(!file) {
+        SDL_Log("ERROR: Could not write metrics file %s\n", temporaryPath.c_str());
+        return;
+    }
+    fwrite(text.data(), 1, text.size(), file);
+    fclose(file);
+#ifdef _WIN32
+    // rename does not replace an existing file on Windows
+    std::remove(filePath.c_str());
+#endif
+    std::rename(temporaryPath.c_str(), filePath.c_str());
+}
+
+/**
+ * @brief Waits for connections on the socket and sends them the current metrics
+ *
+ * @param timeout Milliseconds to wait
+ */
+void MetricsExporter::serveSocket(int timeout){
+#ifdef _WIN32
+    (void)timeout;
+#else
+    pollfd descriptor = {listenSocket, POLLIN, 0};
+    if(poll(&descriptor, 1, timeout) <= 0) {
+        return;
+    }
+    int client = accept(listenSocket, nullptr, nullptr);
+    if(client < 0) {
+        return;
+    }
+    // a scraper that hangs up before reading must not kill the game with SIGPIPE, EPIPE is a normal disconnect
+    int flags = 0;
+#ifdef MSG_NOSIGNAL
+    flags = MSG_NOSIGNAL;
+#elif defined(SO_NOSIGPIPE)
+    int noSignal = 1;
+    setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &noSignal, sizeof(noSignal));
+#endif
+    std::string text;
+    metricsRegistry().writePrometheus(text);
+    size_t sent = 0;
+    while(sent < text.size()) {
+        ssize_t written = send(client, text.data() + sent, text.size() - sent, flags);
+        if(written < 0 && errno == EINTR) {
+            continue;
+        }
+        if(written <= 0) {
+            break;
+        }
+        sent += static_cast<size_t>(written);
+    }
+    close(client);
+#endif
+}
+
+/**
+ * @brief Main loop of the export thread
+ *
+ */
+void MetricsExporter::exportLoop(){
+    // with a socket, the thread wakes up often to check if it must stop
+    const int SOCKET_POLL_INTERVAL = 100;
+    auto nextExport = std::chrono::steady_clock::now();
+    std::string text;
+
+    while(true) {
+        auto now = std::chrono::steady_clock::now();
+        if(!filePath.empty() && now >= nextExport) {
+            text.clear();
+            metricsRegistry().writePrometheus(text);
+            writeFile(text);
+            nextExport = now + std::chrono::milliseconds(interval);
+        }
+
+        if(listenSocket >= 0) {
+            serveSocket(SOCKET_POLL_INTERVAL);
+            std::lock_guard<std::mutex> lock(mutex);
+            if(!running) {
+                break;
+            }
+        }
+        else {
+            std::unique_lock<std::mutex> lock(mutex);
+            if(stopRequested.wait_until(lock, nextExport, [this]{ return !running; })) {
+                break;
+            }
+        }
+    }
+
+    if(!filePath.empty()) {
+        text.clear();
+        metricsRegistry().writePrometheus(text);
+        writeFile(text);
+    }
+}
@@ -0,0 +1,175 @@
+/**
+ * @file modifiers.cpp
+ * @author Iván Mansilla
+ * @brief Stat modifiers with cached aggregate values.
+ * @version 0.1
+ * @date 2025-07-31
+ *
+ *
+ */
+
+#include "../inc/modifiers.h"
+#include "../inc/config.h"
+#include <cmath>
+
+/**
+ * @brief Adds a stat. If it already exists its base value is updated
+ *
+ * @param name
+ * @param base Value without modifiers
+ * @return int ID of the stat
+ */
+int ModifierStack::addStat(const std::string& name, double base){
+    auto it = statIds.find(name);
+    if(it != statIds.end()) {
+        setBase(it->second, base);
+        return it->second;
+    }
+
+    int id = static_cast<int>(stats.size());
+    stats.push_back({name, base, base, false, {}});
+    statIds[name] = id;
+    return id;
+}
+
+/**
+ * @brief Finds a stat by name
+ *
+ * @param name
+ * @return int ID of the stat, -1 if it does not exist
+ */
+int ModifierStack::findStat(const std::string& name) const {
+    auto it = statIds.find(name);
+    return it == statIds.end() ? -1 : it->second;
+}
+
+/**
+ * @brief Changes the value of a stat without modifiers
+ *
+ * @param stat
+ * @param base
+ */
+void ModifierStack::setBase(int stat, double base){
+    stats[stat].base = base;
+    stats[stat].dirty = true;
+}
+
+/**
+ * @brief Adds a modifier to a stat
+ *
+ * @param stat ID of the stat
+ * @param type
+ * @param amount
+ * @param source What applies the modifier
+ * @param priority Modifiers with lower priority are applied first
+ * @return int ID of the modifier, -1 if the stat does not exist
+ */
+int ModifierStack::addModifier(int stat, ModifierType type, double amount, const std::string& source, int priority){
+    if(stat < 0 || stat >= static_cast<int>(stats.size())) {
+        SDL_Log("ERROR: Cannot add modifier from %s, stat %d does not exist.\n", source.c_str(), stat);
+        return -1;
+    }
+
+    Modifier modifier = {nextModifierId++, type, amount, source, priority};
+
+    // kept sorted by application order, so recomputing is a single pass
+    std::vector<Modifier>& modifiers = stats[stat].modifiers;
+    auto position = std::upper_bound(modifiers.begin(), modifiers.end(), modifier,
+        [](const Modifier& a, const Modifier& b){
+            if(a.priority != b.priority) {
+                return a.priority < b.priority;
+            }
+            return a.type < b.type;
+        });
+    modifiers.insert(position, modifier);
+
+    modifierStats[modifier.id] = stat;
+    stats[stat].dirty = true;
+    return modifier.id;
+}
+
+/**
+ * @brief Removes a modifier
+ *
+ * @param modifierId
+ * @return int 0 on success, -1 if the modifier does not exist
+ */
+int ModifierStack::removeModifier(int modifierId){
+    auto it = modifierStats.find(modifierId);
+    if(it == modifierStats.end()) {
+        SDL_Log("ERROR: Modifier %d does not exist.\n", modifierId);
+        return -1;
+    }
+
+    Stat& stat = stats[it->second];
+    stat.modifiers.erase(
+        std::remove_if(stat.modifiers.begin(), stat.modifiers.end(), [modifierId](const Modifier& m){ return m.id == modifierId; }),
+        stat.modifiers.end()
+    );
+    stat.dirty = true;
+    modifierStats.erase(it);
+    return 0;
+}
+
+/**
+ * @brief Removes every modifier applied by a source
+ *
+ * @param source
+ * @return int Number of modifiers removed
+ */
+int ModifierStack::removeSource(const std::string& source){
+    int removed = 0;
+    for(auto& stat : stats) {
+        size_t before = stat.modifiers.size();
+        stat.modifiers.erase(
+            std::remove_if(stat.modifiers.begin(), stat.modifiers.end(), [this, &source](const Modifier& m){
+                if(m.source != source) {
+                    return false;
+                }
+                modifierStats.erase(m.id);
+                return true;
+            }),
+            stat.modifiers.end()
+        );
+        if(stat.modifiers.size() != before) {
+            removed += static_cast<int>(before - stat.modifiers.size());
+            stat.dirty = true;
+        }
+    }
+    return removed;
+}
+
+/**
+ * @brief Gets the modifiers of a stat, in the order they are applied
+ *
+ * @param stat
+ * @return const std::vector<Modifier>&
+ */
+const std::vector<Modifier>& ModifierStack::getModifiers(int stat) const {
+    return stats[stat].modifiers;
+}
+
+/**
+ * @brief Recomputes the cached value of a stat
+ *
+ * @param stat
+ */
+void ModifierStack::recompute(Stat& stat){
+    double value = stat.base;
+    for(const Modifier& modifier : stat.modifiers) {
+        switch(modifier.type) {
+            case MODIFIER_ADD:
+                value += modifier.amount;
+                break;
+            case MODIFIER_MULTIPLY:
+                value *= modifier.amount;
+                break;
+            case MODIFIER_EXPONENT:
+                value = std::pow(value, modifier.amount);
+                break;
+        }
+    }
+    stat.value = value;
+    stat.dirty = false;
+    recomputes++;
+}
@@ -0,0 +1,334 @@
+/**
+ * @file numberFormat.cpp
+ * @author Iván Mansilla
+ * @brief Number formatting into fixed buffers, without heap allocations.
+ * @version 0.1
+ * @date 2025-07-24
+ *
+ *
+ */
+
+#include "../inc/numberFormat.h"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+/**
+ * @brief Short scale suffixes, one every power of 1000
+ *
+ */
+static const char* const SUFFIXES[] = {"", "K", "M", "B", "T", "Qa", "Qi", "Sx", "Sp", "Oc", "No", "Dc"};
+static const int SUFFIX_COUNT = sizeof(SUFFIXES) / sizeof(SUFFIXES[0]);
+
+/**
+ * @brief Powers of ten that fit in 64 bits
+ *
+ */
+static const unsigned long long POWERS_OF_TEN[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+    10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+    1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+};
+
+/**
+ * @brief Writes a number with a fixed amount of decimals and removes the trailing zeros
+ *
+ * @param first Start of the output
+ * @param last End of the output
+ * @param value
+ * @param precision Decimals to keep
+ * @return char* End of the written text, or nullptr if it did not fit
+ */
+static char* writeDecimal(char* first, char* last, double value, int precision){
+    auto result = std::to_chars(first, last, value, std::chars_format::fixed, precision);
+    if(result.ec != std::errc()) {
+        return nullptr;
+    }
+
+    char* end = result.ptr;
+    if(precision > 0 && std::isfinite(value)) {
+        while(end[-1] == '0') {
+            end--;
+        }
+        if(end[-1] == '.') {
+            end--;
+        }
+    }
+    return end;
+}
+
+/**
+ * @brief Writes an exponent marker ("e6", "e-3")
+ *
+ * @param first
+ * @param last
+ * @param exponent
+ * @return char* End of the written text, or nullptr if it did not fit
+ */
+static char* writeExponent(char* first, char* last, int exponent){
+    if(first == last) {
+        return nullptr;
+    }
+    *first++ = 'e';
+    auto result = std::to_chars(first, last, exponent);
+    return result.ec == std::errc() ? result.ptr : nullptr;
+}
+
+/**
+ * @brief Writes the unit (suffix or exponent) after a mantissa
+ *
+ * @param end End of the mantissa
+ * @param last
+ * @param exponent
+ * @param format
+ * @return char* End of the written text, or nullptr if it did not fit
+ */
+static char* writeUnit(char* end, char* last, int exponent, const NumberFormat& format){
+    if(format.notation == Notation::Suffix && exponent >= 0 && exponent / 3 < SUFFIX_COUNT) {
+        const char* suffix = SUFFIXES[exponent / 3];
+        size_t length = strlen(suffix);
+        if(static_cast<size_t>(last - end) < length) {
+            return nullptr;
+        }
+        memcpy(end, suffix, length);
+        return end + length;
+    }
+    if(exponent == 0) {
+        return end;
+    }
+    return writeExponent(end, last, exponent);
+}
+
+/**
+ * @brief Writes a number as mantissa and exponent (or suffix). The exponent step is 1 for scientific notation and 3 otherwise
+ *
+ * @param first
+ * @param last
+ * @param value
+ * @param format
+ * @return char* End of the written text, or nullptr if it did not fit
+ */
+static char* writeScaled(char* first, char* last, double value, const NumberFormat& format){
+    if(!std::isfinite(value) || value == 0) {
+        return writeDecimal(first, last, value, 0);
+    }
+
+    if(value < 0) {
+        if(first == last) {
+            return nullptr;
+        }
+        *first++ = '-';
+        value = -value;
+    }
+
+    // out of suffixes, switch to scientific notation
+    if(format.notation == Notation::Suffix && value >= std::pow(1000.0, SUFFIX_COUNT)) {
+        NumberFormat scientific = format;
+        scientific.notation = Notation::Scientific;
+        return writeScaled(first, last, value, scientific);
+    }
+
+    int step = format.notation == Notation::Scientific ? 1 : 3;
+    double base = std::pow(10.0, step);
+
+    int exponent = static_cast<int>(std::floor(std::log10(value)));
+    exponent -= ((exponent % step) + step) % step;
+    double mantissa = value / std::pow(10.0, exponent);
+
+    // log10 may be off by one around powers of ten
+    if(mantissa >= base) {
+        mantissa /= base;
+        exponent += step;
+    }
+    else if(mantissa < 1) {
+        mantissa *= base;
+        exponent -= step;
+    }
+
+    // rounding may carry to the next unit (999.999K is 1M)
+    double scale = std::pow(10.0, format.precision);
+    if(std::round(mantissa * scale) / scale >= base) {
+        mantissa /= base;
+        exponent += step;
+    }
+
+    char* end = writeDecimal(first, last, mantissa, format.precision);
+    if(!end) {
+        return nullptr;
+    }
+
+    return writeUnit(end, last, exponent, format);
+}
+
+/**
+ * @brief Integer version of writeScaled, it only uses integer arithmetic (no pow/log10 or float conversion)
+ *
+ * @param first
+ * @param last
+ * @param value
+ * @param format
+ * @return char* End of the written text, or nullptr if it did not fit
+ */
+static char* writeScaledInteger(char* first, char* last, long long value, const NumberFormat& format){
+    unsigned long long magnitude = static_cast<unsigned long long>(value);
+    if(value < 0) {
+        if(first == last) {
+            return nullptr;
+        }
+        *first++ = '-';
+        magnitude = 0 - magnitude;
+    }
+    if(magnitude == 0) {
+        return writeDecimal(first, last, 0.0, 0);
+    }
+
+    int step = format.notation == Notation::Scientific ? 1 : 3;
+    int precision = format.precision < 0 ? 0 : (format.precision > 18 ? 18 : format.precision);
+
+    int exponent = 0;
+    while(exponent < 19 && magnitude >= POWERS_OF_TEN[exponent + 1]) {
+        exponent++;
+    }
+    exponent -= exponent % step;
+
+    unsigned long long divisor = POWERS_OF_TEN[exponent];
+    unsigned long long integerPart = magnitude / divisor;
+    unsigned long long remainder = magnitude % divisor;
+    unsigned long long fraction;
+    if(precision <= exponent) {
+        // round the remainder to the wanted decimals
+        unsigned long long unit = POWERS_OF_TEN[exponent - precision];
+        fraction = (remainder + unit / 2) / unit;
+        if(fraction == POWERS_OF_TEN[precision]) {
+            fraction = 0;
+            integerPart++;
+        }
+    }
+    else {
+        fraction = remainder * POWERS_OF_TEN[precision - exponent];
+    }
+
+    // rounding may carry to the next unit (999.999K is 1M)
+    if(integerPart == POWERS_OF_TEN[step] && exponent + step < 19) {
+        integerPart = 1;
+        fraction = 0;
+        exponent += step;
+    }
+
+    auto result = std::to_chars(first, last, integerPart);
+    if(result.ec != std::errc()) {
+        return nullptr;
+    }
+    char* end = result.ptr;
+
+    if(fraction > 0) {
+        // drop trailing zeros of the fraction
+        int digits = precision;
+        while(fraction % 10 == 0) {
+            fraction /= 10;
+            digits--;
+        }
+        if(last - end < digits + 1) {
+            return nullptr;
+        }
+        *end++ = '.';
+        for(int i = digits - 1; i >= 0; i--) {
+            end[i] = static_cast<char>('0' + fraction % 10);
+            fraction /= 10;
+        }
+        end += digits;
+    }
+
+    return writeUnit(end, last, exponent, format);
+}
+
+/**
+ * @brief Formats an integer into a buffer. The text is always null terminated
+ *
+ * @param buffer Output buffer (NUMBER_BUFFER_SIZE is always enough)
+ * @param size Size of the buffer
+ * @param value
+ * @param format
+ * @return size_t Length of the text, 0 if it did not fit
+ */
+size_t formatNumber(char* buffer, size_t size, long long value, const NumberFormat& format){
+    if(size == 0) {
+        return 0;
+    }
+
+    char* last = buffer + size - 1;
+    char* end;
+    if(format.notation == Notation::Plain || std::fabs(static_cast<double>(value)) < format.threshold) {
+        auto result = std::to_chars(buffer, last, value);
+        end = result.ec == std::errc() ? result.ptr : nullptr;
+    }
+    else {
+        end = writeScaledInteger(buffer, last, value, format);
+    }
+
+    if(!end) {
+        buffer[0] = '\0';
+        return 0;
+    }
+    *end = '\0';
+    return end - buffer;
+}
+
+/**
+ * @brief Formats a floating point number into a buffer. The text is always null terminated
+ *
+ * @param buffer Output buffer (NUMBER_BUFFER_SIZE is always enough for non plain notations)
+ * @param size Size of the buffer
+ * @param value
+ * @param format
+ * @return size_t Length of the text, 0 if it did not fit
+ */
+size_t formatNumber(char* buffer, size_t size, double value, const NumberFormat& format){
+    if(size == 0) {
+        return 0;
+    }
+
+    char* last = buffer + size - 1;
+    char* end;
+    if(format.notation == Notation::Plain || std::fabs(value) < format.threshold) {
+        end = writeDecimal(buffer, last, value, format.precision);
+    }
+    else {
+        end = writeScaled(buffer, last, value, format);
+    }
+
+    if(!end) {
+        buffer[0] = '\0';
+        return 0;
+    }
+    *end = '\0';
+    return end - buffer;
+}
+
+/**
+ * @brief Formats a label made of a prefix followed by a number (e.g. "Points: 1.5K")
+ *
+ * @param buffer Output buffer
+ * @param size Size of the buffer
+ * @param prefix Text before the number
+ * @param value
+ * @param format
+ * @return size_t Length of the text, 0 if it did not fit
+ */
+size_t formatLabel(char* buffer, size_t size, const char* prefix, long long value, const NumberFormat& format){
+    size_t length = strlen(prefix);
+    if(length >= size) {
+        if(size > 0) {
+            buffer[0] = '\0';
+        }
+        return 0;
+    }
+
+    memcpy(buffer, prefix, length);
+    size_t numberLength = formatNumber(buffer + length, size - length, value, format);
+    if(numberLength == 0) {
+        buffer[0] = '\0';
+        return 0;
+    }
+    return length + numberLength;
+}
@@ -10,26 +10,19 @@
 
 #include "../inc/objects.h"
 #include "../inc/text.h"
+#include "../inc/latencyTracker.h"
 
 
-/**
- * @brief Draws the object
- * 
- * @param textureManager Texture manager to handle texture drawing
- */
-void Object::drawObject(TextureManager& textureManager){
-    textureManager.drawTexture(textureId, x, y, width, height);
-}
-
 /**
  * @brief Changes the position of the object
  * 
- * @param x X coordinate of the object
- * @param y Y coordinate of the object
+ * @param x X coordinate of the object, relative to its parent
+ * @param y Y coordinate of the object, relative to its parent
  */
 void Object::setPosition(float x, float y) {
     this->x = x;
     this->y = y;
+    markTransformDirty();
 }
 
 /**
@@ -41,6 +34,7 @@ void Object::setPosition(float x, float y) {
 void Object::move(float dx, float dy) {
     x += dx;
     y += dy;
+    markTransformDirty();
 }
 
 /**
@@ -52,25 +46,97 @@ void Object::move(float dx, float dy) {
 void Object::resize(float newWidth, float newHeight) {
     width = newWidth;
     height = newHeight;
+    markTransformDirty();
 }
 
 /**
- * @brief Changes the texture of the object
+ * @brief Changes how the object is drawn (tint, alpha, flip, rotation) without changing its texture
  * 
- * @param newTextureId ID of the new texture
- * @param textureManager Texture manager to handle texture loading
- * @return int 0 on success, -1 if the texture does not exist
+ * @param state 
  */
-int Object::changeTexture(const std::string& newTextureId, TextureManager& textureManager){
-    if(textureManager.searchTexture(newTextureId) == 0) {
-        this->textureId = newTextureId;
-        return 0;
+void Object::setRenderState(const RenderState& state){
+    // a rotation changes the area it paints, which the subtree bounds are built from
+    bool rotated = state.angle != renderState.angle;
+    renderState = state;
+    if(rotated) {
+        markTransformDirty();
     }
     else {
-        return -1;
+        markDirty();
+    }
+}
+
+/**
+ * @brief Marks the object as changed so the renderer redraws the area it covers
+ * 
+ */
+void Object::markDirty() {
+    isDirty = true;
+    for(Object* p = parent; p && !p->hasDirtyChildren; p = p->parent) {
+        p->hasDirtyChildren = true;
+    }
+}
+
+/**
+ * @brief Marks the object and all its descendants as changed (e.g. when the object is shown or hidden)
+ * 
+ */
+void Object::markSubtreeDirty() {
+    markDirty();
+    for(auto& child : children) {
+        child->markSubtreeDirty();
+    }
+}
+
+/**
+ * @brief Marks the cached world position of the object (and so of its descendants) as outdated
+ * 
+ */
+void Object::markTransformDirty() {
+    transformDirty = true;
+    markDirty();
+    for(Object* p = parent; p && !p->hasDirtyTransforms; p = p->parent) {
+        p->hasDirtyTransforms = true;
     }
 }
 
+/**
+ * @brief Gets the screen rectangle covered by the object
+ * 
+ * @return SDL_Rect 
+ */
+SDL_Rect Object::getRect() const {
+    return {static_cast<int>(worldX), static_cast<int>(worldY), static_cast<int>(width), static_cast<int>(height)};
+}
+
+/**
+ * @brief Gets the screen rectangle the object paints, which is bigger than its rectangle when it is rotated and smaller when it is cut by its clipRect
+ * 
+ * @return SDL_Rect 
+ */
+SDL_Rect Object::getDrawnRect() const {
+    SDL_Rect drawn = rotatedBounds(getRect(), renderState.angle);
+    if(clipRect.w > 0 && !SDL_IntersectRect(&drawn, &clipRect, &drawn)) {
+        return {0, 0, 0, 0};
+    }
+    return drawn;
+}
+
+/**
+ * @brief Checks if the object is shown, which requires the object and all its ancestors to be active
+ * 
+ * @return true If the object and its ancestors are active
+ * @return false Otherwise
+ */
+bool Object::isVisible() const {
+    for(const Object* obj = this; obj; obj = obj->parent) {
+        if(!obj->isActive) {
+            return false;
+        }
+    }
+    return true;
+}
+
 /**
  * @brief Verifies if the mouse is over the object
  * 
@@ -81,7 +147,10 @@ int Object::changeTexture(const std::string& newTextureId, TextureManager& textu
  * @return false If the mouse is not over the object
  */
 bool Object::isMouseOver(int mouseX, int mouseY) {
-    return (mouseX >= x && mouseX <= x + width && mouseY >= y && mouseY <= y + height);
+    if(clipRect.w > 0 && (mouseX < clipRect.x || mouseX >= clipRect.x + clipRect.w || mouseY < clipRect.y || mouseY >= clipRect.y + clipRect.h)) {
+        return false;
+    }
+    return (mouseX >= worldX && mouseX <= worldX + width && mouseY >= worldY && mouseY <= worldY + height);
 }
 
 /**
@@ -104,6 +173,7 @@ void ObjectManager::createObject(const std::string& id, float x, float y, float
 
     Object* newObject = new Object(id, x, y, width, height, textureId, isClickable);
     allObjects[id] = newObject;
+    rootObjects.push_back(newObject);
 }
 
 /**
@@ -118,6 +188,10 @@ void ObjectManager::addObject(Object* obj){
     }
 
     allObjects[obj->id] = obj;
+    drawBatchesDirty = true;
+    if(!obj->parent) {
+        rootObjects.push_back(obj);
+    }
     if(obj->isActive) {
         activeObjects.push_back(obj);
     }
@@ -139,13 +213,30 @@ void ObjectManager::destroyObject(const std::string& id){
     }
 
     Object* obj = allObjects[id];
+    animations.stop(obj);
     if(obj->isActive) {
         deactivateObject(id);
     }
     if(obj->isClickable) {
         makeNonClickable(id);
     }
+    if(obj->wasDrawn) {
+        damagedRects.push_back(obj->lastDrawnRect);
+    }
+    hoveredObjects.erase(
+        std::remove(hoveredObjects.begin(), hoveredObjects.end(), obj),
+        hoveredObjects.end()
+    );
+
+    // Children survive their parent, they become roots and keep their position on the screen
+    removeFromParent(obj);
+    for(auto& child : obj->children) {
+        child->parent = nullptr;
+        child->setPosition(child->worldX, child->worldY);
+        rootObjects.push_back(child);
+    }
     allObjects.erase(id);
+    drawBatchesDirty = true;
     delete obj;
 }
 
@@ -176,7 +267,10 @@ void ObjectManager::activateObject(const std::string& id){
     }
 
     it->second->isActive = true;
+    it->second->markSubtreeDirty();
     activeObjects.push_back(it->second);
+    hoverDirty = true;
+    drawBatchesDirty = true;
 }
 
 /**
@@ -192,6 +286,9 @@ void ObjectManager::deactivateObject(const std::string& id){
     }
 
     it->second->isActive = false;
+    it->second->markSubtreeDirty();
+    hoverDirty = true;
+    drawBatchesDirty = true;
     activeObjects.erase(
         std::remove(activeObjects.begin(), activeObjects.end(), it->second),
         activeObjects.end()
@@ -234,28 +331,242 @@ void ObjectManager::makeNonClickable(const std::string& id){
     );
 }
 
+/**
+ * @brief Makes an object child of another one. The child position becomes relative to its parent
+ * 
+ * @param parentId ID of the new parent
+ * @param childId ID of the object to attach
+ * @return int 0 on success, -1 if an object does not exist or the attachment would create a cycle
+ */
+int ObjectManager::attachChild(const std::string& parentId, const std::string& childId){
+    Object* parentObj = getObjectById(parentId);
+    Object* child = getObjectById(childId);
+    if(!parentObj || !child) {
+        SDL_Log("ERROR: Cannot attach %s to %s, object does not exist.\n", childId.c_str(), parentId.c_str());
+        return -1;
+    }
+
+    for(Object* p = parentObj; p; p = p->parent) {
+        if(p == child) {
+            SDL_Log("ERROR: Cannot attach %s to %s, it would create a cycle.\n", childId.c_str(), parentId.c_str());
+            return -1;
+        }
+    }
+
+    removeFromParent(child);
+    child->parent = parentObj;
+    parentObj->children.push_back(child);
+    drawBatchesDirty = true;
+    child->markTransformDirty();
+    return 0;
+}
+
+/**
+ * @brief Detaches an object from its parent. It becomes a root object and keeps its position on the screen
+ * 
+ * @param childId 
+ * @return int 0 on success, -1 if the object does not exist or has no parent
+ */
+int ObjectManager::detachChild(const std::string& childId){
+    Object* child = getObjectById(childId);
+    if(!child || !child->parent) {
+        SDL_Log("ERROR: Cannot detach %s, object does not exist or has no parent.\n", childId.c_str());
+        return -1;
+    }
+
+    removeFromParent(child);
+    rootObjects.push_back(child);
+    child->setPosition(child->worldX, child->worldY);
+    return 0;
+}
+
+/**
+ * @brief Removes an object from its parent children (or from the roots if it has no parent)
+ * 
+ * @param obj 
+ */
+void ObjectManager::removeFromParent(Object* obj){
+    drawBatchesDirty = true;
+    if(obj->parent) {
+        Object* oldParent = obj->parent;
+        oldParent->children.erase(
+            std::remove(oldParent->children.begin(), oldParent->children.end(), obj),
+            oldParent->children.end()
+        );
+        obj->parent = nullptr;
+        // bounds of the old parent changed
+        oldParent->markTransformDirty();
+    }
+    else {
+        rootObjects.erase(
+            std::remove(rootObjects.begin(), rootObjects.end(), obj),
+            rootObjects.end()
+        );
+    }
+}
+
+/**
+ * @brief Recomputes the cached world positions and subtree bounds. Only subtrees with changes are visited.
+ * 
+ */
+void ObjectManager::updateTransforms(){
+    for(auto& root : rootObjects) {
+        updateSubtree(root, 0, 0, false);
+    }
+}
+
+/**
+ * @brief Recomputes the world position of an object (if needed) and walks down the children that changed
+ * 
+ * @param obj 
+ * @param parentX World X coordinate of the parent
+ * @param parentY World Y coordinate of the parent
+ * @param force Whether the parent moved, so the whole subtree must be recomputed
+ */
+void ObjectManager::updateSubtree(Object* obj, float parentX, float parentY, bool force){
+    if(!force && !obj->transformDirty && !obj->hasDirtyTransforms) {
+        return;
+    }
+
+    bool recompute = force || obj->transformDirty;
+    if(recompute) {
+        // something moved or changed size, it may have moved under the mouse
+        hoverDirty = true;
+        float newX = parentX + obj->x;
+        float newY = parentY + obj->y;
+        if(newX != obj->worldX || newY != obj->worldY) {
+            obj->worldX = newX;
+            obj->worldY = newY;
+            obj->markDirty();
+        }
+    }
+
+    // the painted area: a rotated object reaches out of its rectangle
+    SDL_Rect bounds = obj->getDrawnRect();
+    for(auto& child : obj->children) {
+        updateSubtree(child, obj->worldX, obj->worldY, recompute);
+        if(child->subtreeBounds.w > 0 && child->subtreeBounds.h > 0) {
+            SDL_UnionRect(&bounds, &child->subtreeBounds, &bounds);
+        }
+    }
+    obj->subtreeBounds = bounds;
+    obj->transformDirty = false;
+    obj->hasDirtyTransforms = false;
+}
+
 /**
  * @brief Destroys all objects managed by the ObjectManager.
  * 
  */
 void ObjectManager::destroyAllObjects(){
-    for (auto& i : allObjects) {
+    animations.clear();
+    // taken out first: destructors (the store's) look up and destroy other objects
+    std::map<std::string, Object*> objects;
+    objects.swap(allObjects);
+    for (auto& i : objects) {
+        if(i.second->wasDrawn) {
+            damagedRects.push_back(i.second->lastDrawnRect);
+        }
         delete i.second;
     }
-    allObjects.clear();
+    rootObjects.clear();
     activeObjects.clear();
     clickActiveObjects.clear();
+    hoveredObjects.clear();
+    spriteBatch.clear();
+    spriteSubtreeEnd.clear();
+    textBatch.clear();
+    drawBatchesDirty = true;
 }
 
 /**
- * @brief Draws all active objects on the screen.
+ * @brief Rebuilds the draw batches from the visible objects of the tree
  * 
- * @param textureManager 
  */
-void ObjectManager::drawActiveObjects(TextureManager& textureManager) {
-    for (auto& obj : activeObjects) {
-        obj->drawObject(textureManager);
+void ObjectManager::rebuildDrawBatches() {
+    spriteBatch.clear();
+    spriteSubtreeEnd.clear();
+    textBatch.clear();
+    for (auto& obj : rootObjects) {
+        collectDrawBatches(obj);
     }
+    drawBatchesDirty = false;
+}
+
+/**
+ * @brief Adds an object and its children to the batch of their kind. Inactive subtrees are skipped as a whole
+ * 
+ * @param obj 
+ */
+void ObjectManager::collectDrawBatches(Object* obj) {
+    if(!obj->isActive) {
+        return;
+    }
+
+    size_t index = spriteBatch.size();
+    bool sprite = obj->kind != OBJECT_TEXT;
+    if(sprite) {
+        spriteBatch.push_back(obj);
+        spriteSubtreeEnd.push_back(0);
+    }
+    else {
+        textBatch.push_back(static_cast<Text*>(obj));
+    }
+    for(auto& child : obj->children) {
+        collectDrawBatches(child);
+    }
+    // the drawing loop jumps here when the subtree is out of the area
+    if(sprite) {
+        spriteSubtreeEnd[index] = spriteBatch.size();
+    }
+}
+
+/**
+ * @brief Finds the topmost visible object under a point. Children are tested before their parent and inactive subtrees or subtrees that do not contain the point are skipped.
+ * 
+ * @param x 
+ * @param y 
+ * @param clickableOnly Whether to ignore objects that are not clickable
+ * @return Object* The object found, or nullptr
+ */
+Object* ObjectManager::hitTest(int x, int y, bool clickableOnly) {
+    updateTransforms();
+
+    for(auto it = rootObjects.rbegin(); it != rootObjects.rend(); ++it) {
+        Object* hit = hitTestSubtree(*it, x, y, clickableOnly);
+        if(hit) {
+            return hit;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Finds the topmost object under a point inside a subtree
+ * 
+ * @param obj 
+ * @param x 
+ * @param y 
+ * @param clickableOnly 
+ * @return Object* 
+ */
+Object* ObjectManager::hitTestSubtree(Object* obj, int x, int y, bool clickableOnly) {
+    const SDL_Rect& b = obj->subtreeBounds;
+    if(!obj->isActive || x < b.x || x > b.x + b.w || y < b.y || y > b.y + b.h) {
+        return nullptr;
+    }
+
+    for(auto it = obj->children.rbegin(); it != obj->children.rend(); ++it) {
+        Object* hit = hitTestSubtree(*it, x, y, clickableOnly);
+        if(hit) {
+            return hit;
+        }
+    }
+
+    if((!clickableOnly || obj->isClickable) && obj->isMouseOver(x, y)) {
+        return obj;
+    }
+    return nullptr;
 }
 
 /**
@@ -265,14 +576,12 @@ void ObjectManager::drawActiveObjects(TextureManager& textureManager) {
  * @return int 
  */
 int ObjectManager::handleMouseClick(SDL_Event& e) {
-    int mouseX = e.button.x;
-    int mouseY = e.button.y;
-
-    for (auto& obj : clickActiveObjects) {
-        if (obj->isMouseOver(mouseX, mouseY)) {
-            obj->onClick();
-            return 0;
-        }
+    Object* obj = hitTest(e.button.x, e.button.y);
+    if (obj) {
+        obj->onClick();
+        // the effect of the click is shown by the next present
+        latencyTracker().inputHandled(e.button.timestamp);
+        return 0;
     }
     return -1;
 }
@@ -284,46 +593,197 @@ int ObjectManager::handleMouseClick(SDL_Event& e) {
  * @return int 
  */
 int ObjectManager::handleMouseRelease(SDL_Event& e) {
-    int mouseX = e.button.x;
-    int mouseY = e.button.y;
-
-    for (auto& obj : clickActiveObjects) {
-        if (obj->isMouseOver(mouseX, mouseY)) {
-            obj->onRelease();
-            return 0;
-        }
+    Object* obj = hitTest(e.button.x, e.button.y);
+    if (obj) {
+        obj->onRelease();
+        return 0;
     }
     return -1;
 }
 
 
 /**
- * @brief Handles mouse over events for clickable objects.
+ * @brief Handles a mouse motion event right away. The main loop uses queueMouseMotion() and updateHover() instead
  * 
  * @param e 
- * @return int 
+ * @return int 0 if the mouse is over an object, -1 otherwise
  */
 int ObjectManager::handleMouseOver(SDL_Event& e) {
-    int mouseX = e.motion.x;
-    int mouseY = e.motion.y;
-
-    for (auto& obj : activeObjects) {
-        if (obj->isMouseOver(mouseX, mouseY)) {
-            obj->onMouseOver();
-            return 0;
-        } else {
+    queueMouseMotion(e);
+    updateHover();
+    return hoveredObjects.empty() ? -1 : 0;
+}
+
+/**
+ * @brief Takes note of a mouse motion event. Nothing is hit-tested until updateHover(), so any number of motion
+ * events in a frame cost the same
+ * 
+ * @param e 
+ */
+void ObjectManager::queueMouseMotion(const SDL_Event& e) {
+    hasMouse = true;
+    mouseX = e.motion.x;
+    mouseY = e.motion.y;
+    hoverDirty = true;
+}
+
+/**
+ * @brief Takes note that the mouse left the window, everything hovered gets onMouseOut() on the next updateHover()
+ * 
+ */
+void ObjectManager::mouseLeft() {
+    hasMouse = false;
+    hoverDirty = true;
+}
+
+/**
+ * @brief Updates the hovered objects with the last mouse position. Call it once per frame.
+ * 
+ * The object under the mouse and its ancestors are hovered. Only transitions are delivered: onMouseOut() to the
+ * objects that stopped being hovered (innermost first) and onMouseOver() to the new ones (outermost first).
+ * Nothing is done if the mouse did not move and no object changed.
+ */
+void ObjectManager::updateHover() {
+    if(!hoverDirty) {
+        return;
+    }
+    hoverDirty = false;
+
+    nextHovered.clear();
+    Object* hit = hasMouse ? hitTest(mouseX, mouseY, false) : nullptr;
+    for(Object* obj = hit; obj; obj = obj->parent) {
+        nextHovered.push_back(obj);
+    }
+    if(nextHovered == hoveredObjects) {
+        return;
+    }
+
+    // both lists are a path to the root, they are as long as the tree is deep
+    for(Object* obj : hoveredObjects) {
+        if(std::find(nextHovered.begin(), nextHovered.end(), obj) == nextHovered.end()) {
             obj->onMouseOut();
         }
     }
-    return -1;
+    for(auto it = nextHovered.rbegin(); it != nextHovered.rend(); ++it) {
+        if(std::find(hoveredObjects.begin(), hoveredObjects.end(), *it) == hoveredObjects.end()) {
+            (*it)->onMouseOver();
+        }
+    }
+    hoveredObjects.swap(nextHovered);
 }
 
-void ObjectManager::drawAllTexts(SDL_Renderer** rendererPtr){
-    for(auto& text : textObjects){
-        text->drawText(rendererPtr);
-    }
+/**
+ * @brief Records a mutation to be applied by applyCommands(). It can be called from any thread and from inside
+ * the callbacks of the objects (onClick...), where changing the lists of the manager directly is not safe
+ * 
+ * @param command 
+ */
+void ObjectManager::defer(const ObjectCommand& command){
+    commands.push(command);
 }
 
+/**
+ * @brief Records a mutation of an object by its ID (activate, deactivate, destroy, make clickable or non-clickable, detach)
+ * 
+ * @param type 
+ * @param id 
+ */
+void ObjectManager::defer(ObjectCommandType type, const std::string& id){
+    ObjectCommand command;
+    command.type = type;
+    command.id = id;
+    commands.push(command);
+}
+
+/**
+ * @brief Records an object to be added
+ * 
+ * @param object 
+ */
+void ObjectManager::deferAdd(Object* object){
+    ObjectCommand command;
+    command.type = OBJECT_COMMAND_ADD;
+    command.object = object;
+    commands.push(command);
+}
 
+/**
+ * @brief Records an object to be attached to a parent
+ * 
+ * @param parentId 
+ * @param childId 
+ */
+void ObjectManager::deferAttach(const std::string& parentId, const std::string& childId){
+    ObjectCommand command;
+    command.type = OBJECT_COMMAND_ATTACH;
+    command.id = childId;
+    command.parentId = parentId;
+    commands.push(command);
+}
 
+/**
+ * @brief Records a new position of an object
+ * 
+ * @param id 
+ * @param x X coordinate, relative to its parent
+ * @param y Y coordinate, relative to its parent
+ */
+void ObjectManager::deferSetPosition(const std::string& id, float x, float y){
+    ObjectCommand command;
+    command.type = OBJECT_COMMAND_SET_POSITION;
+    command.id = id;
+    command.x = x;
+    command.y = y;
+    commands.push(command);
+}
 
+/**
+ * @brief Applies the deferred mutations in the order they were recorded. Called by the main thread once per frame,
+ * outside of any iteration over the objects
+ * 
+ * @return int Number of mutations applied
+ */
+int ObjectManager::applyCommands(){
+    int applied = 0;
+    ObjectCommand command;
+    while(commands.pop(command)) {
+        switch(command.type) {
+            case OBJECT_COMMAND_ADD:
+                addObject(command.object);
+                break;
+            case OBJECT_COMMAND_DESTROY:
+                destroyObject(command.id);
+                break;
+            case OBJECT_COMMAND_ACTIVATE:
+                activateObject(command.id);
+                break;
+            case OBJECT_COMMAND_DEACTIVATE:
+                deactivateObject(command.id);
+                break;
+            case OBJECT_COMMAND_MAKE_CLICKABLE:
+                makeClickable(command.id);
+                break;
+            case OBJECT_COMMAND_MAKE_NON_CLICKABLE:
+                makeNonClickable(command.id);
+                break;
+            case OBJECT_COMMAND_ATTACH:
+                attachChild(command.parentId, command.id);
+                break;
+            case OBJECT_COMMAND_DETACH:
+                detachChild(command.id);
+                break;
+            case OBJECT_COMMAND_SET_POSITION: {
+                Object* obj = getObjectById(command.id);
+                if(obj) {
+                    obj->setPosition(command.x, command.y);
+                }
+                else {
+                    SDL_Log("ERROR: Object with ID %s does not exist.\n", command.id.c_str());
+                }
+                break;
+            }
+        }
+        applied++;
+    }
+    return applied;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file objectsDraw.cpp
+ * @author Iván Mansilla
+ * @brief Drawing of the objects, kept apart from their logic so the headless tools link without the renderer.
+ * @version 0.1
+ * @date 2025-08-03
+ *
+ *
+ */
+
+#include "../inc/objects.h"
+#include "../inc/text.h"
+#include "../inc/debugHud.h"
+
+/**
+ * @brief Draws the object
+ * 
+ * @param textureManager Texture manager to handle texture drawing
+ */
+void Object::drawObject(TextureManager& textureManager){
+    SDL_Rect* source = frameClip.w > 0 ? &frameClip : nullptr;
+    if(clipRect.w <= 0) {
+        textureManager.drawTexture(textureId, worldX, worldY, width, height, source, &renderState);
+        return;
+    }
+
+    // cut to the clip rectangle, inside the one already set (the region being redrawn)
+    RenderBackend* backend = textureManager.getBackend();
+    SDL_Rect previous;
+    bool clipped = backend->getClip(&previous);
+    SDL_Rect clip = clipRect;
+    if(clipped && !SDL_IntersectRect(&clip, &previous, &clip)) {
+        return;
+    }
+    backend->setClip(&clip);
+    textureManager.drawTexture(textureId, worldX, worldY, width, height, source, &renderState);
+    backend->setClip(clipped ? &previous : nullptr);
+}
+
+/**
+ * @brief Changes the texture of the object
+ * 
+ * @param newTextureId ID of the new texture
+ * @param textureManager Texture manager to handle texture loading
+ * @return int 0 on success, -1 if the texture does not exist or could not be loaded
+ */
+int Object::changeTexture(const std::string& newTextureId, TextureManager& textureManager){
+    if(textureManager.requireTexture(newTextureId) == 0) {
+        this->textureId = newTextureId;
+        markDirty();
+        return 0;
+    }
+    else {
+        return -1;
+    }
+}
+
+/**
+ * @brief Draws the visible sprites. They are drawn from a flat batch in tree order (parents before their children), rebuilt only when the tree changes.
+ * A subtree whose bounds miss the area is skipped as a whole.
+ * 
+ * @param textureManager 
+ * @param region Only objects intersecting this area are drawn (optional, the whole screen by default)
+ */
+void ObjectManager::drawActiveObjects(TextureManager& textureManager, const SDL_Rect* region) {
+    updateTransforms();
+    if(drawBatchesDirty) {
+        rebuildDrawBatches();
+    }
+
+    SDL_Rect area = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+    if(region) {
+        area = *region;
+    }
+    for (size_t i = 0; i < spriteBatch.size();) {
+        Object* obj = spriteBatch[i];
+        if(!SDL_HasIntersection(&obj->subtreeBounds, &area)) {
+            i = spriteSubtreeEnd[i];
+            continue;
+        }
+        SDL_Rect rect = obj->getDrawnRect();
+        if(SDL_HasIntersection(&rect, &area)) {
+            obj->drawObject(textureManager);
+            if(overdraw) {
+                overdraw->add(rect, &area);
+            }
+        }
+        i++;
+    }
+}
+
+/**
+ * @brief Draws the visible texts, on top of the sprites.
+ * 
+ * @param backend 
+ * @param region Only texts intersecting this area are drawn (optional)
+ */
+void ObjectManager::drawAllTexts(RenderBackend* backend, const SDL_Rect* region){
+    if(drawBatchesDirty) {
+        updateTransforms();
+        rebuildDrawBatches();
+    }
+
+    for(Text* text : textBatch){
+        SDL_Rect rect = text->getDrawnRect();
+        if(!region || SDL_HasIntersection(&rect, region)){
+            text->drawText(backend);
+            if(overdraw){
+                overdraw->add(rect, region);
+            }
+        }
+    }
+}
@@ -0,0 +1,250 @@
+/**
+ * @file rulesEngine.cpp
+ * @author Iván Mansilla
+ * @brief Achievements and unlock conditions over numeric stats.
+ * @version 0.1
+ * @date 2025-08-01
+ *
+ *
+ */
+
+#include "../inc/rulesEngine.h"
+#include "../inc/config.h"
+
+/**
+ * @brief Adds a stat. If it already exists its value is set
+ *
+ * @param name
+ * @param value Initial value
+ * @return int ID of the stat
+ */
+int RulesEngine::addStat(const std::string& name, double value){
+    auto it = statIds.find(name);
+    if(it != statIds.end()) {
+        setStat(it->second, value);
+        return it->second;
+    }
+
+    int id = static_cast<int>(stats.size());
+    stats.push_back({name, value, {}});
+    statIds[name] = id;
+    return id;
+}
+
+/**
+ * @brief Finds a stat by name
+ *
+ * @param name
+ * @return int ID of the stat, -1 if it does not exist
+ */
+int RulesEngine::findStat(const std::string& name) const {
+    auto it = statIds.find(name);
+    return it == statIds.end() ? -1 : it->second;
+}
+
+/**
+ * @brief Changes the value of a stat. Only the thresholds between the old and the new value are visited
+ *
+ * @param stat
+ * @param value
+ */
+void RulesEngine::setStat(int stat, double value){
+    Stat& entry = stats[stat];
+    double old = entry.value;
+    if(value == old) {
+        return;
+    }
+    entry.value = value;
+
+    auto beforeThreshold = [](double a, const std::pair<double, int>& b){ return a < b.first; };
+    if(value > old) {
+        // thresholds in (old, value] start to hold
+        auto it = std::upper_bound(entry.thresholds.begin(), entry.thresholds.end(), old, beforeThreshold);
+        for(; it != entry.thresholds.end() && it->first <= value; ++it) {
+            setNodeState(it->second, true);
+        }
+    }
+    else {
+        // thresholds in (value, old] stop holding
+        auto it = std::upper_bound(entry.thresholds.begin(), entry.thresholds.end(), value, beforeThreshold);
+        for(; it != entry.thresholds.end() && it->first <= old; ++it) {
+            setNodeState(it->second, false);
+        }
+    }
+
+    runFiredRules();
+}
+
+/**
+ * @brief Changes the state of a condition and updates the compound conditions it is part of
+ *
+ * @param node
+ * @param satisfied
+ */
+void RulesEngine::setNodeState(int node, bool satisfied){
+    Node& entry = nodes[node];
+    if(entry.satisfied == satisfied) {
+        return;
+    }
+    entry.satisfied = satisfied;
+    evaluations++;
+
+    if(satisfied) {
+        for(int rule : entry.rules) {
+            if(!rules[rule].fired) {
+                rules[rule].fired = true;
+                firedRules.push_back(rule);
+            }
+        }
+    }
+
+    for(int parent : entry.parents) {
+        Node& compound = nodes[parent];
+        compound.satisfiedChildren += satisfied ? 1 : -1;
+        bool holds = compound.type == NODE_ALL ? compound.satisfiedChildren == compound.childCount : compound.satisfiedChildren > 0;
+        setNodeState(parent, holds);
+    }
+}
+
+/**
+ * @brief Calls the rules fired by the last change. They run after the change is done, so they can change stats themselves
+ *
+ */
+void RulesEngine::runFiredRules(){
+    while(!firedRules.empty()) {
+        int rule = firedRules.back();
+        firedRules.pop_back();
+        SDL_Log("Rule '%s' satisfied\n", rules[rule].name.c_str());
+        if(rules[rule].onSatisfied) {
+            rules[rule].onSatisfied();
+        }
+    }
+}
+
+/**
+ * @brief Adds the condition "stat >= threshold"
+ *
+ * @param stat
+ * @param threshold
+ * @return int ID of the condition, -1 if the stat does not exist
+ */
+int RulesEngine::addThreshold(int stat, double threshold){
+    if(stat < 0 || stat >= static_cast<int>(stats.size())) {
+        SDL_Log("ERROR: Cannot add threshold, stat %d does not exist.\n", stat);
+        return -1;
+    }
+
+    int id = static_cast<int>(nodes.size());
+    Node node;
+    node.type = NODE_THRESHOLD;
+    node.satisfied = stats[stat].value >= threshold;
+    nodes.push_back(node);
+
+    std::vector<std::pair<double, int>>& thresholds = stats[stat].thresholds;
+    std::pair<double, int> entry(threshold, id);
+    thresholds.insert(std::upper_bound(thresholds.begin(), thresholds.end(), entry), entry);
+    return id;
+}
+
+/**
+ * @brief Adds a compound condition
+ *
+ * @param type
+ * @param children
+ * @return int ID of the condition, -1 if a child does not exist
+ */
+int RulesEngine::addCompound(NodeType type, const std::vector<int>& children){
+    int id = static_cast<int>(nodes.size());
+    Node node;
+    node.type = type;
+    node.childCount = static_cast<int>(children.size());
+    for(int child : children) {
+        if(child < 0 || child >= id) {
+            SDL_Log("ERROR: Cannot add compound condition, condition %d does not exist.\n", child);
+            return -1;
+        }
+        if(nodes[child].satisfied) {
+            node.satisfiedChildren++;
+        }
+    }
+    node.satisfied = type == NODE_ALL ? node.satisfiedChildren == node.childCount : node.satisfiedChildren > 0;
+    nodes.push_back(node);
+
+    for(int child : children) {
+        nodes[child].parents.push_back(id);
+    }
+    return id;
+}
+
+/**
+ * @brief Adds a condition that holds when all the children hold
+ *
+ * @param children
+ * @return int ID of the condition, -1 if a child does not exist
+ */
+int RulesEngine::addAll(const std::vector<int>& children){
+    return addCompound(NODE_ALL, children);
+}
+
+/**
+ * @brief Adds a condition that holds when any of the children holds
+ *
+ * @param children
+ * @return int ID of the condition, -1 if a child does not exist
+ */
+int RulesEngine::addAny(const std::vector<int>& children){
+    return addCompound(NODE_ANY, children);
+}
+
+/**
+ * @brief Adds a rule, fired once the first time its condition holds (right away if it already holds)
+ *
+ * @param name
+ * @param condition
+ * @param onSatisfied
+ * @return int ID of the rule, -1 if the condition does not exist
+ */
+int RulesEngine::addRule(const std::string& name, int condition, std::function<void()> onSatisfied){
+    if(condition < 0 || condition >= static_cast<int>(nodes.size())) {
+        SDL_Log("ERROR: Cannot add rule %s, condition %d does not exist.\n", name.c_str(), condition);
+        return -1;
+    }
+
+    int id = static_cast<int>(rules.size());
+    rules.push_back({name, condition, onSatisfied, false});
+    nodes[condition].rules.push_back(id);
+
+    if(nodes[condition].satisfied) {
+        rules[id].fired = true;
+        firedRules.push_back(id);
+        runFiredRules();
+    }
+    return id;
+}
+
+/**
+ * @brief Checks if a condition holds
+ *
+ * @param condition
+ * @return true
+ * @return false
+ */
+bool RulesEngine::isSatisfied(int condition) const {
+    return condition >= 0 && condition < static_cast<int>(nodes.size()) && nodes[condition].satisfied;
+}
+
+/**
+ * @brief Checks if a rule was fired
+ *
+ * @param name
+ * @return true
+ * @return false
+ */
+bool RulesEngine::hasFired(const std::string& name) const {
+    for(const Rule& rule : rules) {
+        if(rule.name == name) {
+            return rule.fired;
+        }
+    }
+    return false;
+}
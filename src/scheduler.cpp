@@ -0,0 +1,348 @@
+/**
+ * @file scheduler.cpp
+ * @author Iván Mansilla
+ * @brief Cooperative scheduler of coroutine sequences driven by the game clock.
+ * @version 0.1
+ * @date 2025-08-03
+ *
+ *
+ */
+
+#include "../inc/scheduler.h"
+#include <algorithm>
+#include <exception>
+
+/**
+ * @brief Pool the coroutine frames of the sequences are allocated from. Frames of the same size are recycled, so
+ * a sequence started every frame reuses the memory of the last one that ended. Not synchronized: sequences are
+ * created and destroyed on the thread that runs the scheduler
+ *
+ * @return std::pmr::memory_resource&
+ */
+std::pmr::memory_resource& coroutineFramePool(){
+    static std::pmr::unsynchronized_pool_resource pool(std::pmr::pool_options{0, SEQUENCE_FRAME_POOL_MAX});
+    return pool;
+}
+
+/**
+ * @brief Allocates the frame of a coroutine from the pool
+ *
+ * @param size
+ * @return void*
+ */
+void* Sequence::promise_type::operator new(size_t size){
+    return coroutineFramePool().allocate(size, alignof(std::max_align_t));
+}
+
+/**
+ * @brief Gives the frame of a coroutine back to the pool
+ *
+ * @param ptr
+ * @param size
+ */
+void Sequence::promise_type::operator delete(void* ptr, size_t size){
+    coroutineFramePool().deallocate(ptr, size, alignof(std::max_align_t));
+}
+
+/**
+ * @brief Logs an exception that left a sequence. The sequence ends there: it goes to its final suspend and the
+ * scheduler releases it like one that finished, the game goes on
+ *
+ */
+void Sequence::promise_type::unhandled_exception(){
+    try {
+        throw;
+    }
+    catch(const std::exception& e) {
+        SDL_Log("ERROR: Exception in a sequence of the scheduler: %s\n", e.what());
+    }
+    catch(...) {
+        SDL_Log("ERROR: Exception in a sequence of the scheduler.\n");
+    }
+}
+
+/**
+ * @brief Takes the coroutine of another sequence, destroying its own if it was not started
+ *
+ * @param other
+ * @return Sequence&
+ */
+Sequence& Sequence::operator=(Sequence&& other) noexcept {
+    if(this != &other) {
+        if(handle) {
+            handle.destroy();
+        }
+        handle = other.handle;
+        other.handle = nullptr;
+    }
+    return *this;
+}
+
+/**
+ * @brief Destroy the Sequence object. A sequence that was never started is destroyed without running
+ *
+ */
+Sequence::~Sequence(){
+    if(handle) {
+        handle.destroy();
+    }
+}
+
+/**
+ * @brief Queues the sequence for the next update
+ *
+ * @param handle
+ */
+void NextTickAwaiter::await_suspend(Sequence::Handle handle){
+    Scheduler* scheduler = handle.promise().scheduler;
+    int slot = handle.promise().slot;
+    scheduler->ticking.push_back({slot, scheduler->slots[slot].generation});
+}
+
+/**
+ * @brief Adds a timer that resumes the sequence
+ *
+ * @param handle
+ */
+void DelayAwaiter::await_suspend(Sequence::Handle handle){
+    Scheduler* scheduler = handle.promise().scheduler;
+    int slot = handle.promise().slot;
+    if(milliseconds == 0) {
+        scheduler->ticking.push_back({slot, scheduler->slots[slot].generation});
+        return;
+    }
+    scheduler->addTimer(slot, milliseconds);
+}
+
+/**
+ * @brief Stores the condition in the slot of the sequence and checks it on every update or on a timer
+ *
+ * @param handle
+ */
+void WaitUntilAwaiter::await_suspend(Sequence::Handle handle){
+    Scheduler* scheduler = handle.promise().scheduler;
+    int slot = handle.promise().slot;
+    scheduler->slots[slot].condition = std::move(condition);
+    scheduler->slots[slot].interval = interval;
+    if(interval == 0) {
+        scheduler->polling.push_back({slot, scheduler->slots[slot].generation});
+        return;
+    }
+    scheduler->addTimer(slot, interval);
+}
+
+/**
+ * @brief Destroy the Scheduler object and the sequences that did not end
+ *
+ */
+Scheduler::~Scheduler(){
+    clear();
+}
+
+/**
+ * @brief Checks if a waiter still refers to the sequence that started waiting
+ *
+ * @param waiter
+ * @return true
+ * @return false
+ */
+bool Scheduler::isValid(const Waiter& waiter) const {
+    const Slot& slot = slots[waiter.slot];
+    return slot.generation == waiter.generation && slot.handle && !slot.cancelled;
+}
+
+/**
+ * @brief Resumes a sequence until it suspends again, and destroys it if it ended or was cancelled meanwhile
+ *
+ * @param waiter
+ */
+void Scheduler::resume(const Waiter& waiter){
+    // the handle is copied: the sequence can start others, which may move the slots
+    Sequence::Handle handle = slots[waiter.slot].handle;
+    slots[waiter.slot].resuming = true;
+    handle.resume();
+    slots[waiter.slot].resuming = false;
+    if(handle.done() || slots[waiter.slot].cancelled) {
+        release(waiter.slot);
+    }
+}
+
+/**
+ * @brief Checks the condition a sequence waits for, and forgets it when it is true
+ *
+ * @param slot
+ * @return true if the condition is true. Either way the condition may have cancelled the sequence, callers check the slot is still valid
+ */
+bool Scheduler::checkCondition(int slot){
+    // moved out while it runs, the condition may start sequences and move the slots
+    Waiter waiter = {slot, slots[slot].generation};
+    std::function<bool()> condition = std::move(slots[slot].condition);
+    if(condition()) {
+        return true;
+    }
+    // it may also have cancelled its own sequence, then the slot is free and keeps no condition
+    if(isValid(waiter)) {
+        slots[slot].condition = std::move(condition);
+    }
+    return false;
+}
+
+/**
+ * @brief Destroys the coroutine of a slot, cancels its timer and frees it. Waiters that refer to it become stale
+ *
+ * @param slot
+ */
+void Scheduler::release(int slot){
+    if(slots[slot].timer) {
+        timers.cancel(slots[slot].timer);
+        slots[slot].timer = 0;
+    }
+    slots[slot].handle.destroy();
+    slots[slot].handle = nullptr;
+    slots[slot].condition = nullptr;
+    slots[slot].cancelled = false;
+    slots[slot].generation++;
+    freeSlots.push_back(slot);
+    activeCount--;
+}
+
+/**
+ * @brief Adds a timer that wakes a sequence
+ *
+ * @param slot
+ * @param delay Milliseconds from the time of the current update
+ */
+void Scheduler::addTimer(int slot, Uint32 delay){
+    Waiter waiter = {slot, slots[slot].generation};
+    // sequences resumed before the timers are updated would count from the last update
+    slots[slot].timer = timers.addTimer(now - timers.getTime() + delay, [this, waiter](const TimerEvent&){
+        wake(waiter);
+    });
+}
+
+/**
+ * @brief Resumes a sequence whose timer fired, or adds the timer again if the condition it waits for is not true
+ *
+ * @param waiter
+ */
+void Scheduler::wake(const Waiter& waiter){
+    if(!isValid(waiter)) {
+        return;
+    }
+    slots[waiter.slot].timer = 0;
+    if(slots[waiter.slot].condition && !checkCondition(waiter.slot)) {
+        if(isValid(waiter)) {
+            addTimer(waiter.slot, slots[waiter.slot].interval);
+        }
+        return;
+    }
+    // a condition that was true may still have cancelled its sequence
+    if(isValid(waiter)) {
+        resume(waiter);
+    }
+}
+
+/**
+ * @brief Starts a sequence. It runs right away until it suspends for the first time
+ *
+ * @param sequence
+ * @return SequenceId ID to cancel it, 0 if the sequence was empty
+ */
+SequenceId Scheduler::start(Sequence sequence){
+    if(!sequence.handle) {
+        return 0;
+    }
+    int slot;
+    if(!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else {
+        slot = static_cast<int>(slots.size());
+        slots.emplace_back();
+    }
+    slots[slot].handle = sequence.handle;
+    sequence.handle = nullptr;
+    slots[slot].handle.promise().scheduler = this;
+    slots[slot].handle.promise().slot = slot;
+    activeCount++;
+
+    unsigned int generation = slots[slot].generation;
+    resume({slot, generation});
+    return (static_cast<SequenceId>(generation) << 32) | static_cast<Uint32>(slot);
+}
+
+/**
+ * @brief Cancels a sequence. Its frame is destroyed, so the objects of the coroutine are destroyed at the point
+ * where it was suspended. A sequence that cancels itself is destroyed when it suspends
+ *
+ * @param id
+ * @return int 0 on success, -1 if the sequence already ended
+ */
+int Scheduler::cancel(SequenceId id){
+    size_t slot = static_cast<Uint32>(id);
+    unsigned int generation = static_cast<unsigned int>(id >> 32);
+    if(slot >= slots.size() || !isValid({static_cast<int>(slot), generation})) {
+        return -1;
+    }
+    if(slots[slot].resuming) {
+        slots[slot].cancelled = true;
+        return 0;
+    }
+    release(static_cast<int>(slot));
+    return 0;
+}
+
+/**
+ * @brief Resumes the sequences that are due: the ones waiting for this update, the timers that expired in time
+ * order, and the ones whose condition became true. Timers that are not due are not touched
+ *
+ * @param milliseconds Time of the game clock, it never goes back
+ */
+void Scheduler::update(Uint32 milliseconds){
+    now = std::max(now, milliseconds);
+
+    // sequences that wait for another tick now go to the next update
+    resuming.swap(ticking);
+    for(const Waiter& waiter : resuming) {
+        if(isValid(waiter)) {
+            resume(waiter);
+        }
+    }
+    resuming.clear();
+
+    timers.update(now);
+
+    resuming.swap(polling);
+    for(const Waiter& waiter : resuming) {
+        if(!isValid(waiter)) {
+            continue;
+        }
+        bool ready = checkCondition(waiter.slot);
+        if(!isValid(waiter)) {
+            continue;
+        }
+        if(ready) {
+            resume(waiter);
+        }
+        else {
+            polling.push_back(waiter);
+        }
+    }
+    resuming.clear();
+}
+
+/**
+ * @brief Destroys every sequence that did not end
+ *
+ */
+void Scheduler::clear(){
+    for(size_t i = 0; i < slots.size(); i++) {
+        if(slots[i].handle) {
+            release(static_cast<int>(i));
+        }
+    }
+    ticking.clear();
+    polling.clear();
+    timers.clear();
+}
@@ -0,0 +1,270 @@
+/**
+ * @file sdlRenderBackend.cpp
+ * @author Iván Mansilla
+ * @brief Render backend on top of the SDL renderer.
+ * @version 0.1
+ * @date 2025-08-03
+ *
+ *
+ */
+
+#include "../inc/sdlRenderBackend.h"
+
+/**
+ * @brief Construct a new Sdl Render Backend object
+ *
+ * @param renderer SDL renderer to draw with
+ */
+SdlRenderBackend::SdlRenderBackend(SDL_Renderer* renderer){
+    this->renderer = renderer;
+}
+
+/**
+ * @brief Sets the draw color of the renderer. Rectangles overwrite the target, like clear
+ *
+ * @param color
+ */
+void SdlRenderBackend::setDrawColor(SDL_Color color){
+    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+}
+
+/**
+ * @brief Creates an empty texture
+ *
+ * @param width
+ * @param height
+ * @param target Whether it can be drawn into
+ * @param format Pixel format of the data that will be uploaded to it
+ * @return RenderTexture* nullptr on failure
+ */
+RenderTexture* SdlRenderBackend::createTexture(int width, int height, bool target, Uint32 format){
+    SDL_Texture* texture = SDL_CreateTexture(renderer, format, target ? SDL_TEXTUREACCESS_TARGET : SDL_TEXTUREACCESS_STATIC, width, height);
+    if(!texture) {
+        SDL_Log("ERROR: Could not create a %dx%d texture. %s\n", width, height, SDL_GetError());
+        return nullptr;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+    SdlTexture* result = new SdlTexture();
+    result->texture = texture;
+    result->width = width;
+    result->height = height;
+    result->format = format;
+    result->target = target;
+    return result;
+}
+
+/**
+ * @brief Creates a texture with the pixels of a surface
+ *
+ * @param surface
+ * @return RenderTexture* nullptr on failure
+ */
+RenderTexture* SdlRenderBackend::createTextureFromSurface(SDL_Surface* surface){
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    if(!texture) {
+        SDL_Log("ERROR: Could not create texture from surface. %s\n", SDL_GetError());
+        return nullptr;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+    SdlTexture* result = new SdlTexture();
+    result->texture = texture;
+    result->width = surface->w;
+    result->height = surface->h;
+    result->format = surface->format->format;
+    return result;
+}
+
+/**
+ * @brief Uploads pixels to a texture
+ *
+ * @param texture
+ * @param rect Area to update, nullptr for the whole texture
+ * @param pixels Pixels in the format of the texture
+ * @param pitch Bytes per row of pixels
+ * @return int 0 on success, -1 on failure
+ */
+int SdlRenderBackend::updateTexture(RenderTexture* texture, const SDL_Rect* rect, const void* pixels, int pitch){
+    if(SDL_UpdateTexture(static_cast<SdlTexture*>(texture)->texture, rect, pixels, pitch) != 0) {
+        SDL_Log("ERROR: Could not update texture. %s\n", SDL_GetError());
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Destroys a texture
+ *
+ * @param texture
+ */
+void SdlRenderBackend::destroyTexture(RenderTexture* texture){
+    if(!texture) {
+        return;
+    }
+    if(target == texture) {
+        setTarget(nullptr);
+    }
+    SDL_DestroyTexture(static_cast<SdlTexture*>(texture)->texture);
+    delete texture;
+}
+
+/**
+ * @brief Sets how a texture is blended when it is drawn
+ *
+ * @param texture
+ * @param blend
+ */
+void SdlRenderBackend::setTextureBlend(RenderTexture* texture, RenderBlend blend){
+    texture->blend = blend;
+    SDL_SetTextureBlendMode(static_cast<SdlTexture*>(texture)->texture, blend == RENDER_BLEND_ALPHA ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+}
+
+/**
+ * @brief Sets how a texture is sampled when it is drawn scaled
+ *
+ * @param texture
+ * @param filter
+ */
+void SdlRenderBackend::setTextureFilter(RenderTexture* texture, RenderFilter filter){
+    texture->filter = filter;
+    SDL_SetTextureScaleMode(static_cast<SdlTexture*>(texture)->texture, filter == RENDER_FILTER_LINEAR ? SDL_ScaleModeLinear : SDL_ScaleModeNearest);
+}
+
+/**
+ * @brief Checks if textures can be drawn into
+ *
+ * @return true
+ * @return false
+ */
+bool SdlRenderBackend::supportsTargets() const {
+    return SDL_RenderTargetSupported(renderer);
+}
+
+/**
+ * @brief Sets where the next draws go
+ *
+ * @param target Target texture, nullptr for the screen
+ * @return int 0 on success, -1 on failure
+ */
+int SdlRenderBackend::setTarget(RenderTexture* target){
+    SDL_Texture* texture = target ? static_cast<SdlTexture*>(target)->texture : nullptr;
+    if(SDL_SetRenderTarget(renderer, texture) != 0) {
+        SDL_Log("ERROR: Could not set the render target. %s\n", SDL_GetError());
+        return -1;
+    }
+    this->target = target;
+    return 0;
+}
+
+/**
+ * @brief Gets the current target
+ *
+ * @return RenderTexture* nullptr for the screen
+ */
+RenderTexture* SdlRenderBackend::getTarget() const {
+    return target;
+}
+
+/**
+ * @brief Sets the scale from logical units to pixels of the current target
+ *
+ * @param scaleX
+ * @param scaleY
+ */
+void SdlRenderBackend::setScale(float scaleX, float scaleY){
+    SDL_RenderSetScale(renderer, scaleX, scaleY);
+}
+
+/**
+ * @brief Gets the scale from logical units to pixels of the current target
+ *
+ * @param scaleX
+ * @param scaleY
+ */
+void SdlRenderBackend::getScale(float* scaleX, float* scaleY) const {
+    SDL_RenderGetScale(renderer, scaleX, scaleY);
+}
+
+/**
+ * @brief Restricts the draws to a rectangle
+ *
+ * @param clip Rectangle in logical units, nullptr to draw everywhere
+ */
+void SdlRenderBackend::setClip(const SDL_Rect* clip){
+    SDL_RenderSetClipRect(renderer, clip);
+}
+
+/**
+ * @brief Gets the clip rectangle
+ *
+ * @param clip
+ * @return true if clipping is enabled
+ * @return false
+ */
+bool SdlRenderBackend::getClip(SDL_Rect* clip) const {
+    SDL_RenderGetClipRect(renderer, clip);
+    return SDL_RenderIsClipEnabled(renderer);
+}
+
+/**
+ * @brief Fills the whole target with a color, ignoring the clip rectangle
+ *
+ * @param color
+ */
+void SdlRenderBackend::clear(SDL_Color color){
+    counters.fills++;
+    setDrawColor(color);
+    SDL_RenderClear(renderer);
+}
+
+/**
+ * @brief Fills a rectangle with a color, overwriting the target
+ *
+ * @param rect Rectangle in logical units, nullptr for the whole target
+ * @param color
+ */
+void SdlRenderBackend::fillRect(const SDL_Rect* rect, SDL_Color color){
+    counters.fills++;
+    setDrawColor(color);
+    SDL_RenderFillRect(renderer, rect);
+}
+
+/**
+ * @brief Draws a texture
+ *
+ * @param texture
+ * @param src Area of the texture, nullptr for all of it
+ * @param dst Area of the target in logical units, nullptr for all of it
+ */
+void SdlRenderBackend::copy(RenderTexture* texture, const SDL_Rect* src, const SDL_Rect* dst){
+    countDraw(texture);
+    SDL_RenderCopy(renderer, static_cast<SdlTexture*>(texture)->texture, src, dst);
+}
+
+/**
+ * @brief Draws a texture tinted, faded, mirrored or rotated. The modulation is only set for this draw, textures are shared
+ *
+ * @param texture
+ * @param src Area of the texture, nullptr for all of it
+ * @param dst Area of the target in logical units, nullptr for all of it
+ * @param state
+ */
+void SdlRenderBackend::copyEx(RenderTexture* texture, const SDL_Rect* src, const SDL_Rect* dst, const RenderState& state){
+    countDraw(texture);
+    SDL_Texture* sdlTexture = static_cast<SdlTexture*>(texture)->texture;
+    SDL_SetTextureColorMod(sdlTexture, state.tint.r, state.tint.g, state.tint.b);
+    SDL_SetTextureAlphaMod(sdlTexture, state.tint.a);
+    SDL_RenderCopyEx(renderer, sdlTexture, src, dst, state.angle, NULL, static_cast<SDL_RendererFlip>(state.flip));
+    SDL_SetTextureColorMod(sdlTexture, 255, 255, 255);
+    SDL_SetTextureAlphaMod(sdlTexture, 255);
+}
+
+/**
+ * @brief Shows the frame drawn on the screen
+ *
+ */
+void SdlRenderBackend::present(){
+    SDL_RenderPresent(renderer);
+}
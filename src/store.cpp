@@ -1,13 +1,12 @@
 #include "../inc/store.h"
+#include "../inc/frameArena.h"
+#include "../inc/metrics.h"
+#include <algorithm>
 
 /**
  * @brief Construct a new Item object
  * 
  * @param id 
- * @param x 
- * @param y 
- * @param width 
- * @param height 
  * @param textureId 
  * @param cost 
  * @param description 
@@ -17,36 +16,217 @@
  * @param player 
  */
 Item::Item(std::string id, std::string textureId, int cost, std::string description, std::function<void(Player*)> onPurchase, float prob, Store* store, Player* player)
-: Object(id, 380, 140, 90, 90, textureId), cost(cost), description(description), onPurchase(onPurchase), prob(prob), playerPtr(player), store(store) {
+: id(id), textureId(textureId), playerPtr(player), store(store), cost(cost), description(description), onPurchase(onPurchase), prob(prob) {
 
     level=1;
     store->addItem(this);
-    store->objManager->makeClickable(this->id);
 }
 
 /**
- * @brief Executes the item action when clicked. 1st checks if the player has enough points, then calls the onPurchase function. Then increases the cost and level of the item, and randomizes available items in the store.
+ * @brief Construct a new Item object whose purchase adds a modifier to a stat of the player
  * 
+ * @param id 
+ * @param textureId 
+ * @param cost 
+ * @param description 
+ * @param effect Modifier added on every purchase
+ * @param prob 
+ * @param store 
+ * @param player 
+ */
+Item::Item(std::string id, std::string textureId, int cost, std::string description, ItemEffect effect, float prob, Store* store, Player* player)
+: Item(id, textureId, cost, description, std::function<void(Player*)>(), prob, store, player) {
+    effects.push_back(effect);
+}
+
+/**
+ * @brief Sequence that removes a modifier of a timed effect when it runs out
+ *
+ * @param player
+ * @param modifier ID of the modifier
+ * @param duration Milliseconds of game time
+ * @return Sequence
  */
-void Item::onClick() {
-    height = height - 10;
-    width = width - 10;
+static Sequence expireModifier(Player* player, int modifier, Uint32 duration){
+    co_await delay(duration);
+    player->modifiers.removeModifier(modifier);
+}
 
+/**
+ * @brief Buys the item. 1st checks if the player has enough points, then adds the effects of the item and calls the onPurchase function. Then increases the cost and level of the item, and randomizes available items in the store.
+ * 
+ * @return true if the item was bought
+ * @return false if there is no player, the player cannot afford it or it does nothing
+ */
+bool Item::purchase() {
+    if(!playerPtr) {
+        return false;
+    }
     if(playerPtr->getPoints() < cost) {
         SDL_Log("Not enough points to purchase item '%s' (%d)", id.c_str(), cost);
-        return;
+        return false;
     }
-    if(onPurchase && playerPtr) {
-        onPurchase(playerPtr);
-        cost = static_cast<int>(cost * pow(cost, level/2.0));
+    if(onPurchase || !effects.empty()) {
+        for(const ItemEffect& effect : effects) {
+            int stat = playerPtr->modifiers.findStat(effect.stat);
+            int modifier = playerPtr->modifiers.addModifier(stat, effect.type, effect.amount, id, effect.priority);
+            // an unknown stat got no modifier, there is nothing to expire
+            if(modifier >= 0 && effect.duration > 0 && store->scheduler) {
+                store->scheduler->start(expireModifier(playerPtr, modifier, effect.duration));
+            }
+        }
+        if(onPurchase) {
+            onPurchase(playerPtr);
+        }
+        cost = nextCost();
         level++;
+        gameMetrics.purchases.add();
         store->randomizeAvailableItems();
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Cost of the item after buying it at its current level: cost * pow(cost, level * costGrowth), at most ITEM_MAX_COST
+ * 
+ * @return int 
+ */
+int Item::nextCost() const {
+    double next = cost * pow(static_cast<double>(cost), level * costGrowth);
+    if(next > ITEM_MAX_COST) {
+        return ITEM_MAX_COST;
     }
+    return static_cast<int>(next);
 }
 
-void Item::onRelease() {
-    height = height + 10;
-    width = width + 10;
+/**
+ * @brief Construct a new Store Row object, a hidden clickable child of the store
+ * 
+ * @param id 
+ * @param store 
+ */
+StoreRow::StoreRow(const std::string& id, Store* store)
+: Object(id, STORE_LIST_X, STORE_LIST_Y, STORE_ROW_SIZE, STORE_ROW_SIZE, ""), store(store) {
+    store->objManager->addObject(this);
+    store->objManager->attachChild(store->id, this->id);
+    store->objManager->makeClickable(this->id);
+}
+
+/**
+ * @brief Shows an item in the row
+ * 
+ * @param item nullptr when the row is hidden
+ */
+void StoreRow::bind(Item* item) {
+    if(this->item == item) {
+        return;
+    }
+    this->item = item;
+    if(item) {
+        textureId = item->textureId;
+        markDirty();
+    }
+    if(store->hoveredRow == this) {
+        store->hoveredItem = item;
+    }
+}
+
+/**
+ * @brief Shows the item as affordable or not. A disabled item is drawn with a darkening tint and some transparency, with the same texture
+ * 
+ * @param disabled 
+ */
+void StoreRow::setDisabled(bool disabled) {
+    if(this->disabled == disabled) {
+        return;
+    }
+    this->disabled = disabled;
+    RenderState state = renderState;
+    if(disabled) {
+        state.tint = {ITEM_DISABLED_SHADE, ITEM_DISABLED_SHADE, ITEM_DISABLED_SHADE, ITEM_DISABLED_ALPHA};
+    }
+    else {
+        state.tint = {255, 255, 255, 255};
+    }
+    setRenderState(state);
+}
+
+/**
+ * @brief Buys the item of the row
+ * 
+ */
+void StoreRow::onClick() {
+    resize(width - 10, height - 10);
+    if(item) {
+        item->purchase();
+    }
+}
+
+void StoreRow::onRelease() {
+    resize(width + 10, height + 10);
+}
+
+/**
+ * @brief Marks the item as the hovered one of the store, so its tooltip is shown
+ * 
+ */
+void StoreRow::onMouseOver() {
+    store->hoveredRow = this;
+    store->hoveredItem = item;
+}
+
+/**
+ * @brief Hides the tooltip of the item if it is the one shown
+ * 
+ */
+void StoreRow::onMouseOut() {
+    if(store->hoveredRow == this) {
+        store->hoveredRow = nullptr;
+        store->hoveredItem = nullptr;
+    }
+}
+
+/**
+ * @brief Construct a new Store object and the pool of rows of its list
+ * 
+ * @param x 
+ * @param y 
+ * @param width 
+ * @param height 
+ * @param textureId 
+ * @param objManager 
+ */
+Store::Store(float x, float y, float width, float height, std::string textureId, ObjectManager* objManager)
+: Object("Store", x, y, width, height, textureId), objManager(objManager) {
+    objManager->addObject(this);
+    for(int i = 0; i < STORE_ROW_POOL; i++) {
+        rows.push_back(new StoreRow(getRowId(i), this));
+    }
+}
+
+/**
+ * @brief Destroy the Store object and the rows of its list, if the object manager did not destroy them already
+ * 
+ */
+Store::~Store() {
+    // the rows are looked up by ID: after destroyAllObjects() the pointers may be dangling
+    for(size_t i = 0; i < rows.size(); i++) {
+        std::string rowId = getRowId(static_cast<int>(i));
+        if(objManager->getObjectById(rowId) == rows[i]) {
+            objManager->destroyObject(rowId);
+        }
+    }
+}
+
+/**
+ * @brief ID of a row of the pool
+ * 
+ * @param index 
+ * @return std::string 
+ */
+std::string Store::getRowId(int index) const {
+    return id + ".row" + std::to_string(index);
 }
 
 /**
@@ -60,8 +240,7 @@ void Store::addItem(Item* item) {
         return;
     }
     items[item->id] = item;
-
-    objManager->addObject(item);
+    catalog.push_back(item);
     SDL_Log("Item with ID %s added to the store.\n", item->id.c_str());
 }
 
@@ -76,6 +255,11 @@ void Store::removeItem(const std::string& id) {
         SDL_Log("ERROR: Item with ID %s does not exist in the store.\n", id.c_str());
         return;
     }
+    Item* item = i->second;
+    if(item->available) {
+        makeItemUnavailable(id);
+    }
+    catalog.erase(std::find(catalog.begin(), catalog.end(), item));
     items.erase(i);
 }
 
@@ -95,10 +279,9 @@ Item* Store::getItemById(const std::string& id) {
 }
 
 /**
- * @brief Makes an item available in the store by its ID and activates it in the ObjectManager.
+ * @brief Makes an item available in the store by its ID, at the end of the list. Its row is shown by the next updateScroll().
  * 
  * @param id 
- * @param objManager 
  */
 void Store::makeItemAvailable(const std::string& id){
     Item* item = getItemById(id);
@@ -106,16 +289,20 @@ void Store::makeItemAvailable(const std::string& id){
         SDL_Log("ERROR: Cannot make item with ID %s available, it does not exist.\n", id.c_str());
         return;
     }
+    if(item->available) {
+        SDL_Log("Item with ID %s is already available\n", id.c_str());
+        return;
+    }
 
+    item->available = true;
     availableItems.push_back(item);
-    objManager->activateObject(id);
+    rowsDirty = true;
 }
 
 /**
- * @brief Makes an item unavailable in the store by its ID and deactivates it in the ObjectManager.
+ * @brief Makes an item unavailable in the store by its ID. Its row is hidden by the next updateScroll().
  * 
  * @param id 
- * @param objManager 
  */
 void Store::makeItemUnavailable(const std::string& id) {
     Item* item = getItemById(id);
@@ -124,12 +311,11 @@ void Store::makeItemUnavailable(const std::string& id) {
         return;
     }
 
-    if (item->isActive) {
-        objManager->deactivateObject(id);
-        availableItems.erase(
-            std::remove(availableItems.begin(), availableItems.end(), item),
-            availableItems.end()
-        );
+    auto available = std::find(availableItems.begin(), availableItems.end(), item);
+    if (available != availableItems.end()) {
+        item->available = false;
+        availableItems.erase(available);
+        rowsDirty = true;
     }
     else {
         SDL_Log("Item with ID %s is already unavailable\n", id.c_str());
@@ -137,53 +323,163 @@ void Store::makeItemUnavailable(const std::string& id) {
 }
 
 /**
- * @brief Randomizes the available items in the store based on their probability.
+ * @brief Seeds the random generator of the store. The same seed and the same input give the same store.
+ * 
+ * @param seed 
+ */
+void Store::setSeed(unsigned int seed) {
+    rng.seed(seed);
+}
+
+/**
+ * @brief Randomizes the available items in the store based on their probability, up to offerCount of them. With an offerCount of 0 every unlocked item is listed, in catalog order. Locked items are never offered.
  * 
  */
 void Store::randomizeAvailableItems() {
     
+    // this runs inside the click of a row, the rows are bound to the new items by the next updateScroll()
     for (auto& item : availableItems){
-        makeItemUnavailable(item->id);
+        item->available = false;
     }
     availableItems.clear();
+    rowsDirty = true;
 
-    std::vector<std::pair<Item*, float>> candidates;
-
-    for (auto& pair : items) {
-        Item* item = pair.second;
-        float randomValue = static_cast<float>(rand()) / RAND_MAX;
-        if (item->prob > randomValue) {
-            candidates.push_back({item,randomValue});
+    if(offerCount <= 0) {
+        for(Item* item : catalog) {
+            if(item->unlocked) {
+                item->available = true;
+                availableItems.push_back(item);
+            }
         }
     }
+    else {
+        // transient list, taken from the frame arena
+        std::pmr::vector<std::pair<Item*, float>> candidates(&frameArena());
 
-    std::random_shuffle(candidates.begin(), candidates.end());
+        for (auto& pair : items) {
+            Item* item = pair.second;
+            // built from the raw generator output, the std distributions differ between standard libraries
+            float randomValue = static_cast<float>(rng() >> 8) / (1 << 24);
+            if (item->unlocked && item->prob > randomValue) {
+                candidates.push_back({item,randomValue});
+            }
+        }
+
+        for(size_t i = candidates.size(); i > 1; i--){
+            std::swap(candidates[i - 1], candidates[rng() % i]);
+        }
 
-    for(int i = 0; i < 3; i++){
-        candidates[i].first->y = 140 + i*80;
-        makeItemAvailable(candidates[i].first->id);
+        for(size_t i = 0; i < candidates.size() && i < static_cast<size_t>(offerCount); i++){
+            makeItemAvailable(candidates[i].first->id);
+        }
     }
 
+    gameMetrics.storeRefreshes.add();
     SDL_Log("Randomized available items in the store. %d items available.\n", static_cast<int>(availableItems.size()));
 }
 
 /**
- * @brief Updates the store based on the player's points. If the player has less points than the item's cost, it adds "_disabled" to the texture ID.
+ * @brief Updates the store based on the player's points. If the player has less points than the item's cost, the item is drawn disabled. Only the rows in view are checked.
  * 
  * @param player 
  */
 void Store::updateStore(Player* player){
-    for (auto& item : availableItems){
-        if (player->getPoints() < item->cost){
-            if(item->textureId.find("_disabled") == std::string::npos) {
-                item->textureId = item->textureId + "_disabled";
-            }
+    for (StoreRow* row : rows){
+        if(row->item) {
+            row->setDisabled(player->getPoints() < row->item->cost);
         }
-        else {
-            size_t pos = item->textureId.find("_disabled");
-            if(pos != std::string::npos) {
-                item->textureId = item->textureId.substr(0, pos);
+    }
+}
+
+/**
+ * @brief Scrolls the list. The list keeps gliding and slows down over the next frames, the whole movement adds up to the pixels given
+ * 
+ * @param pixels Positive to scroll down
+ */
+void Store::scroll(float pixels) {
+    // the speed decays geometrically, so the frames add up to speed / (1 - friction)
+    scrollSpeed += pixels * (1.0f - STORE_SCROLL_FRICTION);
+}
+
+/**
+ * @brief Advances the scrolling one frame and binds the rows to the items in view. Call it once per frame, outside the callbacks of the objects (it shows and hides rows)
+ * 
+ */
+void Store::updateScroll() {
+    float offset = scrollOffset + scrollSpeed;
+    scrollSpeed *= STORE_SCROLL_FRICTION;
+    if(std::fabs(scrollSpeed) < STORE_SCROLL_MIN_SPEED) {
+        scrollSpeed = 0.0f;
+    }
+
+    float maxScroll = getMaxScroll();
+    if(offset < 0.0f || offset > maxScroll) {
+        offset = std::max(0.0f, std::min(offset, maxScroll));
+        scrollSpeed = 0.0f;
+    }
+    if(offset != scrollOffset) {
+        scrollOffset = offset;
+        rowsDirty = true;
+    }
+
+    if(rowsDirty) {
+        layoutRows();
+    }
+}
+
+/**
+ * @brief Area of the screen the list is shown in, the rows are clipped to it
+ * 
+ * @return SDL_Rect 
+ */
+SDL_Rect Store::getListRect() const {
+    return {static_cast<int>(worldX), static_cast<int>(worldY) + STORE_LIST_Y, static_cast<int>(width), STORE_LIST_HEIGHT};
+}
+
+/**
+ * @brief How far the list can be scrolled down
+ * 
+ * @return float 
+ */
+float Store::getMaxScroll() const {
+    float listHeight = static_cast<float>(availableItems.size()) * STORE_ROW_HEIGHT;
+    return std::max(0.0f, listHeight - STORE_LIST_HEIGHT);
+}
+
+/**
+ * @brief Binds the pool of rows to the items in view. Item i is always shown by row i % STORE_ROW_POOL, so while
+ * scrolling only the row that leaves at one end is bound again, to the item entering at the other
+ */
+void Store::layoutRows() {
+    rowsDirty = false;
+    SDL_Rect clip = getListRect();
+    int count = static_cast<int>(availableItems.size());
+    int pool = static_cast<int>(rows.size());
+    float offset = std::floor(scrollOffset);
+    int first = static_cast<int>(offset) / STORE_ROW_HEIGHT;
+
+    for(int i = first; i < first + pool; i++) {
+        StoreRow* row = rows[i % pool];
+        if(i >= count) {
+            row->bind(nullptr);
+            if(row->isActive) {
+                objManager->deactivateObject(row->id);
             }
+            continue;
+        }
+
+        row->bind(availableItems[i]);
+        float y = STORE_LIST_Y + i * STORE_ROW_HEIGHT - offset;
+        if(row->y != y) {
+            row->setPosition(STORE_LIST_X, y);
+        }
+        if(clip.x != row->clipRect.x || clip.y != row->clipRect.y || clip.w != row->clipRect.w || clip.h != row->clipRect.h) {
+            row->clipRect = clip;
+            // the clip cuts its subtree bounds
+            row->markTransformDirty();
+        }
+        if(!row->isActive) {
+            objManager->activateObject(row->id);
         }
     }
-}
\ No newline at end of file
+}
@@ -2,28 +2,43 @@
 
 const char* DEFAULT_FONT = "BitPap24";
 
-Text::Text(std::string id, float x, float y, float width, float height, std::string content, TTF_Font** font, SDL_Color color, ObjectManager* objManager) : Object(id, x, y, width, height, "__text__", false) {
+Text::Text(std::string id, float x, float y, float width, float height, std::string content, TTF_Font** font, SDL_Color color, ObjectManager* objManager) : Object(id, x, y, width, height, "", false) {
+    this->kind = OBJECT_TEXT;
     this->content = content;
     this->font = font;
     this->color = color;
     this->objManager = objManager;
     objManager->addObject(this);
-    objManager->textObjects.push_back(this);
 }
 
 /**
  * @brief Sets the content of the text object and updates its texture. Textures of text objects are managed by themselves rather than the texture manager.
  * 
  * @param newContent The new content to set.
- * @param renderer The SDL renderer to create the texture.
+ * @param backend The render backend to create the texture.
  */
- void Text::setContent(const std::string& newContent, SDL_Renderer* renderer){
-    content = newContent;
+ void Text::setContent(const std::string& newContent, RenderBackend* backend){
+    setContent(newContent.c_str(), newContent.size(), backend);
+ }
+
+/**
+ * @brief Sets the content of the text object from a character buffer. The content string reuses its storage, so no heap allocation happens once it is big enough.
+ * 
+ * @param newContent Characters of the new content.
+ * @param length Number of characters.
+ * @param backend The render backend to create the texture.
+ */
+ void Text::setContent(const char* newContent, size_t length, RenderBackend* backend){
+    // Nothing to re-render if the text did not change
+    if((wrapWidth > 0 ? layout != nullptr : texture != nullptr) && content.compare(0, std::string::npos, newContent, length) == 0) {
+        return;
+    }
+    content.assign(newContent, length);
+    markDirty();
 
-    // Free the existing texture if it exists
-    if(texture) {
-        SDL_DestroyTexture(texture);
-        texture = nullptr;
+    if(wrapWidth > 0) {
+        setLayout(backend);
+        return;
     }
 
     // Create a surface with the text content
@@ -33,26 +48,95 @@ Text::Text(std::string id, float x, float y, float width, float height, std::str
         return;
     }
 
-    // Create a texture
-    texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if(!texture) {
-        SDL_Log("ERROR: Could not create texture for text '%s'. %s\n", id.c_str(), SDL_GetError());
-        SDL_FreeSurface(surface);
-        return;
+    // Create a new texture only if the text does not fit in the current one. It is made a bit wider than needed so growing numbers keep reusing it
+    if(!texture || surface->w > textureWidth || surface->h > textureHeight) {
+        if(texture) {
+            backend->destroyTexture(texture);
+        }
+        textureWidth = surface->w + surface->w / 2;
+        textureHeight = surface->h;
+        texture = backend->createTexture(textureWidth, textureHeight, false);
+        if(!texture) {
+            SDL_Log("ERROR: Could not create texture for text '%s'.\n", id.c_str());
+            SDL_FreeSurface(surface);
+            return;
+        }
     }
 
-    // Set the width and height of the text object based on the surface
-    width = surface->w;
-    height = surface->h;
+    // Blended text surfaces are ARGB8888, like the texture
+    SDL_Rect area = {0, 0, surface->w, surface->h};
+    backend->updateTexture(texture, &area, surface->pixels, surface->pitch);
+
+    // The object takes the size of the surface, its transforms and subtree bounds follow
+    resize(static_cast<float>(surface->w), static_cast<float>(surface->h));
     SDL_FreeSurface(surface);
  }
 
+/**
+ * @brief Wraps the text to a box width. The box keeps that width and its height follows the lines of the text
+ * 
+ * @param width Box width in pixels, 0 to go back to a single line sized to the text
+ * @param align Alignment of the lines inside the box
+ */
+ void Text::setWrap(int width, TextAlign align){
+    wrapWidth = width;
+    this->align = align;
+    layout.reset();
+    markDirty();
+ }
+
+/**
+ * @brief Shows the cached layout of the content, laying it out and rendering it only the first time the content is seen
+ * 
+ * @param backend The render backend to create the texture.
+ */
+ void Text::setLayout(RenderBackend* backend){
+    layout = textLayoutCache().getLayout(content, *font, wrapWidth, align);
+    if(!layout) {
+        return;
+    }
+    layout->render(backend, color);
+    resize(static_cast<float>(wrapWidth), static_cast<float>(layout->height));
+ }
+
+/**
+ * @brief Sets the content to a label followed by a formatted number (e.g. "Points: 1.5K"). The label is formatted into a stack buffer, without heap allocations.
+ * 
+ * @param prefix Text before the number.
+ * @param value Number to show.
+ * @param format How to write the number.
+ * @param backend The render backend to create the texture.
+ */
+ void Text::setNumber(const char* prefix, long long value, const NumberFormat& format, RenderBackend* backend){
+    char buffer[NUMBER_BUFFER_SIZE + 64];
+    size_t length = formatLabel(buffer, sizeof(buffer), prefix, value, format);
+    setContent(buffer, length, backend);
+ }
+
  /**
   * @brief Draw the text on the renderer
   * 
-  * @param renderer 
+  * @param backend 
   */
- void Text::drawText(SDL_Renderer** renderer) {
+ void Text::drawText(RenderBackend* backend) {
+    if(layout) {
+        if(isActive && layout->texture) {
+            // lines are aligned inside the layout, the layout is aligned inside the box
+            SDL_Rect dstRect = getRect();
+            int offset = dstRect.w - layout->width;
+            if(align == TEXT_ALIGN_CENTER) {
+                dstRect.x += offset / 2;
+            }
+            else if(align == TEXT_ALIGN_RIGHT) {
+                dstRect.x += offset;
+            }
+            dstRect.w = layout->width;
+            dstRect.h = layout->height;
+            drawTexture(backend, layout->texture, nullptr, &dstRect);
+        }
+        return;
+    }
+
     if(!texture) {
         SDL_Log("ERROR: Texture for text '%s' is not set.\n", id.c_str());
         return;
@@ -62,6 +146,24 @@ Text::Text(std::string id, float x, float y, float width, float height, std::str
         return;
     }
 
-    SDL_Rect dstRect = { static_cast<int>(x), static_cast<int>(y), static_cast<int>(width), static_cast<int>(height) };
-    SDL_RenderCopy(*renderer, texture, nullptr, &dstRect);
+    SDL_Rect dstRect = getRect();
+    SDL_Rect srcRect = {0, 0, dstRect.w, dstRect.h}; // the texture may be bigger than the text
+    drawTexture(backend, texture, &srcRect, &dstRect);
+ }
+
+ /**
+  * @brief Copies a texture of the text with the render state of the text
+  * 
+  * @param backend 
+  * @param texture 
+  * @param src 
+  * @param dst 
+  */
+ void Text::drawTexture(RenderBackend* backend, RenderTexture* texture, const SDL_Rect* src, const SDL_Rect* dst) {
+    if(renderState.isDefault()) {
+        backend->copy(texture, src, dst);
+    }
+    else {
+        backend->copyEx(texture, src, dst, renderState);
+    }
  }
\ No newline at end of file
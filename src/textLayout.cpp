@@ -0,0 +1,324 @@
+/**
+ * @file textLayout.cpp
+ * @author Iván Mansilla
+ * @brief Multi-line text layout and its LRU cache.
+ * @version 0.1
+ * @date 2025-08-02
+ *
+ *
+ */
+
+#include "../inc/textLayout.h"
+#include <algorithm>
+
+/**
+ * @brief Checks if a byte starts a UTF-8 character (it is not a continuation byte)
+ *
+ * @param c
+ * @return true
+ * @return false
+ */
+static bool isCharStart(char c){
+    return (static_cast<unsigned char>(c) & 0xC0) != 0x80;
+}
+
+/**
+ * @brief Measures the width of a range of a text
+ *
+ * @param font
+ * @param text
+ * @param start
+ * @param length
+ * @param scratch Buffer for the range, reused between calls
+ * @return int Width in pixels, 0 if it could not be measured
+ */
+static int measureRange(TTF_Font* font, const std::string& text, size_t start, size_t length, std::string& scratch){
+    if(length == 0) {
+        return 0;
+    }
+    scratch.assign(text, start, length);
+    int w = 0;
+    int h = 0;
+    if(TTF_SizeUTF8(font, scratch.c_str(), &w, &h) != 0) {
+        return 0;
+    }
+    return w;
+}
+
+/**
+ * @brief Destroy the Text Layout object and its texture
+ *
+ */
+TextLayout::~TextLayout(){
+    if(texture) {
+        backend->destroyTexture(texture);
+    }
+}
+
+/**
+ * @brief Breaks a text into lines no wider than maxWidth. Lines break at spaces and at '\n'; words wider than the box are split between characters
+ *
+ * @param text
+ * @param font
+ * @param maxWidth Box width in pixels, 0 to only break at '\n'
+ * @param align
+ * @return int 0 on success, -1 if there is no font
+ */
+int TextLayout::build(const std::string& text, TTF_Font* font, int maxWidth, TextAlign align){
+    this->text = text;
+    this->font = font;
+    this->maxWidth = maxWidth;
+    this->align = align;
+    lines.clear();
+    width = 0;
+    height = 0;
+
+    if(!font) {
+        SDL_Log("ERROR: Could not lay out text '%s' without a font\n", text.c_str());
+        return -1;
+    }
+    lineHeight = TTF_FontLineSkip(font);
+
+    std::string scratch;
+    size_t paragraphStart = 0;
+    while(paragraphStart <= text.size()) {
+        size_t paragraphEnd = text.find('\n', paragraphStart);
+        if(paragraphEnd == std::string::npos) {
+            paragraphEnd = text.size();
+        }
+
+        // greedy wrapping: a word goes to the current line if the line still fits with it
+        TextLine line = {paragraphStart, 0, 0};
+        size_t pos = paragraphStart;
+        while(pos < paragraphEnd) {
+            size_t wordStart = pos;
+            while(wordStart < paragraphEnd && text[wordStart] == ' ') {
+                wordStart++;
+            }
+            if(wordStart == paragraphEnd) {
+                break;
+            }
+            size_t wordEnd = text.find(' ', wordStart);
+            if(wordEnd == std::string::npos || wordEnd > paragraphEnd) {
+                wordEnd = paragraphEnd;
+            }
+
+            int lineWidth = measureRange(font, text, line.start, wordEnd - line.start, scratch);
+            if(maxWidth <= 0 || lineWidth <= maxWidth) {
+                line.length = wordEnd - line.start;
+                line.width = lineWidth;
+                pos = wordEnd;
+                continue;
+            }
+
+            if(line.length > 0) {
+                // the word goes to the next line
+                lines.push_back(line);
+                line = {wordStart, 0, 0};
+                pos = wordStart;
+                continue;
+            }
+
+            // the word alone does not fit, it is split at the last character that fits (at least one)
+            size_t split = wordStart + 1;
+            while(split < wordEnd && !isCharStart(text[split])) {
+                split++;
+            }
+            line.start = wordStart;
+            line.width = measureRange(font, text, wordStart, split - wordStart, scratch);
+            while(split < wordEnd) {
+                size_t next = split + 1;
+                while(next < wordEnd && !isCharStart(text[next])) {
+                    next++;
+                }
+                int nextWidth = measureRange(font, text, wordStart, next - wordStart, scratch);
+                if(nextWidth > maxWidth) {
+                    break;
+                }
+                line.width = nextWidth;
+                split = next;
+            }
+            line.length = split - wordStart;
+            lines.push_back(line);
+            line = {split, 0, 0};
+            pos = split;
+        }
+        lines.push_back(line);
+
+        paragraphStart = paragraphEnd + 1;
+    }
+
+    for(const TextLine& l : lines) {
+        width = std::max(width, l.width);
+    }
+    height = static_cast<int>(lines.size()) * lineHeight;
+    return 0;
+}
+
+/**
+ * @brief Renders the layout to a texture, once. Later calls with the same color return the same texture
+ *
+ * @param backend
+ * @param color
+ * @return RenderTexture* nullptr if it could not be rendered
+ */
+RenderTexture* TextLayout::render(RenderBackend* backend, SDL_Color color){
+    if(texture) {
+        if(textureColor.r == color.r && textureColor.g == color.g && textureColor.b == color.b && textureColor.a == color.a) {
+            return texture;
+        }
+        this->backend->destroyTexture(texture);
+        texture = nullptr;
+    }
+    if(width <= 0 || height <= 0) {
+        return nullptr;
+    }
+
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+    if(!surface) {
+        SDL_Log("ERROR: Could not create surface for text layout. %s\n", SDL_GetError());
+        return nullptr;
+    }
+
+    std::string scratch;
+    for(size_t i = 0; i < lines.size(); i++) {
+        const TextLine& line = lines[i];
+        if(line.length == 0) {
+            continue;
+        }
+        scratch.assign(text, line.start, line.length);
+        SDL_Surface* lineSurface = TTF_RenderUTF8_Blended(font, scratch.c_str(), color);
+        if(!lineSurface) {
+            SDL_Log("ERROR: Could not render text line '%s'. %s\n", scratch.c_str(), TTF_GetError());
+            continue;
+        }
+
+        SDL_Rect dst = {0, static_cast<int>(i) * lineHeight, lineSurface->w, lineSurface->h};
+        if(align == TEXT_ALIGN_CENTER) {
+            dst.x = (width - line.width) / 2;
+        }
+        else if(align == TEXT_ALIGN_RIGHT) {
+            dst.x = width - line.width;
+        }
+        // copy the pixels with their alpha instead of blending them over the empty surface
+        SDL_SetSurfaceBlendMode(lineSurface, SDL_BLENDMODE_NONE);
+        SDL_BlitSurface(lineSurface, nullptr, surface, &dst);
+        SDL_FreeSurface(lineSurface);
+    }
+
+    texture = backend->createTextureFromSurface(surface);
+    SDL_FreeSurface(surface);
+    if(!texture) {
+        SDL_Log("ERROR: Could not create texture for text layout.\n");
+        return nullptr;
+    }
+    this->backend = backend;
+    textureColor = color;
+    return texture;
+}
+
+/**
+ * @brief Hash of a key, the hash of the text combined with the other fields
+ *
+ * @param key
+ * @return size_t
+ */
+size_t TextLayoutCache::KeyHash::operator()(const Key& key) const {
+    size_t hash = std::hash<std::string>()(key.text);
+    hash ^= std::hash<const void*>()(key.font) + 0x9E3779B9u + (hash << 6) + (hash >> 2);
+    hash ^= static_cast<size_t>(key.maxWidth) * 31 + static_cast<size_t>(key.align) + 0x9E3779B9u + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+/**
+ * @brief Construct a new Text Layout Cache object
+ *
+ * @param capacity Maximum number of cached layouts
+ */
+TextLayoutCache::TextLayoutCache(size_t capacity) : capacity(capacity > 0 ? capacity : 1) {
+    entries.reserve(this->capacity);
+}
+
+/**
+ * @brief Gets the layout of a text, building it only if it is not cached
+ *
+ * @param text
+ * @param font
+ * @param maxWidth Box width in pixels, 0 to only break at '\n'
+ * @param align
+ * @return std::shared_ptr<TextLayout> nullptr if the text could not be laid out
+ */
+std::shared_ptr<TextLayout> TextLayoutCache::getLayout(const std::string& text, TTF_Font* font, int maxWidth, TextAlign align){
+    Key key = {text, font, maxWidth, align};
+    auto it = entries.find(key);
+    if(it != entries.end()) {
+        stats.hits++;
+        lru.splice(lru.begin(), lru, it->second.lruPosition);
+        return it->second.layout;
+    }
+
+    stats.misses++;
+    auto layout = std::make_shared<TextLayout>();
+    if(layout->build(text, font, maxWidth, align) != 0) {
+        return nullptr;
+    }
+
+    if(entries.size() >= capacity) {
+        entries.erase(*lru.back());
+        lru.pop_back();
+        stats.evictions++;
+    }
+    auto inserted = entries.emplace(std::move(key), Entry{layout, {}}).first;
+    lru.push_front(&inserted->first);
+    inserted->second.lruPosition = lru.begin();
+    return layout;
+}
+
+/**
+ * @brief Measures a text wrapped to a box width, without rendering it. The layout is cached for when the text is drawn
+ *
+ * @param text
+ * @param font
+ * @param maxWidth Box width in pixels, 0 to only break at '\n'
+ * @param width Width of the widest line
+ * @param height Height of all the lines
+ * @return int 0 on success, -1 if the text could not be laid out
+ */
+int TextLayoutCache::measure(const std::string& text, TTF_Font* font, int maxWidth, int* width, int* height){
+    std::shared_ptr<TextLayout> layout = getLayout(text, font, maxWidth);
+    if(!layout) {
+        return -1;
+    }
+    *width = layout->width;
+    *height = layout->height;
+    return 0;
+}
+
+/**
+ * @brief Drops all the cached layouts. Call it before closing the fonts or destroying the renderer
+ *
+ */
+void TextLayoutCache::clear(){
+    entries.clear();
+    lru.clear();
+}
+
+/**
+ * @brief Logs the counters of the cache
+ *
+ */
+void TextLayoutCache::logStats() const {
+    unsigned long long requests = stats.hits + stats.misses;
+    SDL_Log("Text layout cache: %llu requests, %llu hits (%.1f%%), %llu layouts built, %llu evictions, %zu cached\n",
+        requests, stats.hits, requests ? 100.0 * stats.hits / requests : 0.0, stats.misses, stats.evictions, entries.size());
+}
+
+/**
+ * @brief Gets the layout cache shared by all the texts
+ *
+ * @return TextLayoutCache&
+ */
+TextLayoutCache& textLayoutCache(){
+    static TextLayoutCache cache;
+    return cache;
+}
@@ -12,23 +12,52 @@
 
 const char* TEXTURE_PATH = "assets/textures/"; /*!< Path to the textures directory */
 const char* FONT_PATH = "assets/"; /*!< Path to the fonts directory */
+const char* ASSET_ARCHIVE_PATH = "assets/assets.pak"; /*!< Path to the packed asset archive */
 
 /**
- * @brief Adds a texture already loaded to the texture map
+ * @brief Adds a texture already loaded to the texture map. These textures have no file to reload them from, so they are never evicted
  * 
  * @param id 
  * @param texture 
  * @return int 
  */
-int TextureManager::addTexture(const std::string& id, SDL_Texture* texture){
+int TextureManager::addTexture(const std::string& id, RenderTexture* texture){
     if(textureMap.find(id) != textureMap.end()) {
         SDL_Log("ERROR: Texture with ID %s already exists.\n", id.c_str());
         return -1;
     }
 
-    textureMap[id] = texture;
+    TextureEntry& entry = textureMap[id];
+    entry.texture = texture;
+    entry.pinned = true;
+
+    entry.bytes = static_cast<size_t>(texture->width) * texture->height * SDL_BYTESPERPIXEL(texture->format);
+    entry.width = texture->width;
+    entry.height = texture->height;
+    stats.residentBytes += entry.bytes;
+    stats.residentTextures++;
+    stats.knownTextures++;
+    return 0;
+}
+
+/**
+ * @brief Registers a texture file without loading it. It will be loaded the first time it is used
+ * 
+ * @param id ID to associate with the texture.
+ * @param path Path to the texture file.
+ * @return int 0 on success, -1 if the ID already exists.
+ */
+int TextureManager::registerTexture(const std::string& id, const std::string& path){
+    if(textureMap.find(id) != textureMap.end()) {
+        SDL_Log("ERROR: Texture with ID %s already exists.\n", id.c_str());
+        return -1;
+    }
+
+    textureMap[id].path = path;
+    stats.knownTextures++;
     return 0;
 }
+
 /**
  * @brief Loads a texture from a file and stores it in the texture map.
  * 
@@ -37,34 +66,307 @@ int TextureManager::addTexture(const std::string& id, SDL_Texture* texture){
  * @return int Returns 0 on success, or a negative value on failure.
  */
  int TextureManager::loadTexture(const std::string& id, const std::string& path){
-
-    // Create a surface from the image file
-    // SDL_Surface is used to load the image before converting it to an SDL_Texture
-    SDL_Surface* surface = IMG_Load(path.c_str());
-    if(!surface){
-        SDL_Log("ERROR: Could not load image '%s'. %s\n", path.c_str(), IMG_GetError());
+    if(registerTexture(id, path) != 0) {
         return -1;
     }
 
-    // Create a texture from the surface
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(*rendererPtr, surface);
-    if(!texture){
-        SDL_Log("ERROR: Could not create texture from '%s'. %s\n", path.c_str(), SDL_GetError());
+    if(makeResident(id, textureMap[id]) != 0) {
+        textureMap.erase(id);
+        stats.knownTextures--;
         return -1;
     }
-    SDL_FreeSurface(surface);
+    SDL_Log("Texture '%s' loaded successfully from '%s'\n", id.c_str(), path.c_str());
+    return 0;
+ }
+
+/**
+ * @brief Loads the file of a registered texture into memory, then evicts other textures if the budget is exceeded.
+ * 
+ * @param id 
+ * @param entry 
+ * @return int 0 on success, -1 on failure.
+ */
+int TextureManager::makeResident(const std::string& id, TextureEntry& entry){
+
+    RenderTexture* texture = nullptr;
+    if(entry.archiveEntry) {
+        texture = createArchiveTexture(*entry.archiveEntry);
+        if(!texture) {
+            return -1;
+        }
+        entry.bytes = static_cast<size_t>(entry.archiveEntry->pitch) * entry.archiveEntry->height;
+    }
+    else {
+        // Create a surface from the image file
+        // SDL_Surface is used to load the image before converting it to a texture of the backend
+        SDL_Surface* surface = IMG_Load(entry.path.c_str());
+        if(!surface){
+            SDL_Log("ERROR: Could not load image '%s'. %s\n", entry.path.c_str(), IMG_GetError());
+            return -1;
+        }
+
+        // Create a texture from the surface
+        texture = backend->createTextureFromSurface(surface);
+        if(!texture){
+            SDL_Log("ERROR: Could not create texture from '%s'.\n", entry.path.c_str());
+            SDL_FreeSurface(surface);
+            return -1;
+        }
+        entry.bytes = static_cast<size_t>(surface->w) * surface->h * 4;
+        SDL_FreeSurface(surface);
+    }
+
+    entry.texture = texture;
+    entry.width = texture->width;
+    entry.height = texture->height;
+    lruList.push_front(id);
+    entry.lruPosition = lruList.begin();
+    stats.residentBytes += entry.bytes;
+    stats.residentTextures++;
+
+    evictToBudget(&entry);
+    return 0;
+}
+
+/**
+ * @brief Creates a texture from the pixels of an archive entry. The pixels are already decoded, so they are uploaded straight from the mapped file.
+ * 
+ * @param entry 
+ * @return RenderTexture* The texture, or nullptr on failure
+ */
+RenderTexture* TextureManager::createArchiveTexture(const ArchiveEntry& entry){
+    const void* pixels = archive.getData(entry);
+    if(!pixels) {
+        return nullptr;
+    }
+
+    RenderTexture* texture = backend->createTexture(entry.width, entry.height, false, entry.format);
+    if(!texture) {
+        SDL_Log("ERROR: Could not create texture '%s'.\n", entry.name);
+        return nullptr;
+    }
+    if(backend->updateTexture(texture, nullptr, pixels, entry.pitch) != 0) {
+        SDL_Log("ERROR: Could not upload texture '%s'.\n", entry.name);
+        backend->destroyTexture(texture);
+        return nullptr;
+    }
+    return texture;
+}
+
+/**
+ * @brief Destroys a resident texture. It stays registered and can be loaded again
+ * 
+ * @param entry 
+ */
+void TextureManager::releaseTexture(TextureEntry& entry){
+    if(!entry.texture) {
+        return;
+    }
+    releaseVariants(entry);
+    backend->destroyTexture(entry.texture);
+    entry.texture = nullptr;
+    if(!entry.pinned) {
+        lruList.erase(entry.lruPosition);
+    }
+    stats.residentBytes -= entry.bytes;
+    stats.residentTextures--;
+}
 
-    // Store the texture in the map with the given ID
-    if(addTexture(id, texture) != 0) {
-        SDL_DestroyTexture(texture);
+/**
+ * @brief Frees the pre-scaled variants of a texture
+ * 
+ * @param entry 
+ */
+void TextureManager::releaseVariants(TextureEntry& entry){
+    for(auto& level : entry.levels) {
+        backend->destroyTexture(level.texture);
+        size_t bytes = static_cast<size_t>(level.width) * level.height * 4;
+        entry.bytes -= bytes;
+        stats.residentBytes -= bytes;
+    }
+    entry.levels.clear();
+    if(entry.exact.texture) {
+        backend->destroyTexture(entry.exact.texture);
+        size_t bytes = static_cast<size_t>(entry.exact.width) * entry.exact.height * 4;
+        entry.bytes -= bytes;
+        stats.residentBytes -= bytes;
+        entry.exact = TextureVariant();
+    }
+    entry.requestedDraws = 0;
+}
+
+/**
+ * @brief Makes a variant by drawing a texture scaled into a new render target with linear filtering. The target, scale and clip of the backend are restored afterwards, so it can be called in the middle of a frame
+ * 
+ * @param source Texture to scale, at most twice the size of the variant for a good filtering
+ * @param variant Variant to make, with its width and height set
+ * @return int 0 on success, -1 if the render target could not be created
+ */
+int TextureManager::buildVariant(RenderTexture* source, TextureVariant& variant){
+    RenderTexture* texture = backend->createTexture(variant.width, variant.height, true);
+    if(!texture) {
+        SDL_Log("ERROR: Could not create a %dx%d texture variant, variants disabled.\n", variant.width, variant.height);
+        variantsEnabled = false;
         return -1;
     }
-    SDL_Log("Texture '%s' loaded successfully from '%s'\n", id.c_str(), path.c_str());
+
+    RenderTexture* previousTarget = backend->getTarget();
+    SDL_Rect clip;
+    bool clipped = backend->getClip(&clip);
+    float scaleX, scaleY;
+    backend->getScale(&scaleX, &scaleY);
+    RenderBlend blend = source->blend;
+    RenderFilter filter = source->filter;
+
+    // the pixels are copied with their alpha, not blended over the empty target
+    backend->setTarget(texture);
+    backend->clear({0, 0, 0, 0});
+    backend->setTextureBlend(source, RENDER_BLEND_NONE);
+    backend->setTextureFilter(source, RENDER_FILTER_LINEAR);
+    backend->copy(source, nullptr, nullptr);
+    backend->setTextureBlend(source, blend);
+    backend->setTextureFilter(source, filter);
+
+    backend->setTarget(previousTarget);
+    backend->setScale(scaleX, scaleY);
+    backend->setClip(clipped ? &clip : nullptr);
+
+    variant.texture = texture;
+    stats.variantsBuilt++;
     return 0;
- }
+}
+
+/**
+ * @brief Picks the texture to draw for an on-screen size: the exact-size variant if there is one, otherwise the smallest level that is not smaller than the size. Missing levels are made on the way, and the exact-size variant is made once the texture keeps being drawn at the same size
+ * 
+ * @param entry Resident texture
+ * @param pixelWidth On-screen width in pixels
+ * @param pixelHeight On-screen height in pixels
+ * @param variant Set to the chosen variant, nullptr if the full texture is chosen
+ * @return RenderTexture* 
+ */
+RenderTexture* TextureManager::selectVariant(TextureEntry& entry, int pixelWidth, int pixelHeight, TextureVariant** variant){
+    *variant = nullptr;
+    // nothing is sharper than the full texture when it is drawn at its size or bigger
+    if(pixelWidth <= 0 || pixelHeight <= 0 || (pixelWidth >= entry.width && pixelHeight >= entry.height)) {
+        return entry.texture;
+    }
+    if(entry.exact.texture && entry.exact.width == pixelWidth && entry.exact.height == pixelHeight) {
+        *variant = &entry.exact;
+        return entry.exact.texture;
+    }
+
+    // smallest level that still has at least the on-screen size, each one is made from the previous one
+    RenderTexture* base = entry.texture;
+    TextureVariant* baseVariant = nullptr;
+    int levelWidth = entry.width / 2;
+    int levelHeight = entry.height / 2;
+    for(size_t level = 0; levelWidth >= pixelWidth && levelHeight >= pixelHeight
+        && levelWidth >= TEXTURE_MIN_LEVEL_SIZE && levelHeight >= TEXTURE_MIN_LEVEL_SIZE; level++) {
+        if(level == entry.levels.size()) {
+            TextureVariant next;
+            next.width = levelWidth;
+            next.height = levelHeight;
+            if(buildVariant(base, next) != 0) {
+                break;
+            }
+            entry.levels.push_back(next);
+            size_t bytes = static_cast<size_t>(levelWidth) * levelHeight * 4;
+            entry.bytes += bytes;
+            stats.residentBytes += bytes;
+        }
+        baseVariant = &entry.levels[level];
+        base = baseVariant->texture;
+        levelWidth /= 2;
+        levelHeight /= 2;
+    }
+
+    if(pixelWidth == entry.requestedWidth && pixelHeight == entry.requestedHeight) {
+        entry.requestedDraws++;
+    }
+    else {
+        entry.requestedWidth = pixelWidth;
+        entry.requestedHeight = pixelHeight;
+        entry.requestedDraws = 1;
+    }
+
+    if(entry.requestedDraws >= TEXTURE_EXACT_VARIANT_DRAWS && variantsEnabled) {
+        TextureVariant exact;
+        exact.width = pixelWidth;
+        exact.height = pixelHeight;
+        if(buildVariant(base, exact) == 0) {
+            if(entry.exact.texture) {
+                backend->destroyTexture(entry.exact.texture);
+                size_t bytes = static_cast<size_t>(entry.exact.width) * entry.exact.height * 4;
+                entry.bytes -= bytes;
+                stats.residentBytes -= bytes;
+            }
+            entry.exact = exact;
+            size_t bytes = static_cast<size_t>(exact.width) * exact.height * 4;
+            entry.bytes += bytes;
+            stats.residentBytes += bytes;
+            *variant = &entry.exact;
+            return entry.exact.texture;
+        }
+    }
+
+    *variant = baseVariant;
+    return base;
+}
+
+/**
+ * @brief Evicts least recently used textures until the resident memory fits the budget
+ * 
+ * @param keep Texture that must not be evicted (the one just loaded)
+ */
+void TextureManager::evictToBudget(const TextureEntry* keep){
+    while(stats.residentBytes > memoryBudget && !lruList.empty()) {
+        auto it = textureMap.find(lruList.back());
+        if(&it->second == keep) {
+            break;
+        }
+        SDL_Log("Evicting texture '%s'\n", it->first.c_str());
+        releaseTexture(it->second);
+        stats.evictions++;
+    }
+}
+
+/**
+ * @brief Gets a texture, loading it if it is not resident, and marks it as the most recently used.
+ * 
+ * @param id 
+ * @return TextureEntry* The resident texture, or nullptr if it is unknown or could not be loaded
+ */
+TextureEntry* TextureManager::acquireTexture(const std::string& id){
+    auto it = textureMap.find(id);
+    if(it == textureMap.end()) {
+        SDL_Log("ERROR: Texture with ID %s not found.\n", id.c_str());
+        return nullptr;
+    }
+
+    TextureEntry& entry = it->second;
+    if(entry.texture) {
+        stats.hits++;
+        if(!entry.pinned) {
+            lruList.splice(lruList.begin(), lruList, entry.lruPosition);
+        }
+        return &entry;
+    }
+
+    // Not resident, the caller has to wait for the load
+    stats.misses++;
+    stats.loadStalls++;
+    Uint64 start = SDL_GetPerformanceCounter();
+    int result = makeResident(id, entry);
+    stats.stallMilliseconds += (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+    if(result != 0) {
+        return nullptr;
+    }
+    return &entry;
+}
 
  /**
-  * @brief Searches for a texture by its ID.
+  * @brief Searches for a texture by its ID. The texture does not need to be resident.
   * 
   * @param id ID of the texture to search for.
   * @return int 0 if found, or -1 if not found.
@@ -78,48 +380,139 @@ int TextureManager::addTexture(const std::string& id, SDL_Texture* texture){
  }
 
 /**
- * @brief Draws a texture on the screen at the specified position and size.
+ * @brief Makes sure a texture is resident, loading it if needed.
+ * 
+ * @param id 
+ * @return int 0 on success, -1 if the texture is unknown or could not be loaded.
+ */
+int TextureManager::requireTexture(const std::string& id){
+    return acquireTexture(id) ? 0 : -1;
+}
+
+/**
+ * @brief Hints that a texture will be needed soon. It is loaded by processPrefetches, outside of drawing
  * 
- * @param id ID of the texture to draw (must be loaded beforehand).
+ * @param id 
+ */
+void TextureManager::prefetchTexture(const std::string& id){
+    auto it = textureMap.find(id);
+    if(it == textureMap.end() || it->second.texture) {
+        return;
+    }
+    if(std::find(prefetchQueue.begin(), prefetchQueue.end(), id) == prefetchQueue.end()) {
+        prefetchQueue.push_back(id);
+    }
+}
+
+/**
+ * @brief Loads textures hinted with prefetchTexture.
+ * 
+ * @param maxLoads Maximum textures to load in this call
+ * @return int Number of textures loaded
+ */
+int TextureManager::processPrefetches(int maxLoads){
+    int loaded = 0;
+    while(!prefetchQueue.empty() && loaded < maxLoads) {
+        std::string id = prefetchQueue.front();
+        prefetchQueue.erase(prefetchQueue.begin());
+
+        auto it = textureMap.find(id);
+        if(it == textureMap.end() || it->second.texture) {
+            continue;
+        }
+        if(makeResident(id, it->second) == 0) {
+            stats.prefetches++;
+            loaded++;
+        }
+    }
+    return loaded;
+}
+
+/**
+ * @brief Draws a texture on the screen at the specified position and size. The pre-scaled variant closest to the on-screen size is drawn.
+ * 
+ * @param id ID of the texture to draw (loaded if it is not resident).
  * @param x X coordinate of the position to draw the texture.
  * @param y Y coordinate of the position to draw the texture.
  * @param width Width of the texture.
  * @param height Height of the texture.
  * @param clip Clip rectangle to specify a portion of the texture to draw (optional).
+ * @param state Tint, alpha, flip and rotation of the draw (optional, drawn as is by default).
  */
- void TextureManager::drawTexture(const std::string& id, float x, float y, float width, float height, SDL_Rect* clip) {
-    
-    if(id == "__text__"){
-        return; // ignore text textures
-    }
-    if(textureMap.find(id) == textureMap.end()) {
-        SDL_Log("ERROR: Texture with ID %s not found.\n", id.c_str());
+ void TextureManager::drawTexture(const std::string& id, float x, float y, float width, float height, SDL_Rect* clip, const RenderState* state) {
+    TextureEntry* entry = acquireTexture(id);
+    if(!entry) {
         return;
     }
 
-    SDL_Texture* texture = textureMap[id];
     SDL_Rect destRect = {static_cast<int>(x),static_cast<int>(y),static_cast<int>(width),static_cast<int>(height)};
-    SDL_RenderCopy(*rendererPtr, texture, clip, &destRect);
+    RenderTexture* texture = entry->texture;
+    const SDL_Rect* source = clip;
+    SDL_Rect scaledClip;
+    if(variantsEnabled) {
+        // size on the screen in pixels, after the logical resolution scaling
+        float scaleX, scaleY;
+        backend->getScale(&scaleX, &scaleY);
+        int pixelWidth = static_cast<int>(destRect.w * scaleX + 0.5f);
+        int pixelHeight = static_cast<int>(destRect.h * scaleY + 0.5f);
+        if(clip) {
+            // only part of the texture is drawn, the variant has to be as big as the whole texture at that scale
+            pixelWidth = clip->w > 0 ? pixelWidth * entry->width / clip->w : 0;
+            pixelHeight = clip->h > 0 ? pixelHeight * entry->height / clip->h : 0;
+        }
+
+        TextureVariant* variant;
+        unsigned long long built = stats.variantsBuilt;
+        texture = selectVariant(*entry, pixelWidth, pixelHeight, &variant);
+        if(stats.variantsBuilt != built) {
+            evictToBudget(entry);
+        }
+        if(variant) {
+            stats.variantDraws++;
+        }
+        if(variant && clip) {
+            scaledClip = {
+                clip->x * variant->width / entry->width, clip->y * variant->height / entry->height,
+                clip->w * variant->width / entry->width, clip->h * variant->height / entry->height
+            };
+            source = &scaledClip;
+        }
+    }
+
+    if(state && !state->isDefault()) {
+        backend->copyEx(texture, source, &destRect, *state);
+    }
+    else {
+        backend->copy(texture, source, &destRect);
+    }
  }
 
  /**
-  * @brief Clears all loaded textures from the texture map.
+  * @brief Clears all textures from the texture map.
   * 
   */
  void TextureManager::clearAllTextures(){
     for(auto& i : textureMap){
-        SDL_DestroyTexture(i.second);
+        if(i.second.texture) {
+            releaseVariants(i.second);
+            backend->destroyTexture(i.second.texture);
+        }
     }
     textureMap.clear();
+    lruList.clear();
+    prefetchQueue.clear();
+    stats.residentBytes = 0;
+    stats.residentTextures = 0;
+    stats.knownTextures = 0;
  }
 
  /**
-  * @brief Loads all textures from a specified directory. ID will be the file name without extension.
+  * @brief Registers all textures from a specified directory. ID will be the file name without extension. Textures are loaded on first use.
   * 
   * @param path Path to the directory containing texture files.
   */
 void TextureManager::loadAllTextures(std::string path){
-    SDL_Log("Loading textures from path: %s\n", path.c_str());
+    SDL_Log("Registering textures from path: %s\n", path.c_str());
 
     for(auto& file : std::filesystem::directory_iterator(path)){
 
@@ -131,16 +524,92 @@ void TextureManager::loadAllTextures(std::string path){
         std::string id = file.path().stem().string(); // Use the file name without extension as ID
         std::string fullPath = file.path().string();
 
-        if(loadTexture(id, fullPath)){
-            SDL_Log("Failed to load texture: %s", fullPath.c_str());
-        }
-        else {
-            SDL_Log("Loaded texture: %s", fullPath.c_str());
+        if(registerTexture(id, fullPath)){
+            SDL_Log("Failed to register texture: %s", fullPath.c_str());
         }
     }
-    SDL_Log("Finished loading textures\n");
+    SDL_Log("Finished registering textures\n");
  }
 
+/**
+ * @brief Maps a packed asset archive and registers its images and fonts. Images are loaded on first use, fonts are opened from the mapped file right away.
+ * 
+ * @param path Path to the archive (see the packer tool).
+ * @return int 0 on success, -1 if the archive could not be mapped.
+ */
+int TextureManager::loadArchive(const std::string& path){
+    if(archive.open(path) != 0) {
+        return -1;
+    }
+
+    for(uint32_t i = 0; i < archive.getEntryCount(); i++) {
+        const ArchiveEntry& entry = archive.getEntry(i);
+        std::string id = entry.name;
+
+        if(entry.type == ARCHIVE_IMAGE) {
+            if(textureMap.find(id) != textureMap.end()) {
+                SDL_Log("ERROR: Texture with ID %s already exists.\n", id.c_str());
+                continue;
+            }
+            textureMap[id].archiveEntry = &entry;
+            stats.knownTextures++;
+        }
+        else if(entry.type == ARCHIVE_FONT) {
+            const void* data = archive.getData(entry);
+            if(!data || loadFontFromMemory(id, data, entry.rawSize, 24) != 0) {
+                SDL_Log("Failed to load font: %s", id.c_str());
+            }
+        }
+    }
+    SDL_Log("Finished loading archive '%s'\n", path.c_str());
+    return 0;
+}
+
+/**
+ * @brief Sets the memory budget for resident textures, evicting textures if needed
+ * 
+ * @param bytes 
+ */
+void TextureManager::setMemoryBudget(size_t bytes){
+    memoryBudget = bytes;
+    evictToBudget(nullptr);
+}
+
+/**
+ * @brief Enables or disables drawing pre-scaled variants. Disabling them frees the ones already made
+ * 
+ * @param enabled 
+ */
+void TextureManager::setVariantsEnabled(bool enabled){
+    variantsEnabled = enabled;
+    if(!enabled) {
+        for(auto& i : textureMap) {
+            releaseVariants(i.second);
+        }
+    }
+}
+
+/**
+ * @brief Get the texture cache counters
+ * 
+ * @return const TextureCacheStats& 
+ */
+const TextureCacheStats& TextureManager::getCacheStats() const {
+    return stats;
+}
+
+/**
+ * @brief Logs the texture cache counters
+ * 
+ */
+void TextureManager::logCacheStats() const {
+    unsigned long long requests = stats.hits + stats.misses;
+    double hitRate = requests ? 100.0 * stats.hits / requests : 0.0;
+    SDL_Log("Texture cache: %d/%d resident, %zu/%zu bytes, hit rate %.2f%% (%llu hits, %llu misses), %llu load stalls (%.2f ms), %llu prefetched, %llu evictions\n",
+        stats.residentTextures, stats.knownTextures, stats.residentBytes, memoryBudget, hitRate,
+        stats.hits, stats.misses, stats.loadStalls, stats.stallMilliseconds, stats.prefetches, stats.evictions);
+    SDL_Log("Texture variants: %llu made, %llu draws served by a variant\n", stats.variantsBuilt, stats.variantDraws);
+}
 
 int TextureManager::loadFont(const std::string& id, const std::string& path, int size){
 
@@ -162,6 +631,34 @@ int TextureManager::loadFont(const std::string& id, const std::string& path, int
     return 0;
 }
 
+/**
+ * @brief Opens a font from memory. The memory must stay valid while the font is open
+ * 
+ * @param id 
+ * @param data 
+ * @param size Size of the data
+ * @param fontSize 
+ * @return int 0 on success, -1 on failure
+ */
+int TextureManager::loadFontFromMemory(const std::string& id, const void* data, size_t size, int fontSize){
+
+    std::string newId = id + std::to_string(fontSize);
+
+    if(fontMap.find(newId) != fontMap.end()) {
+        SDL_Log("ERROR: Font with ID %s already exists.\n", newId.c_str());
+        return -1;
+    }
+
+    TTF_Font* font = TTF_OpenFontRW(SDL_RWFromConstMem(data, static_cast<int>(size)), 1, fontSize);
+    if(!font) {
+        SDL_Log("ERROR: Could not load font '%s'. %s\n", id.c_str(), TTF_GetError());
+        return -1;
+    }
+
+    fontMap[newId] = font;
+    return 0;
+}
+
 TTF_Font** TextureManager::getFont(const std::string& id){
     auto i = fontMap.find(id);
     if(i == fontMap.end()) {
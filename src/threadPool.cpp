@@ -0,0 +1,157 @@
+/**
+ * @file threadPool.cpp
+ * @author Iván Mansilla
+ * @brief Work-stealing thread pool.
+ * @version 0.1
+ * @date 2025-07-28
+ *
+ *
+ */
+
+#include "../inc/threadPool.h"
+
+/**
+ * @brief Pool of the worker running on the calling thread and its index, nullptr and -1 outside any pool
+ */
+static thread_local const ThreadPool* currentPool = nullptr;
+static thread_local long currentWorker = -1;
+
+/**
+ * @brief Construct a new Thread Pool object
+ *
+ * @param threadCount Number of workers, 0 to use one per hardware thread
+ */
+ThreadPool::ThreadPool(size_t threadCount){
+    if(threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+        if(threadCount == 0) {
+            threadCount = 1;
+        }
+    }
+
+    for(size_t i = 0; i < threadCount; i++) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for(size_t i = 0; i < threadCount; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+/**
+ * @brief Destroy the Thread Pool object. Pending tasks are finished first
+ *
+ */
+ThreadPool::~ThreadPool(){
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for(auto& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Queues a task. Tasks submitted from a worker go to its own queue, the rest are spread over all queues
+ *
+ * @param task
+ */
+void ThreadPool::submit(std::function<void()> task){
+    // a worker of another pool submitting here is an outside thread for this pool
+    size_t queue = currentPool == this ? static_cast<size_t>(currentWorker)
+        : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+
+    pendingTasks.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(queues[queue]->mutex);
+        queues[queue]->tasks.push_back(std::move(task));
+    }
+    {
+        // taking the lock keeps a worker from missing the notification between its check and its sleep
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    workAvailable.notify_one();
+}
+
+/**
+ * @brief Takes a task for a worker: the newest of its own queue, or the oldest of another queue
+ *
+ * @param worker
+ * @param task
+ * @return true if a task was taken
+ * @return false if all queues are empty
+ */
+bool ThreadPool::takeTask(size_t worker, std::function<void()>& task){
+    {
+        WorkerQueue& own = *queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if(!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    for(size_t i = 1; i < queues.size(); i++) {
+        WorkerQueue& victim = *queues[(worker + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if(!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Main loop of a worker thread
+ *
+ * @param worker
+ */
+void ThreadPool::workerLoop(size_t worker){
+    currentPool = this;
+    currentWorker = static_cast<long>(worker);
+    std::function<void()> task;
+
+    while(true) {
+        if(takeTask(worker, task)) {
+            task();
+            task = nullptr;
+            if(pendingTasks.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+                workFinished.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        if(stopping) {
+            return;
+        }
+        // the queues are checked again under the lock, submit() takes it before notifying
+        bool found = false;
+        for(auto& queue : queues) {
+            std::lock_guard<std::mutex> queueLock(queue->mutex);
+            if(!queue->tasks.empty()) {
+                found = true;
+                break;
+            }
+        }
+        if(!found) {
+            workAvailable.wait(lock);
+        }
+    }
+}
+
+/**
+ * @brief Blocks until every submitted task has finished. Must not be called from a task
+ *
+ */
+void ThreadPool::wait(){
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    workFinished.wait(lock, [this]{ return pendingTasks.load(std::memory_order_acquire) == 0; });
+}
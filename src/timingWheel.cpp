@@ -0,0 +1,355 @@
+/**
+ * @file timingWheel.cpp
+ * @author Iván Mansilla
+ * @brief Hierarchical timing wheel for delayed and periodic effects.
+ * @version 0.1
+ * @date 2025-08-03
+ *
+ *
+ */
+
+#include "../inc/timingWheel.h"
+#include <algorithm>
+#include <bit>
+
+/**
+ * Index of the list of expired timers, after the slot lists
+ */
+static const int EXPIRED_LIST = TIMING_WHEEL_LEVELS * TIMING_WHEEL_SLOTS;
+
+/**
+ * @brief Adds a callback timer
+ *
+ * @param delay Milliseconds of game time until it fires. 0 fires on the first update that advances the clock, not on
+ * an update with the same time
+ * @param callback
+ * @param period Milliseconds between firings after the first one, 0 to fire once
+ * @return TimerId
+ */
+TimerId TimingWheel::addTimer(Uint32 delay, TimerCallback callback, Uint32 period){
+    TimerId id = add(delay, period);
+    nodes[static_cast<Uint32>(id)].callback = std::move(callback);
+    return id;
+}
+
+/**
+ * @brief Adds an event timer, returned by the update it fires in
+ *
+ * @param delay Milliseconds of game time until it fires. 0 fires on the first update that advances the clock, not on
+ * an update with the same time
+ * @param event Event ID, not 0
+ * @param target Player, Store or Item the event is about
+ * @param value Value given back with the event
+ * @param period Milliseconds between firings after the first one, 0 to fire once
+ * @return TimerId
+ */
+TimerId TimingWheel::addEvent(Uint32 delay, int event, TimerTarget target, int value, Uint32 period){
+    TimerId id = add(delay, period);
+    Node& node = nodes[static_cast<Uint32>(id)];
+    node.event = event;
+    node.target = target;
+    node.value = value;
+    return id;
+}
+
+/**
+ * @brief Takes a free node and puts it in the wheel
+ *
+ * @param delay
+ * @param period
+ * @return TimerId
+ */
+TimerId TimingWheel::add(Uint32 delay, Uint32 period){
+    int node;
+    if(freeNode != -1) {
+        node = freeNode;
+        freeNode = nodes[node].next;
+    }
+    else {
+        node = static_cast<int>(nodes.size());
+        nodes.emplace_back();
+    }
+    nodes[node].expires = current + delay;
+    nodes[node].period = period;
+    nodes[node].event = 0;
+    nodes[node].value = 0;
+    count++;
+    // a timer that is due already waits for the clock to advance
+    insert(node, std::max(nodes[node].expires, current + 1));
+    return (static_cast<TimerId>(nodes[node].generation) << 32) | static_cast<Uint32>(node);
+}
+
+/**
+ * @brief Puts a node in the slot of the lowest level whose span reaches the time
+ *
+ * @param node
+ * @param time Time it must be in a level 0 slot by, not before the current time
+ */
+void TimingWheel::insert(int node, Uint64 time){
+    Uint64 delta = time - current;
+    int level = 0;
+    while(level < TIMING_WHEEL_LEVELS - 1 && delta >= (1ULL << (TIMING_WHEEL_BITS * (level + 1)))) {
+        level++;
+    }
+    int slot = static_cast<int>((time >> (TIMING_WHEEL_BITS * level)) & (TIMING_WHEEL_SLOTS - 1));
+    link(node, level * TIMING_WHEEL_SLOTS + slot);
+}
+
+/**
+ * @brief Appends a node to a list
+ *
+ * @param node
+ * @param list
+ */
+void TimingWheel::link(int node, int list){
+    nodes[node].list = list;
+    nodes[node].prev = lists[list].tail;
+    nodes[node].next = -1;
+    if(lists[list].tail != -1) {
+        nodes[lists[list].tail].next = node;
+    }
+    else {
+        lists[list].head = node;
+    }
+    lists[list].tail = node;
+    if(list != EXPIRED_LIST) {
+        occupied[list / TIMING_WHEEL_SLOTS] |= 1ULL << (list % TIMING_WHEEL_SLOTS);
+    }
+}
+
+/**
+ * @brief Removes a node from its list
+ *
+ * @param node
+ */
+void TimingWheel::unlink(int node){
+    int list = nodes[node].list;
+    int prev = nodes[node].prev;
+    int next = nodes[node].next;
+    if(prev != -1) {
+        nodes[prev].next = next;
+    }
+    else {
+        lists[list].head = next;
+    }
+    if(next != -1) {
+        nodes[next].prev = prev;
+    }
+    else {
+        lists[list].tail = prev;
+    }
+    if(list != EXPIRED_LIST && lists[list].head == -1) {
+        occupied[list / TIMING_WHEEL_SLOTS] &= ~(1ULL << (list % TIMING_WHEEL_SLOTS));
+    }
+    nodes[node].list = -1;
+}
+
+/**
+ * @brief Frees a node, its ID is not valid anymore
+ *
+ * @param node
+ */
+void TimingWheel::release(int node){
+    nodes[node].callback = nullptr;
+    nodes[node].target = TimerTarget();
+    nodes[node].generation++;
+    nodes[node].list = -1;
+    nodes[node].next = freeNode;
+    freeNode = node;
+    count--;
+}
+
+/**
+ * @brief Finds the node of a timer that did not fire or was not cancelled yet
+ *
+ * @param id
+ * @return int Index of the node, -1 if the ID is not valid
+ */
+int TimingWheel::findNode(TimerId id) const {
+    Uint32 node = static_cast<Uint32>(id);
+    if(node >= nodes.size() || nodes[node].generation != static_cast<unsigned int>(id >> 32) || nodes[node].list == -1) {
+        return -1;
+    }
+    return static_cast<int>(node);
+}
+
+/**
+ * @brief Cancels a timer
+ *
+ * @param id
+ * @return int 0 on success, -1 if it already fired or was cancelled
+ */
+int TimingWheel::cancel(TimerId id){
+    int node = findNode(id);
+    if(node == -1) {
+        return -1;
+    }
+    unlink(node);
+    release(node);
+    return 0;
+}
+
+/**
+ * @brief Checks if a timer is waiting to fire
+ *
+ * @param id
+ * @return true
+ * @return false
+ */
+bool TimingWheel::isPending(TimerId id) const {
+    return findNode(id) != -1;
+}
+
+/**
+ * @brief Moves the timers of a level 0 slot to the expired list, they are due now
+ *
+ * @param slot
+ */
+void TimingWheel::expireSlot(int slot){
+    List& list = lists[slot];
+    for(int node = list.head; node != -1; node = nodes[node].next) {
+        nodes[node].list = EXPIRED_LIST;
+    }
+    List& expired = lists[EXPIRED_LIST];
+    if(expired.tail != -1) {
+        nodes[expired.tail].next = list.head;
+        nodes[list.head].prev = expired.tail;
+    }
+    else {
+        expired.head = list.head;
+    }
+    expired.tail = list.tail;
+    list = List();
+    occupied[0] &= ~(1ULL << slot);
+}
+
+/**
+ * @brief Moves the timers of the slots whose span starts now down to the lower levels. Called when the current
+ * time is the start of a level 1 slot, the highest level is emptied first so its timers can move down again
+ *
+ */
+void TimingWheel::cascade(){
+    int top = 1;
+    while(top < TIMING_WHEEL_LEVELS - 1 && (current & ((1ULL << (TIMING_WHEEL_BITS * (top + 1))) - 1)) == 0) {
+        top++;
+    }
+    for(int level = top; level >= 1; level--) {
+        int slot = static_cast<int>((current >> (TIMING_WHEEL_BITS * level)) & (TIMING_WHEEL_SLOTS - 1));
+        if(!(occupied[level] & (1ULL << slot))) {
+            continue;
+        }
+        List& list = lists[level * TIMING_WHEEL_SLOTS + slot];
+        int node = list.head;
+        list = List();
+        occupied[level] &= ~(1ULL << slot);
+        while(node != -1) {
+            int next = nodes[node].next;
+            insert(node, std::max(nodes[node].expires, current));
+            node = next;
+        }
+    }
+}
+
+/**
+ * @brief Next time the wheel has work: a level 0 slot with timers, or the start of a slot of a higher level that
+ * must move down. Empty slots are skipped with the bitmaps
+ *
+ * @return Uint64 The time, UINT64_MAX if there are no timers in the wheel
+ */
+Uint64 TimingWheel::nextStop() const {
+    for(int level = 0; level < TIMING_WHEEL_LEVELS; level++) {
+        int shift = TIMING_WHEEL_BITS * level;
+        int index = static_cast<int>((current >> shift) & (TIMING_WHEEL_SLOTS - 1));
+        Uint64 later = index == TIMING_WHEEL_SLOTS - 1 ? 0 : occupied[level] & (~0ULL << (index + 1));
+        Uint64 turn = current >> (shift + TIMING_WHEEL_BITS) << (shift + TIMING_WHEEL_BITS);
+        if(later) {
+            return turn + (static_cast<Uint64>(std::countr_zero(later)) << shift);
+        }
+        // slots at or before the current one belong to the next turn of this level
+        if(occupied[level]) {
+            return turn + (1ULL << (shift + TIMING_WHEEL_BITS));
+        }
+    }
+    return UINT64_MAX;
+}
+
+/**
+ * @brief Advances the wheel to the time of the game clock. The due timers are taken slot by slot and then fired
+ * in time order: callbacks are called, event timers are returned. Periodic timers are added again, a timer that
+ * fell more than a period behind fires once with the number of periods that elapsed.
+ *
+ * Callbacks may add and cancel timers, but not update the wheel.
+ *
+ * @param milliseconds Time of the game clock, it never goes back
+ * @return const std::vector<TimerEvent>& Event timers fired, valid until the next update
+ */
+const std::vector<TimerEvent>& TimingWheel::update(Uint32 milliseconds){
+    events.clear();
+    Uint64 target = std::max(static_cast<Uint64>(milliseconds), current);
+    while(true) {
+        Uint64 stop = nextStop();
+        if(stop > target) {
+            current = target;
+            break;
+        }
+        current = stop;
+        if((current & (TIMING_WHEEL_SLOTS - 1)) == 0) {
+            cascade();
+        }
+        int slot = static_cast<int>(current & (TIMING_WHEEL_SLOTS - 1));
+        if(occupied[0] & (1ULL << slot)) {
+            expireSlot(slot);
+        }
+    }
+
+    while(lists[EXPIRED_LIST].head != -1) {
+        int node = lists[EXPIRED_LIST].head;
+        unlink(node);
+        TimerEvent event;
+        event.id = (static_cast<TimerId>(nodes[node].generation) << 32) | static_cast<Uint32>(node);
+        event.event = nodes[node].event;
+        event.target = nodes[node].target;
+        event.value = nodes[node].value;
+        event.time = static_cast<Uint32>(nodes[node].expires);
+
+        // moved out while it runs, the callback may add timers and move the nodes
+        TimerCallback callback = std::move(nodes[node].callback);
+        bool periodic = nodes[node].period > 0;
+        if(periodic) {
+            Uint32 period = nodes[node].period;
+            event.count = static_cast<int>(1 + (current - nodes[node].expires) / period);
+            nodes[node].expires += static_cast<Uint64>(event.count) * period;
+            insert(node, nodes[node].expires);
+        }
+        else {
+            release(node);
+        }
+
+        if(!callback) {
+            events.push_back(event);
+            continue;
+        }
+        callback(event);
+        // a periodic timer keeps its callback, unless the callback cancelled it
+        if(periodic && findNode(event.id) != -1) {
+            nodes[node].callback = std::move(callback);
+        }
+    }
+    return events;
+}
+
+/**
+ * @brief Cancels every timer
+ *
+ */
+void TimingWheel::clear(){
+    for(size_t i = 0; i < nodes.size(); i++) {
+        if(nodes[i].list != -1) {
+            release(static_cast<int>(i));
+        }
+    }
+    for(List& list : lists) {
+        list = List();
+    }
+    std::fill(std::begin(occupied), std::end(occupied), 0);
+}
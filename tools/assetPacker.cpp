@@ -0,0 +1,206 @@
+/**
+ * @file assetPacker.cpp
+ * @author Iván Mansilla
+ * @brief Offline tool that bundles the game assets into one archive.
+ * @version 0.1
+ * @date 2025-07-22
+ *
+ * Usage: packer <output.pak> <asset directories...> [--lz4] [--abgr]
+ *
+ * Images are decoded and converted to the renderer pixel format (ARGB8888 by default), fonts are stored as they are.
+ */
+#include "../inc/assetArchive.h"
+#include <cstring>
+#include <fstream>
+
+#ifdef USE_LZ4
+    #include <lz4.h>
+#endif
+
+/**
+ * @brief An asset ready to be written
+ */
+struct PackedAsset {
+    ArchiveEntry entry; /*!< Index entry (offset is filled when writing) */
+    std::vector<char> data; /*!< Data as it will be stored */
+};
+
+/**
+ * @brief Compresses the data of an asset with LZ4, if that makes it smaller
+ *
+ * @param asset
+ */
+static void compressAsset(PackedAsset& asset){
+#ifdef USE_LZ4
+    std::vector<char> compressed(LZ4_compressBound(static_cast<int>(asset.data.size())));
+    int size = LZ4_compress_default(asset.data.data(), compressed.data(), static_cast<int>(asset.data.size()), static_cast<int>(compressed.size()));
+    if(size > 0 && static_cast<size_t>(size) < asset.data.size()) {
+        compressed.resize(size);
+        asset.data.swap(compressed);
+        asset.entry.compression = ARCHIVE_LZ4;
+        asset.entry.storedSize = size;
+    }
+#else
+    (void)asset;
+#endif
+}
+
+/**
+ * @brief Decodes an image and converts it to the given pixel format
+ *
+ * @param path
+ * @param format
+ * @param asset
+ * @return int 0 on success, -1 on failure
+ */
+static int packImage(const std::string& path, Uint32 format, PackedAsset& asset){
+    SDL_Surface* loaded = IMG_Load(path.c_str());
+    if(!loaded) {
+        SDL_Log("ERROR: Could not load image '%s'. %s\n", path.c_str(), IMG_GetError());
+        return -1;
+    }
+    SDL_Surface* surface = SDL_ConvertSurfaceFormat(loaded, format, 0);
+    SDL_FreeSurface(loaded);
+    if(!surface) {
+        SDL_Log("ERROR: Could not convert image '%s'. %s\n", path.c_str(), SDL_GetError());
+        return -1;
+    }
+
+    // rows are stored without padding
+    uint32_t pitch = surface->w * 4;
+    asset.entry.type = ARCHIVE_IMAGE;
+    asset.entry.format = format;
+    asset.entry.width = surface->w;
+    asset.entry.height = surface->h;
+    asset.entry.pitch = pitch;
+    asset.data.resize(static_cast<size_t>(pitch) * surface->h);
+    for(int row = 0; row < surface->h; row++) {
+        memcpy(asset.data.data() + row * pitch, static_cast<char*>(surface->pixels) + row * surface->pitch, pitch);
+    }
+    SDL_FreeSurface(surface);
+    return 0;
+}
+
+/**
+ * @brief Reads a font file as it is
+ *
+ * @param path
+ * @param asset
+ * @return int 0 on success, -1 on failure
+ */
+static int packFont(const std::string& path, PackedAsset& asset){
+    std::ifstream file(path, std::ios::binary);
+    if(!file) {
+        SDL_Log("ERROR: Could not read font '%s'.\n", path.c_str());
+        return -1;
+    }
+    asset.data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    asset.entry.type = ARCHIVE_FONT;
+    return 0;
+}
+
+int main(int argc, char* argv[]){
+    if(argc < 3) {
+        printf("Usage: %s <output.pak> <asset directories...> [--lz4] [--abgr]\n", argv[0]);
+        return 1;
+    }
+
+    bool compress = false;
+    Uint32 format = SDL_PIXELFORMAT_ARGB8888;
+    std::vector<std::string> directories;
+    for(int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if(arg == "--lz4") {
+            compress = true;
+        }
+        else if(arg == "--abgr") {
+            format = SDL_PIXELFORMAT_ABGR8888;
+        }
+        else {
+            directories.push_back(arg);
+        }
+    }
+#ifndef USE_LZ4
+    if(compress) {
+        SDL_Log("LZ4 support not built in (build with LZ4=1), storing raw data\n");
+        compress = false;
+    }
+#endif
+
+    IMG_Init(IMG_INIT_PNG);
+
+    std::vector<PackedAsset> assets;
+    for(auto& directory : directories) {
+        for(auto& file : std::filesystem::directory_iterator(directory)) {
+            if(!file.is_regular_file()) {
+                continue;
+            }
+            std::string extension = file.path().extension().string();
+            std::string id = file.path().stem().string();
+            std::string path = file.path().string();
+
+            PackedAsset asset = {};
+            int result;
+            if(extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".bmp") {
+                result = packImage(path, format, asset);
+            }
+            else if(extension == ".ttf" || extension == ".otf") {
+                result = packFont(path, asset);
+            }
+            else {
+                continue;
+            }
+            if(result != 0) {
+                continue;
+            }
+            if(id.size() >= ARCHIVE_NAME_LENGTH) {
+                SDL_Log("ERROR: Name of '%s' is too long, skipped\n", path.c_str());
+                continue;
+            }
+
+            strncpy(asset.entry.name, id.c_str(), ARCHIVE_NAME_LENGTH - 1);
+            asset.entry.compression = ARCHIVE_RAW;
+            asset.entry.rawSize = asset.data.size();
+            asset.entry.storedSize = asset.data.size();
+            if(compress && asset.entry.type == ARCHIVE_IMAGE) {
+                compressAsset(asset);
+            }
+            SDL_Log("Packed '%s' (%llu bytes)\n", path.c_str(), static_cast<unsigned long long>(asset.entry.storedSize));
+            assets.push_back(std::move(asset));
+        }
+    }
+
+    // Place the data after the index, aligned
+    ArchiveHeader header = {};
+    memcpy(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+    header.version = ARCHIVE_VERSION;
+    header.entryCount = static_cast<uint32_t>(assets.size());
+
+    uint64_t offset = sizeof(ArchiveHeader) + assets.size() * sizeof(ArchiveEntry);
+    for(auto& asset : assets) {
+        offset = (offset + ARCHIVE_ALIGNMENT - 1) / ARCHIVE_ALIGNMENT * ARCHIVE_ALIGNMENT;
+        asset.entry.offset = offset;
+        offset += asset.entry.storedSize;
+    }
+
+    std::ofstream out(argv[1], std::ios::binary);
+    if(!out) {
+        SDL_Log("ERROR: Could not create '%s'.\n", argv[1]);
+        return 1;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for(auto& asset : assets) {
+        out.write(reinterpret_cast<const char*>(&asset.entry), sizeof(ArchiveEntry));
+    }
+    for(auto& asset : assets) {
+        while(static_cast<uint64_t>(out.tellp()) < asset.entry.offset) {
+            out.put('\0');
+        }
+        out.write(asset.data.data(), asset.data.size());
+    }
+    out.close();
+
+    SDL_Log("Wrote %u assets to '%s'\n", header.entryCount, argv[1]);
+    IMG_Quit();
+    return 0;
+}
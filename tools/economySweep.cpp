@@ -0,0 +1,300 @@
+/**
+ * @file economySweep.cpp
+ * @author Iván Mansilla
+ * @brief Headless balance sweep of the store economy over many parameter sets, seeds and player strategies.
+ * @version 0.1
+ * @date 2025-07-28
+ *
+ * Usage: economySweep [--seeds N] [--threads N] [--clicks-per-second R] [--max-hours H]
+ *                     [--prob a,b,...] [--cost a,b,...] [--growth a,b,...] [--out file.csv]
+ *
+ * Every session runs the real Player, Store and Item logic. Instead of simulating every click, the session
+ * jumps straight to the next moment something happens (a purchase or a milestone), so one session takes a
+ * few microseconds. Sessions are spread over all cores with the work-stealing thread pool, and the CSV has
+ * the time to reach every points milestone for each parameter set and strategy.
+ */
+#include "../inc/store.h"
+#include "../inc/frameArena.h"
+#include "../inc/threadPool.h"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <sstream>
+
+/**
+ * Sessions simulated by one task of the thread pool
+ */
+#define SESSIONS_PER_TASK 256
+
+/**
+ * Items in the store of a session, as many as the game has
+ */
+#define SWEEP_ITEM_COUNT 3
+
+static const int MILESTONES[] = {1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000}; /*!< Points milestones */
+static const int MILESTONE_COUNT = sizeof(MILESTONES) / sizeof(MILESTONES[0]);
+static const char* MILESTONE_NAMES[MILESTONE_COUNT] = {"1K", "10K", "100K", "1M", "10M", "100M", "1B"};
+
+/**
+ * @brief How the scripted player picks what to buy
+ */
+enum Strategy {
+    STRATEGY_GREEDY, /*!< Buys the cheapest available item as soon as possible */
+    STRATEGY_SAVE, /*!< Saves for the most expensive available item */
+    STRATEGY_RANDOM, /*!< Saves for a random available item */
+    STRATEGY_COUNT
+};
+
+static const char* STRATEGY_NAMES[STRATEGY_COUNT] = {"greedy", "save", "random"};
+
+/**
+ * @brief Parameters of the economy for a group of sessions
+ */
+struct SweepConfig {
+    float prob; /*!< Probability of the items appearing in the store */
+    int cost; /*!< Base cost of the items */
+    float growth; /*!< Exponent of the cost growth */
+    Strategy strategy; /*!< Strategy of the player */
+};
+
+/**
+ * @brief Options of the sweep
+ */
+struct SweepOptions {
+    int seeds = 20000; /*!< Sessions per configuration */
+    size_t threads = 0; /*!< Worker threads, 0 for one per core */
+    double clicksPerSecond = 5.0; /*!< Click rate of the simulated player */
+    double maxSeconds = 8 * 3600.0; /*!< Length of a session */
+    std::vector<float> probs = {0.5f, 0.75f, 1.0f}; /*!< Item probabilities to try */
+    std::vector<int> costs = {50, 100, 200}; /*!< Base costs to try */
+    std::vector<float> growths = {0.25f, 0.5f, 0.75f}; /*!< Cost growth exponents to try */
+    std::string outPath; /*!< CSV file, stdout if empty */
+};
+
+/**
+ * @brief Simulates one session and writes the time each milestone was reached (negative if it was not)
+ *
+ * @param config
+ * @param seed
+ * @param options
+ * @param times MILESTONE_COUNT values
+ */
+static void runSession(const SweepConfig& config, unsigned int seed, const SweepOptions& options, float* times){
+    ObjectManager objectManager;
+    Player player;
+    Store store(310, 10, 300, 400, "store", &objectManager);
+
+    ItemEffect plusOne;
+    plusOne.amount = 1.0;
+
+    std::unique_ptr<Item> items[SWEEP_ITEM_COUNT];
+    for(int i = 0; i < SWEEP_ITEM_COUNT; i++) {
+        char itemId[16];
+        snprintf(itemId, sizeof(itemId), "item%d", i);
+        items[i] = std::make_unique<Item>(itemId, "upgrade_example", config.cost, "", plusOne, config.prob, &store, &player);
+        items[i]->costGrowth = config.growth;
+    }
+
+    store.setSeed(seed);
+    store.randomizeAvailableItems();
+    std::mt19937 strategyRng(seed ^ 0x9E3779B9u);
+
+    for(int i = 0; i < MILESTONE_COUNT; i++) {
+        times[i] = -1.0f;
+    }
+
+    double clicks = 0.0;
+    const double maxClicks = options.maxSeconds * options.clicksPerSecond;
+    int milestone = 0;
+
+    while(milestone < MILESTONE_COUNT) {
+        Item* target = nullptr;
+        for(Item* item : store.availableItems) {
+            if(!target
+                || (config.strategy == STRATEGY_GREEDY && item->cost < target->cost)
+                || (config.strategy == STRATEGY_SAVE && item->cost > target->cost)) {
+                target = item;
+            }
+        }
+        if(target && config.strategy == STRATEGY_RANDOM) {
+            target = store.availableItems[strategyRng() % store.availableItems.size()];
+        }
+
+        int multiplier = player.getMultiplier();
+        long long goal = target ? target->cost : MILESTONES[milestone];
+        long long needed = goal - player.getPoints();
+        long long clicksNeeded = needed > 0 ? (needed + multiplier - 1) / multiplier : 0;
+
+        // milestones passed on the way to the goal
+        while(milestone < MILESTONE_COUNT && MILESTONES[milestone] <= player.getPoints() + clicksNeeded * multiplier) {
+            long long missing = MILESTONES[milestone] - player.getPoints();
+            double at = clicks + (missing > 0 ? (missing + multiplier - 1) / multiplier : 0);
+            if(at > maxClicks) {
+                break;
+            }
+            times[milestone] = static_cast<float>(at / options.clicksPerSecond);
+            milestone++;
+        }
+
+        if(clicks + clicksNeeded > maxClicks) {
+            break;
+        }
+        clicks += clicksNeeded;
+        player.addPoints(static_cast<int>(clicksNeeded * multiplier));
+
+        if(target) {
+            target->purchase();
+            objectManager.applyCommands();
+        }
+    }
+}
+
+/**
+ * @brief Percentile of sorted values
+ *
+ * @param sorted
+ * @param percentile 0-1
+ * @return float
+ */
+static float percentileOf(const std::vector<float>& sorted, double percentile){
+    if(sorted.empty()) {
+        return 0.0f;
+    }
+    size_t index = static_cast<size_t>(percentile * (sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+
+/**
+ * @brief Parses a comma separated list
+ *
+ * @tparam T
+ * @param text
+ * @return std::vector<T>
+ */
+template <typename T>
+static std::vector<T> parseList(const std::string& text){
+    std::vector<T> values;
+    std::stringstream stream(text);
+    std::string value;
+    while(std::getline(stream, value, ',')) {
+        values.push_back(static_cast<T>(atof(value.c_str())));
+    }
+    return values;
+}
+
+int main(int argc, char* argv[]){
+    SweepOptions options;
+    for(int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if(arg == "--seeds" && hasValue) {
+            options.seeds = atoi(argv[++i]);
+        }
+        else if(arg == "--threads" && hasValue) {
+            options.threads = static_cast<size_t>(atoi(argv[++i]));
+        }
+        else if(arg == "--clicks-per-second" && hasValue) {
+            options.clicksPerSecond = atof(argv[++i]);
+        }
+        else if(arg == "--max-hours" && hasValue) {
+            options.maxSeconds = atof(argv[++i]) * 3600.0;
+        }
+        else if(arg == "--prob" && hasValue) {
+            options.probs = parseList<float>(argv[++i]);
+        }
+        else if(arg == "--cost" && hasValue) {
+            options.costs = parseList<int>(argv[++i]);
+        }
+        else if(arg == "--growth" && hasValue) {
+            options.growths = parseList<float>(argv[++i]);
+        }
+        else if(arg == "--out" && hasValue) {
+            options.outPath = argv[++i];
+        }
+        else {
+            fprintf(stderr, "Usage: %s [--seeds N] [--threads N] [--clicks-per-second R] [--max-hours H] "
+                "[--prob a,b,...] [--cost a,b,...] [--growth a,b,...] [--out file.csv]\n", argv[0]);
+            return 1;
+        }
+    }
+    if(options.seeds <= 0 || options.clicksPerSecond <= 0) {
+        fprintf(stderr, "ERROR: --seeds and --clicks-per-second must be positive\n");
+        return 1;
+    }
+
+    // the store logs every purchase and randomization
+    SDL_LogSetAllPriority(SDL_LOG_PRIORITY_WARN);
+
+    std::vector<SweepConfig> configs;
+    for(float prob : options.probs) {
+        for(int cost : options.costs) {
+            for(float growth : options.growths) {
+                for(int strategy = 0; strategy < STRATEGY_COUNT; strategy++) {
+                    configs.push_back({prob, cost, growth, static_cast<Strategy>(strategy)});
+                }
+            }
+        }
+    }
+
+    // every session writes its own slots, the tasks share nothing
+    size_t seeds = static_cast<size_t>(options.seeds);
+    std::vector<float> times(configs.size() * seeds * MILESTONE_COUNT);
+
+    auto start = std::chrono::steady_clock::now();
+    ThreadPool pool(options.threads);
+    for(size_t c = 0; c < configs.size(); c++) {
+        for(size_t first = 0; first < seeds; first += SESSIONS_PER_TASK) {
+            size_t last = std::min(first + SESSIONS_PER_TASK, seeds);
+            pool.submit([&, c, first, last]{
+                for(size_t s = first; s < last; s++) {
+                    runSession(configs[c], static_cast<unsigned int>(s), options, &times[(c * seeds + s) * MILESTONE_COUNT]);
+                    frameArena().reset();
+                }
+            });
+        }
+    }
+    pool.wait();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    FILE* out = stdout;
+    if(!options.outPath.empty()) {
+        out = fopen(options.outPath.c_str(), "w");
+        if(!out) {
+            fprintf(stderr, "ERROR: Could not create %s\n", options.outPath.c_str());
+            return 1;
+        }
+    }
+
+    fprintf(out, "prob,cost,growth,strategy,sessions,milestone,reached,mean_s,p10_s,p50_s,p90_s\n");
+    std::vector<float> reached;
+    reached.reserve(seeds);
+    for(size_t c = 0; c < configs.size(); c++) {
+        const SweepConfig& config = configs[c];
+        for(int m = 0; m < MILESTONE_COUNT; m++) {
+            reached.clear();
+            double sum = 0.0;
+            for(size_t s = 0; s < seeds; s++) {
+                float time = times[(c * seeds + s) * MILESTONE_COUNT + m];
+                if(time >= 0.0f) {
+                    reached.push_back(time);
+                    sum += time;
+                }
+            }
+            std::sort(reached.begin(), reached.end());
+            fprintf(out, "%.3f,%d,%.3f,%s,%zu,%s,%.4f,%.1f,%.1f,%.1f,%.1f\n",
+                config.prob, config.cost, config.growth, STRATEGY_NAMES[config.strategy], seeds, MILESTONE_NAMES[m],
+                static_cast<double>(reached.size()) / seeds,
+                reached.empty() ? 0.0 : sum / reached.size(),
+                percentileOf(reached, 0.1), percentileOf(reached, 0.5), percentileOf(reached, 0.9));
+        }
+    }
+    if(out != stdout) {
+        fclose(out);
+    }
+
+    double sessions = static_cast<double>(configs.size()) * seeds;
+    fprintf(stderr, "%.0f sessions on %zu threads in %.2f s (%.0f sessions/min, %llu tasks stolen)\n",
+        sessions, pool.getThreadCount(), seconds, sessions / seconds * 60.0, pool.getSteals());
+    return 0;
+}